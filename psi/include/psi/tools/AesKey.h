@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ByteBuffer.h"
+
+#include <array>
+
+namespace psi::tools {
+
+namespace crypt {
+class aes;
+class aes_gcm;
+} // namespace crypt
+
+/**
+ * @brief AesKey class represents AES-128/AES-256 key with already expanded round keys.
+ * Key schedule and GHASH multiplication table are generated once in constructor, so the same object might be
+ * reused by any number of encrypt/decrypt operations.
+ *
+ */
+class AesKey final
+{
+public:
+    using RoundKey = std::array<uint8_t, 16>;
+    static constexpr uint8_t MAX_ROUNDS = 14u;
+
+    /**
+     * @brief Construct a new invalid AesKey object.
+     *
+     */
+    AesKey() = default;
+
+    /**
+     * @brief Construct a new AesKey object and expand its round keys.
+     *
+     * @param key key buffer, 16 bytes for AES-128 or 32 bytes for AES-256
+     */
+    explicit AesKey(const ByteBuffer &key);
+
+    /**
+     * @brief Construct a new AesKey object and expand its round keys.
+     *
+     * @param key pointer to key data
+     * @param keyLen length of key, 16 bytes for AES-128 or 32 bytes for AES-256
+     */
+    AesKey(const uint8_t *key, size_t keyLen);
+
+    /**
+     * @brief Destroy the AesKey object and wipe round keys and GHASH tables.
+     *
+     */
+    ~AesKey();
+
+    AesKey(const AesKey &) = default;
+    AesKey &operator=(const AesKey &) = default;
+
+    /**
+     * @brief Check if key was successfully expanded.
+     *
+     * @return true if key has valid length
+     * @return false otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Return size of original key in bytes.
+     *
+     * @return size_t 16 for AES-128, 32 for AES-256, 0 for invalid key
+     */
+    size_t keySize() const;
+
+    /**
+     * @brief Return number of cipher rounds.
+     *
+     * @return uint8_t 10 for AES-128, 14 for AES-256, 0 for invalid key
+     */
+    uint8_t rounds() const;
+
+    /**
+     * @brief Return expanded round key.
+     *
+     * @param round index of round, [0, rounds()]
+     * @return const RoundKey& round key
+     */
+    const RoundKey &roundKey(size_t round) const;
+
+private:
+    friend class crypt::aes;
+    friend class crypt::aes_gcm;
+
+    // multiples of GHASH key H = E(K, 0^128) for 4-bit nibbles, each entry is {high, low} 64-bit half
+    using GHashTable = std::array<std::array<uint64_t, 2u>, 16u>;
+
+    alignas(16) std::array<RoundKey, MAX_ROUNDS + 1u> m_roundKeys = {};
+    // round keys of equivalent inverse cipher in order of application, used by AES-NI and T-table backends
+    alignas(16) std::array<RoundKey, MAX_ROUNDS + 1u> m_decRoundKeys = {};
+    alignas(16) GHashTable m_gHashTable = {};
+    // H^1..H^8 for carry-less multiplication backend of GHASH
+    alignas(16) std::array<RoundKey, 8u> m_gHashPowers = {};
+    uint8_t m_rounds = 0u;
+};
+
+} // namespace psi::tools
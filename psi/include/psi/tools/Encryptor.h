@@ -1,7 +1,11 @@
 #pragma once
 
+#include "AesKey.h"
 #include "ByteBuffer.h"
 
+#include <span>
+#include <string_view>
+
 namespace psi::tools {
 
 /**
@@ -27,6 +31,43 @@ public:
      */
     static ByteBuffer decryptBase64(const ByteBuffer &data);
 
+    /**
+     * @brief Return size of Base64 encoding of data with provided length.
+     * 
+     * @param dataLen (in) length of input data
+     * @return size_t length of encoded data
+     */
+    static size_t base64EncodedSize(size_t dataLen);
+
+    /**
+     * @brief Return size of data decoded from provided Base64 buffer.
+     * 
+     * @param data (in) encoded data
+     * @return size_t length of decoded data, 0 if length of encoded data is invalid
+     */
+    static size_t base64DecodedSize(std::span<const uint8_t> data);
+
+    /**
+     * @brief Encode provided data to Base64 into caller provided buffer.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least base64EncodedSize(data.size()) bytes
+     * @return true if data is encoded
+     * @return false if output buffer is too small
+     */
+    static bool encryptBase64(std::span<const uint8_t> data, std::span<uint8_t> out);
+
+    /**
+     * @brief Decode provided Base64 data into caller provided buffer.
+     * Output might point to the same memory as input, then data is decoded in place.
+     * 
+     * @param data (in) encoded data
+     * @param out (out) output buffer of at least base64DecodedSize(data) bytes
+     * @return true if data is decoded, empty data is decoded into 0 bytes
+     * @return false if data is not valid Base64 or output buffer is too small
+     */
+    static bool decryptBase64(std::span<const uint8_t> data, std::span<uint8_t> out);
+
     /**
      * @brief Encode provided buffer using key to AES-128 buffer.
      * 
@@ -36,6 +77,15 @@ public:
      */
     static ByteBuffer encryptAes128(const ByteBuffer &data, const ByteBuffer &key);
 
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-128 buffer.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-128 key
+     * @return ByteBuffer encoded buffer
+     */
+    static ByteBuffer encryptAes128(const ByteBuffer &data, const AesKey &key);
+
     /**
      * @brief Decode provided AES-128 buffer using key.
      * 
@@ -45,6 +95,56 @@ public:
      */
     static ByteBuffer decryptAes128(const ByteBuffer &data, const ByteBuffer &key);
 
+    /**
+     * @brief Decode provided AES-128 buffer using already expanded key.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-128 key
+     * @return ByteBuffer decoded buffer
+     */
+    static ByteBuffer decryptAes128(const ByteBuffer &data, const AesKey &key);
+
+    /**
+     * @brief Return size of AES encryption without mode of data with provided length.
+     * Incomplete last block is zero padded and followed by one byte with its length.
+     * 
+     * @param dataLen (in) length of input data
+     * @return size_t length of encrypted data
+     */
+    static size_t aesEncryptedSize(size_t dataLen);
+
+    /**
+     * @brief Return size of data decrypted from provided AES buffer encrypted without mode.
+     * 
+     * @param data (in) encrypted data
+     * @return size_t length of decrypted data, 0 if length of encrypted data is invalid
+     */
+    static size_t aesDecryptedSize(std::span<const uint8_t> data);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-128 into caller provided buffer.
+     * Output has the same format as of ByteBuffer overload and might start at the same memory as input.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least aesEncryptedSize(data.size()) bytes
+     * @param key (in) AES-128 key
+     * @return true if data is encrypted
+     * @return false if key or size of output buffer is invalid
+     */
+    static bool encryptAes128(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key);
+
+    /**
+     * @brief Decode provided AES-128 data using already expanded key into caller provided buffer.
+     * Output might start at the same memory as input.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least aesDecryptedSize(data) bytes
+     * @param key (in) AES-128 key
+     * @return true if data is decrypted
+     * @return false if key, length of encrypted data or size of output buffer is invalid
+     */
+    static bool decryptAes128(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key);
+
     /**
      * @brief Encode provided buffer using key to AES-128 buffer in GCM mode.
      * 
@@ -61,15 +161,31 @@ public:
                                        ByteBuffer &tag,
                                        const ByteBuffer &add = {});
 
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-128 buffer in GCM mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-128 key
+     * @param iv (in) iv buffer
+     * @param tag (out) tag to be filled in
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer encrypted input buffer
+     */
+    static ByteBuffer encryptAes128Gcm(const ByteBuffer &data,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       ByteBuffer &tag,
+                                       const ByteBuffer &add = {});
+
     /**
      * @brief Decode provided AES-128 buffer using key in GCM mode.
      * 
      * @param data (in) encrypted input buffer
      * @param key (in) key buffer
      * @param iv (in) iv buffer
-     * @param tag (in) tag buffer
+     * @param tag (in) tag buffer of 16 bytes
      * @param add (in, optional) additional data buffer
-     * @return ByteBuffer decrypted input buffer
+     * @return ByteBuffer decrypted input buffer, empty if tag is missing or does not match
      */
     static ByteBuffer decryptAes128Gcm(const ByteBuffer &data,
                                        const ByteBuffer &key,
@@ -77,6 +193,216 @@ public:
                                        const ByteBuffer &tag,
                                        const ByteBuffer &add = {});
 
+    /**
+     * @brief Decode provided AES-128 buffer using already expanded key in GCM mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) AES-128 key
+     * @param iv (in) iv buffer
+     * @param tag (in) tag buffer of 16 bytes
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer decrypted input buffer, empty if tag is missing or does not match
+     */
+    static ByteBuffer decryptAes128Gcm(const ByteBuffer &data,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       const ByteBuffer &tag,
+                                       const ByteBuffer &add = {});
+
+    /**
+     * @brief Return size of AES-CBC encryption with PKCS#7 padding of data with provided length.
+     * 
+     * @param dataLen (in) length of input data
+     * @return size_t length of encrypted data
+     */
+    static size_t aesCbcEncryptedSize(size_t dataLen);
+
+    /**
+     * @brief Encode provided buffer using key to AES-128 buffer in CBC mode with PKCS#7 padding.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes128Cbc(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-128 buffer using key in CBC mode and remove PKCS#7 padding.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer decrypted buffer, empty if padding is invalid
+     */
+    static ByteBuffer decryptAes128Cbc(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-128 buffer in CBC mode with PKCS#7 padding.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes128Cbc(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-128 buffer using already expanded key in CBC mode and remove PKCS#7 padding.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer decrypted buffer, empty if padding is invalid
+     */
+    static ByteBuffer decryptAes128Cbc(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided buffer using key to AES-128 buffer in CTR mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes128Ctr(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-128 buffer using key in CTR mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer decrypted buffer
+     */
+    static ByteBuffer decryptAes128Ctr(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-128 buffer in CTR mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes128Ctr(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-128 buffer using already expanded key in CTR mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer decrypted buffer
+     */
+    static ByteBuffer decryptAes128Ctr(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-128 in CBC mode with PKCS#7 padding into
+     * caller provided buffer. Output might start at the same memory as input.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least aesCbcEncryptedSize(data.size()) bytes
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes iv
+     * @return true if data is encrypted
+     * @return false if key, iv or size of output buffer is invalid
+     */
+    static bool encryptAes128Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv);
+
+    /**
+     * @brief Decode provided AES-128 data using already expanded key in CBC mode into caller provided buffer.
+     * Output might point to the same memory as input.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least data.size() bytes, padding is written too but not counted
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes iv
+     * @param outLen (out) length of decrypted data without padding
+     * @return true if data is decrypted
+     * @return false if key, iv, size of output buffer or padding is invalid, output buffer is wiped then
+     */
+    static bool decryptAes128Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 size_t &outLen);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-128 in CTR mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return true if data is encrypted
+     * @return false if key, iv or size of output buffer is invalid
+     */
+    static bool encryptAes128Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv);
+
+    /**
+     * @brief Decode provided AES-128 data using already expanded key in CTR mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-128 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return true if data is decrypted
+     * @return false if key, iv or size of output buffer is invalid
+     */
+    static bool decryptAes128Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-128 in GCM mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-128 key
+     * @param iv (in) iv
+     * @param tag (out) tag of at least 16 bytes
+     * @param add (in, optional) additional data
+     * @return true if data is encrypted
+     * @return false if key, iv, tag or size of output buffer is invalid
+     */
+    static bool encryptAes128Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<uint8_t> tag,
+                                 std::span<const uint8_t> add = {});
+
+    /**
+     * @brief Decode provided AES-128 data using already expanded key in GCM mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-128 key
+     * @param iv (in) iv
+     * @param tag (in) tag of 16 bytes
+     * @param add (in, optional) additional data
+     * @return true if data is decrypted and tag is verified
+     * @return false otherwise, output buffer is wiped if tag mismatches
+     */
+    static bool decryptAes128Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<const uint8_t> tag,
+                                 std::span<const uint8_t> add = {});
+
     /**
      * @brief Encode provided buffer using key to AES-256 buffer.
      * 
@@ -86,6 +412,15 @@ public:
      */
     static ByteBuffer encryptAes256(const ByteBuffer &data, const ByteBuffer &key);
 
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-256 buffer.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-256 key
+     * @return ByteBuffer encoded buffer
+     */
+    static ByteBuffer encryptAes256(const ByteBuffer &data, const AesKey &key);
+
     /**
      * @brief Decode provided AES-256 buffer using key.
      * 
@@ -95,6 +430,371 @@ public:
      */
     static ByteBuffer decryptAes256(const ByteBuffer &data, const ByteBuffer &key);
 
+    /**
+     * @brief Decode provided AES-256 buffer using already expanded key.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-256 key
+     * @return ByteBuffer decoded buffer
+     */
+    static ByteBuffer decryptAes256(const ByteBuffer &data, const AesKey &key);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-256 into caller provided buffer.
+     * Output has the same format as of ByteBuffer overload and might start at the same memory as input.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least aesEncryptedSize(data.size()) bytes
+     * @param key (in) AES-256 key
+     * @return true if data is encrypted
+     * @return false if key or size of output buffer is invalid
+     */
+    static bool encryptAes256(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key);
+
+    /**
+     * @brief Decode provided AES-256 data using already expanded key into caller provided buffer.
+     * Output might start at the same memory as input.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least aesDecryptedSize(data) bytes
+     * @param key (in) AES-256 key
+     * @return true if data is decrypted
+     * @return false if key, length of encrypted data or size of output buffer is invalid
+     */
+    static bool decryptAes256(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key);
+
+    /**
+     * @brief Encode provided buffer using key to AES-256 buffer in GCM mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) key buffer
+     * @param iv (in) iv buffer
+     * @param tag (out) tag to be filled in
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer encrypted input buffer
+     */
+    static ByteBuffer encryptAes256Gcm(const ByteBuffer &data,
+                                       const ByteBuffer &key,
+                                       const ByteBuffer &iv,
+                                       ByteBuffer &tag,
+                                       const ByteBuffer &add = {});
+
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-256 buffer in GCM mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-256 key
+     * @param iv (in) iv buffer
+     * @param tag (out) tag to be filled in
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer encrypted input buffer
+     */
+    static ByteBuffer encryptAes256Gcm(const ByteBuffer &data,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       ByteBuffer &tag,
+                                       const ByteBuffer &add = {});
+
+    /**
+     * @brief Decode provided AES-256 buffer using key in GCM mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) key buffer
+     * @param iv (in) iv buffer
+     * @param tag (in) tag buffer of 16 bytes
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer decrypted input buffer, empty if tag is missing or does not match
+     */
+    static ByteBuffer decryptAes256Gcm(const ByteBuffer &data,
+                                       const ByteBuffer &key,
+                                       const ByteBuffer &iv,
+                                       const ByteBuffer &tag,
+                                       const ByteBuffer &add = {});
+
+    /**
+     * @brief Decode provided AES-256 buffer using already expanded key in GCM mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) AES-256 key
+     * @param iv (in) iv buffer
+     * @param tag (in) tag buffer of 16 bytes
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer decrypted input buffer, empty if tag is missing or does not match
+     */
+    static ByteBuffer decryptAes256Gcm(const ByteBuffer &data,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       const ByteBuffer &tag,
+                                       const ByteBuffer &add = {});
+
+    /**
+     * @brief Encode provided buffer using key to AES-256 buffer in CBC mode with PKCS#7 padding.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes256Cbc(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-256 buffer using key in CBC mode and remove PKCS#7 padding.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer decrypted buffer, empty if padding is invalid
+     */
+    static ByteBuffer decryptAes256Cbc(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-256 buffer in CBC mode with PKCS#7 padding.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes256Cbc(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-256 buffer using already expanded key in CBC mode and remove PKCS#7 padding.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes iv buffer
+     * @return ByteBuffer decrypted buffer, empty if padding is invalid
+     */
+    static ByteBuffer decryptAes256Cbc(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided buffer using key to AES-256 buffer in CTR mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes256Ctr(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-256 buffer using key in CTR mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) key buffer
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer decrypted buffer
+     */
+    static ByteBuffer decryptAes256Ctr(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided buffer using already expanded key to AES-256 buffer in CTR mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer encrypted buffer
+     */
+    static ByteBuffer encryptAes256Ctr(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Decode provided AES-256 buffer using already expanded key in CTR mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return ByteBuffer decrypted buffer
+     */
+    static ByteBuffer decryptAes256Ctr(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-256 in CBC mode with PKCS#7 padding into
+     * caller provided buffer. Output might start at the same memory as input.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least aesCbcEncryptedSize(data.size()) bytes
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes iv
+     * @return true if data is encrypted
+     * @return false if key, iv or size of output buffer is invalid
+     */
+    static bool encryptAes256Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv);
+
+    /**
+     * @brief Decode provided AES-256 data using already expanded key in CBC mode into caller provided buffer.
+     * Output might point to the same memory as input.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least data.size() bytes, padding is written too but not counted
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes iv
+     * @param outLen (out) length of decrypted data without padding
+     * @return true if data is decrypted
+     * @return false if key, iv, size of output buffer or padding is invalid, output buffer is wiped then
+     */
+    static bool decryptAes256Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 size_t &outLen);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-256 in CTR mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return true if data is encrypted
+     * @return false if key, iv or size of output buffer is invalid
+     */
+    static bool encryptAes256Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv);
+
+    /**
+     * @brief Decode provided AES-256 data using already expanded key in CTR mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-256 key
+     * @param iv (in) 16 bytes initial counter block, incremented as 128-bit big-endian number
+     * @return true if data is decrypted
+     * @return false if key, iv or size of output buffer is invalid
+     */
+    static bool decryptAes256Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv);
+
+    /**
+     * @brief Encode provided data using already expanded key to AES-256 in GCM mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-256 key
+     * @param iv (in) iv
+     * @param tag (out) tag of at least 16 bytes
+     * @param add (in, optional) additional data
+     * @return true if data is encrypted
+     * @return false if key, iv, tag or size of output buffer is invalid
+     */
+    static bool encryptAes256Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<uint8_t> tag,
+                                 std::span<const uint8_t> add = {});
+
+    /**
+     * @brief Decode provided AES-256 data using already expanded key in GCM mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) AES-256 key
+     * @param iv (in) iv
+     * @param tag (in) tag of 16 bytes
+     * @param add (in, optional) additional data
+     * @return true if data is decrypted and tag is verified
+     * @return false otherwise, output buffer is wiped if tag mismatches
+     */
+    static bool decryptAes256Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<const uint8_t> tag,
+                                 std::span<const uint8_t> add = {});
+
+    /**
+     * @brief Encode provided buffer using key in ChaCha20-Poly1305 AEAD mode.
+     * 
+     * @param data (in) input buffer
+     * @param key (in) 32 bytes key buffer
+     * @param iv (in) 12 bytes nonce buffer
+     * @param tag (out) 16 bytes tag to be filled in
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer encrypted input buffer
+     */
+    static ByteBuffer encryptChaCha20Poly1305(const ByteBuffer &data,
+                                              const ByteBuffer &key,
+                                              const ByteBuffer &iv,
+                                              ByteBuffer &tag,
+                                              const ByteBuffer &add = {});
+
+    /**
+     * @brief Decode provided buffer using key in ChaCha20-Poly1305 AEAD mode.
+     * 
+     * @param data (in) encrypted input buffer
+     * @param key (in) 32 bytes key buffer
+     * @param iv (in) 12 bytes nonce buffer
+     * @param tag (in) 16 bytes tag buffer
+     * @param add (in, optional) additional data buffer
+     * @return ByteBuffer decrypted input buffer, empty if tag mismatches
+     */
+    static ByteBuffer decryptChaCha20Poly1305(const ByteBuffer &data,
+                                              const ByteBuffer &key,
+                                              const ByteBuffer &iv,
+                                              const ByteBuffer &tag,
+                                              const ByteBuffer &add = {});
+
+    /**
+     * @brief Encode provided data using key in ChaCha20-Poly1305 AEAD mode into caller provided buffer.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) 32 bytes key
+     * @param iv (in) 12 bytes nonce
+     * @param tag (out) 16 bytes tag
+     * @param add (in, optional) additional data
+     * @return true if data is encrypted
+     * @return false if key, iv, tag, size of output buffer or length of data is invalid
+     */
+    static bool encryptChaCha20Poly1305(std::span<const uint8_t> data,
+                                        std::span<uint8_t> out,
+                                        std::span<const uint8_t> key,
+                                        std::span<const uint8_t> iv,
+                                        std::span<uint8_t> tag,
+                                        std::span<const uint8_t> add = {});
+
+    /**
+     * @brief Decode provided data using key in ChaCha20-Poly1305 AEAD mode into caller provided buffer.
+     * Tag is verified before decryption, output is not modified if it mismatches.
+     * Output has the same size as input and might point to the same memory.
+     * 
+     * @param data (in) encrypted data
+     * @param out (out) output buffer of at least data.size() bytes
+     * @param key (in) 32 bytes key
+     * @param iv (in) 12 bytes nonce
+     * @param tag (in) 16 bytes tag
+     * @param add (in, optional) additional data
+     * @return true if tag is verified and data is decrypted
+     * @return false otherwise
+     */
+    static bool decryptChaCha20Poly1305(std::span<const uint8_t> data,
+                                        std::span<uint8_t> out,
+                                        std::span<const uint8_t> key,
+                                        std::span<const uint8_t> iv,
+                                        std::span<const uint8_t> tag,
+                                        std::span<const uint8_t> add = {});
+
+    /**
+     * @brief Check if AES is accelerated by CPU instructions on this host.
+     * Without them ChaCha20-Poly1305 is usually faster than AES-GCM.
+     * 
+     * @return true if AES-NI is available
+     * @return false otherwise
+     */
+    static bool hasAesAcceleration();
+
     /**
      * @brief Generate SHA-256 hash for provided byte bufer.
      * 
@@ -103,6 +803,55 @@ public:
      */
     static ByteBuffer sha256(const ByteBuffer &data);
 
+    /**
+     * @brief Generate SHA-256 hash for provided data into caller provided buffer.
+     * Data is hashed in place, no copy of input is made.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if hash was written
+     * @return false if output is too small
+     */
+    static bool sha256(std::span<const uint8_t> data, std::span<uint8_t> out);
+
+    /**
+     * @brief Generate SHA-512 hash for provided byte bufer.
+     * 
+     * @param data (in) input buffer
+     * @return ByteBuffer 64 bytes hash buffer
+     */
+    static ByteBuffer sha512(const ByteBuffer &data);
+
+    /**
+     * @brief Generate SHA-512 hash for provided data into caller provided buffer.
+     * Data is hashed in place, no copy of input is made.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least 64 bytes
+     * @return true if hash was written
+     * @return false if output is too small
+     */
+    static bool sha512(std::span<const uint8_t> data, std::span<uint8_t> out);
+
+    /**
+     * @brief Generate SHA-384 hash for provided byte bufer.
+     * 
+     * @param data (in) input buffer
+     * @return ByteBuffer 48 bytes hash buffer
+     */
+    static ByteBuffer sha384(const ByteBuffer &data);
+
+    /**
+     * @brief Generate SHA-384 hash for provided data into caller provided buffer.
+     * Data is hashed in place, no copy of input is made.
+     * 
+     * @param data (in) input data
+     * @param out (out) output buffer of at least 48 bytes
+     * @return true if hash was written
+     * @return false if output is too small
+     */
+    static bool sha384(std::span<const uint8_t> data, std::span<uint8_t> out);
+
     /**
      * @brief Generate HMAC-256 code for provided data using provided key.
      * 
@@ -112,6 +861,35 @@ public:
      */
     static ByteBuffer hmac256(const ByteBuffer &key, const ByteBuffer &data);
 
+    /**
+     * @brief Generate HMAC-SHA256 code for provided data using provided key into caller provided buffer.
+     * 
+     * @param key (in) key
+     * @param data (in) data
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if code was written
+     * @return false if output is too small
+     */
+    static bool hmac256(std::span<const uint8_t> key, std::span<const uint8_t> data, std::span<uint8_t> out);
+
+    /**
+     * @brief Generate HMAC-SHA512 code for provided data using provided key.
+     * 
+     * @param key (in) key buffer
+     * @param data (in) data buffer
+     * @return ByteBuffer 64 bytes code buffer
+     */
+    static ByteBuffer hmac512(const ByteBuffer &key, const ByteBuffer &data);
+
+    /**
+     * @brief Generate HMAC-SHA384 code for provided data using provided key.
+     * 
+     * @param key (in) key buffer
+     * @param data (in) data buffer
+     * @return ByteBuffer 48 bytes code buffer
+     */
+    static ByteBuffer hmac384(const ByteBuffer &key, const ByteBuffer &data);
+
     /**
      * @brief Generate derived key using HKDF algorithm.
      * 
@@ -123,6 +901,21 @@ public:
      */
     static ByteBuffer hkdf256(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len);
 
+    /**
+     * @brief Generate derived key using HKDF algorithm into caller provided buffer.
+     * 
+     * @param key (in) input key material
+     * @param seed (in) salt, might be empty
+     * @param info (in) info, might be empty
+     * @param out (out) derived key, up to 255 * 32 bytes
+     * @return true if output was filled
+     * @return false if output is too long
+     */
+    static bool hkdf256(std::span<const uint8_t> key,
+                        std::span<const uint8_t> seed,
+                        std::span<const uint8_t> info,
+                        std::span<uint8_t> out);
+
     /**
      * @brief Generate key material using HKDF algorithm.
      * 
@@ -133,6 +926,17 @@ public:
      */
     static ByteBuffer hkdf256Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len);
 
+    /**
+     * @brief Generate key material using HKDF algorithm into caller provided buffer.
+     * 
+     * @param prk (in) pseudo-random-key
+     * @param info (in) info, might be empty
+     * @param out (out) key material, up to 255 * 32 bytes
+     * @return true if output was filled
+     * @return false if output is too long
+     */
+    static bool hkdf256Expand(std::span<const uint8_t> prk, std::span<const uint8_t> info, std::span<uint8_t> out);
+
     /**
      * @brief Generate key material using HKDF algorithm, label and hash.
      * 
@@ -145,19 +949,108 @@ public:
     static ByteBuffer hkdf256ExpandLabel(const ByteBuffer &prk, const std::string &label, const ByteBuffer &hash, size_t len);
 
     /**
-     * @brief Generate random 32 bytes length buffer.
+     * @brief Generate key material using HKDF algorithm, label and hash into caller provided buffer.
      * 
-     * @return ByteBuffer session key buffer
+     * @param prk (in) pseudo-random-key
+     * @param label (in) label of key, up to 255 bytes
+     * @param hash (in) hash, up to 255 bytes
+     * @param out (out) key material, up to 255 * 32 bytes
+     * @return true if output was filled
+     * @return false if any of lengths is out of range
+     */
+    static bool hkdf256ExpandLabel(std::span<const uint8_t> prk,
+                                   std::string_view label,
+                                   std::span<const uint8_t> hash,
+                                   std::span<uint8_t> out);
+
+    /**
+     * @brief Generate derived key using HKDF-SHA512 algorithm.
+     * 
+     * @param key (in) key buffer
+     * @param seed (in) seed buffer
+     * @param info (in) info buffer
+     * @param len (in) expected size of key, at most 255 * 64 bytes
+     * @return ByteBuffer derived key buffer, empty if len is too big
+     */
+    static ByteBuffer hkdf512(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len);
+
+    /**
+     * @brief Generate key material using HKDF-SHA512 algorithm.
+     * 
+     * @param prk (in) pseudo-random-key buffer
+     * @param info (in) info buffer
+     * @param len (in) expected size of key material, at most 255 * 64 bytes
+     * @return ByteBuffer key material buffer, empty if len is too big
+     */
+    static ByteBuffer hkdf512Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len);
+
+    /**
+     * @brief Generate derived key using HKDF-SHA384 algorithm.
+     * 
+     * @param key (in) key buffer
+     * @param seed (in) seed buffer
+     * @param info (in) info buffer
+     * @param len (in) expected size of key, at most 255 * 48 bytes
+     * @return ByteBuffer derived key buffer, empty if len is too big
+     */
+    static ByteBuffer hkdf384(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len);
+
+    /**
+     * @brief Generate key material using HKDF-SHA384 algorithm.
+     * 
+     * @param prk (in) pseudo-random-key buffer
+     * @param info (in) info buffer
+     * @param len (in) expected size of key material, at most 255 * 48 bytes
+     * @return ByteBuffer key material buffer, empty if len is too big
+     */
+    static ByteBuffer hkdf384Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len);
+
+    /**
+     * @brief Generate key material using HKDF-SHA384 algorithm, label and hash.
+     * Is used by TLS 1.3 cipher suite TLS_AES_256_GCM_SHA384.
+     * 
+     * @param prk (in) pseudo-random-key buffer
+     * @param label (in) label of key
+     * @param hash (in) hash buffer
+     * @param len (in) expected size of key material
+     * @return ByteBuffer key material buffer
+     */
+    static ByteBuffer hkdf384ExpandLabel(const ByteBuffer &prk, const std::string &label, const ByteBuffer &hash, size_t len);
+
+    /**
+     * @brief Generate random 32 bytes length buffer using cryptographically secure generator.
+     * 
+     * @return ByteBuffer session key buffer, empty if system random source is not available
      */
     static ByteBuffer generateSessionKey();
 
+    /**
+     * @brief Generate random iv/nonce using cryptographically secure generator.
+     * 
+     * @param len (in, optional) length of iv, 12 bytes by default as recommended for GCM
+     * @return ByteBuffer iv buffer, empty if system random source is not available
+     */
+    static ByteBuffer generateIv(size_t len = 12u);
+
+    /**
+     * @brief Fill provided buffer with cryptographically secure random bytes.
+     * Generator keeps per-thread state, so calls from different threads do not block each other.
+     * 
+     * @param out (out) buffer to be filled
+     * @return true if buffer is filled
+     * @return false if system random source is not available, buffer is zeroed then
+     */
+    static bool generateRandom(std::span<uint8_t> out);
+
     /**
      * @brief Generate random public/private key pair.
      * 
      * @param publicKey (out) random public key
      * @param privateKey (out) random private key
+     * @return true if key pair is generated
+     * @return false if system random source is not available, both keys are zeroed then
      */
-    static void x25519_generate_keypair(ByteBuffer &publicKey, ByteBuffer &privateKey);
+    static bool x25519_generate_keypair(ByteBuffer &publicKey, ByteBuffer &privateKey);
 
     /**
      * @brief Get public key from private key.
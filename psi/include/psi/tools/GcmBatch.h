@@ -0,0 +1,55 @@
+#pragma once
+
+#include "AesKey.h"
+
+#include <span>
+
+namespace psi::tools {
+
+/**
+ * @brief Single message of AES-GCM batch.
+ * All buffers are provided by caller, nothing is allocated during processing.
+ *
+ */
+struct GcmRecord {
+    std::span<const uint8_t> iv;
+    std::span<const uint8_t> aad;
+    std::span<const uint8_t> in;
+    // at least in.size() bytes, might be the same memory as in
+    std::span<uint8_t> out;
+    // seal: 16 bytes to be filled in, open: expected tag, 16 bytes
+    std::span<uint8_t> tag;
+    // result of processing
+    bool ok = false;
+};
+
+/**
+ * @brief GcmBatch class encrypts/decrypts many small messages under the same key in AES-GCM mode.
+ * Counter blocks of several messages are encrypted together, so AES pipeline stays full across message boundaries
+ * and per-call overhead is paid once per batch.
+ *
+ */
+class GcmBatch
+{
+public:
+    /**
+     * @brief Encrypt all records and produce their tags.
+     *
+     * @param key (in) AES-128 or AES-256 key
+     * @param records (in, out) records to be encrypted
+     * @return size_t number of successfully encrypted records
+     */
+    static size_t seal(const AesKey &key, std::span<GcmRecord> records);
+
+    /**
+     * @brief Decrypt all records and verify their tags.
+     * Output of record with invalid tag is wiped.
+     *
+     * @param key (in) AES-128 or AES-256 key
+     * @param records (in, out) records to be decrypted
+     * @return size_t number of successfully decrypted and verified records
+     */
+    static size_t open(const AesKey &key, std::span<GcmRecord> records);
+};
+
+} // namespace psi::tools
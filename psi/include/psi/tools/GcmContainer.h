@@ -0,0 +1,199 @@
+#pragma once
+
+#include "AesKey.h"
+#include "ByteBuffer.h"
+
+#include <array>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace psi::tools {
+
+/**
+ * @brief Layout of seekable AES-GCM container file.
+ * File consists of header, sealed chunks and index of chunk offsets:
+ *  header: magic[8], chunk size (u32), reserved (u32), nonce[8], plain size (u64), chunk count (u64),
+ *          index offset (u64), all numbers are little-endian
+ *  chunk i: AES-GCM(data[i * chunkSize, (i + 1) * chunkSize)) || tag[16],
+ *           iv = nonce || big-endian i (u32), aad = magic || chunk size || nonce || last chunk flag (u8)
+ *  index: offset of every chunk (u64)
+ * Last chunk flag makes truncation of file at chunk boundary detectable, container always has at least one chunk.
+ *
+ */
+struct GcmContainerFormat {
+    using Nonce = std::array<uint8_t, 8u>;
+
+    static constexpr std::array<uint8_t, 8u> MAGIC = {'P', 'S', 'I', 'G', 'C', 'M', 'C', '1'};
+    static constexpr size_t HEADER_SIZE = 48u;
+    static constexpr size_t TAG_SIZE = 16u;
+    static constexpr uint32_t DEFAULT_CHUNK_SIZE = 64u * 1024u;
+    static constexpr uint64_t MAX_CHUNKS = 0xffffffffull;
+};
+
+/**
+ * @brief GcmContainerWriter class writes stream of data into seekable AES-GCM container file.
+ * Data might be provided in pieces of any length, at most one chunk is buffered in memory.
+ *
+ */
+class GcmContainerWriter final
+{
+public:
+    /**
+     * @brief Create container file, existing file is overwritten.
+     *
+     * @param path (in) path to file
+     * @param key (in) AES-128 or AES-256 key
+     * @param nonce (in) unique per file nonce, must never be reused with the same key
+     * @param chunkSize (in) size of plain data in every chunk
+     */
+    GcmContainerWriter(const std::string &path,
+                       const AesKey &key,
+                       const GcmContainerFormat::Nonce &nonce,
+                       uint32_t chunkSize = GcmContainerFormat::DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Finish container if finish() was not called yet.
+     *
+     */
+    ~GcmContainerWriter();
+
+    GcmContainerWriter(const GcmContainerWriter &) = delete;
+    GcmContainerWriter &operator=(const GcmContainerWriter &) = delete;
+
+    /**
+     * @brief Check if writer accepts data.
+     *
+     * @return true if file is open and not finished
+     * @return false otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Append data to container.
+     *
+     * @param data (in) next piece of data
+     * @return true if data was accepted
+     * @return false if writer is invalid or file cannot be written
+     */
+    bool write(std::span<const uint8_t> data);
+
+    /**
+     * @brief Append data to container.
+     *
+     * @param data (in) next piece of data
+     * @return true if data was accepted
+     * @return false if writer is invalid or file cannot be written
+     */
+    bool write(const ByteBuffer &data);
+
+    /**
+     * @brief Seal last chunk, write index and header. Writer becomes invalid after this call.
+     *
+     * @return true if container was completed
+     * @return false otherwise
+     */
+    bool finish();
+
+private:
+    bool sealChunk(bool isLast);
+
+    std::ofstream m_file;
+    AesKey m_key;
+    GcmContainerFormat::Nonce m_nonce = {};
+    uint32_t m_chunkSize = 0u;
+    std::vector<uint8_t> m_chunk;
+    std::vector<uint8_t> m_sealed;
+    std::vector<uint64_t> m_offsets;
+    uint64_t m_plainSize = 0u;
+    uint64_t m_fileOffset = 0u;
+    bool m_isValid = false;
+};
+
+class MappedFile;
+
+/**
+ * @brief GcmContainerReader class gives random access to data of AES-GCM container file.
+ * File is memory mapped, only chunks covering requested range are authenticated and decrypted,
+ * large ranges are decrypted by all cores.
+ *
+ */
+class GcmContainerReader final
+{
+public:
+    /**
+     * @brief Open container file and validate its header and index.
+     *
+     * @param path (in) path to file
+     * @param key (in) AES-128 or AES-256 key used by writer
+     */
+    GcmContainerReader(const std::string &path, const AesKey &key);
+    ~GcmContainerReader();
+
+    GcmContainerReader(const GcmContainerReader &) = delete;
+    GcmContainerReader &operator=(const GcmContainerReader &) = delete;
+
+    /**
+     * @brief Check if container was successfully opened.
+     *
+     * @return true if header and index are valid
+     * @return false otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Return size of plain data.
+     *
+     * @return uint64_t size in bytes
+     */
+    uint64_t size() const;
+
+    /**
+     * @brief Return size of plain data in every chunk except the last one.
+     *
+     * @return uint32_t size in bytes
+     */
+    uint32_t chunkSize() const;
+
+    /**
+     * @brief Return number of chunks.
+     *
+     * @return uint64_t number of chunks
+     */
+    uint64_t chunkCount() const;
+
+    /**
+     * @brief Decrypt range of plain data.
+     *
+     * @param offset (in) offset of range in plain data
+     * @param out (out) buffer to be filled in, its size defines length of range
+     * @return true if range is valid and all covered chunks were authenticated
+     * @return false otherwise, out is wiped
+     */
+    bool read(uint64_t offset, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Decrypt range of plain data.
+     *
+     * @param offset (in) offset of range in plain data
+     * @param len (in) length of range
+     * @return ByteBuffer decrypted range, empty on failure
+     */
+    ByteBuffer read(uint64_t offset, size_t len) const;
+
+private:
+    bool openChunk(uint64_t index, uint8_t *out) const;
+
+    std::unique_ptr<MappedFile> m_file;
+    AesKey m_key;
+    GcmContainerFormat::Nonce m_nonce = {};
+    uint32_t m_chunkSize = 0u;
+    uint64_t m_plainSize = 0u;
+    uint64_t m_chunkCount = 0u;
+    const uint8_t *m_index = nullptr;
+    bool m_isValid = false;
+};
+
+} // namespace psi::tools
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "AesKey.h"
+#include "ByteBuffer.h"
+
+#include <array>
+#include <span>
+
+namespace psi::tools {
+
+/**
+ * @brief Common state of incremental AES-GCM encryption/decryption.
+ * Additional authenticated data must be provided before any payload data. Input might be split into chunks of any
+ * length, partial blocks are buffered internally, so memory usage does not depend on length of message.
+ *
+ */
+class GcmStream
+{
+public:
+    using Tag = std::array<uint8_t, 16u>;
+
+    /**
+     * @brief Maximum number of payload bytes which can be processed with one IV, (2^32 - 2) blocks.
+     *
+     */
+    static constexpr uint64_t MAX_DATA_LENGTH = (0xffffffffull - 1u) * 16u;
+
+    /**
+     * @brief Destroy the GcmStream object and wipe cached key stream.
+     *
+     */
+    ~GcmStream();
+
+    GcmStream(const GcmStream &) = default;
+    GcmStream &operator=(const GcmStream &) = default;
+
+    /**
+     * @brief Check if stream was successfully initialized and not finalized yet.
+     *
+     * @return true if stream accepts data
+     * @return false otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Authenticate next chunk of additional data.
+     *
+     * @param aad (in) chunk of additional data
+     * @return true if data was accepted
+     * @return false if stream is invalid or payload data was already provided
+     */
+    bool updateAad(std::span<const uint8_t> aad);
+
+    /**
+     * @brief Return number of authenticated additional data bytes.
+     *
+     * @return uint64_t length in bytes
+     */
+    uint64_t aadLength() const;
+
+    /**
+     * @brief Return number of processed payload bytes.
+     *
+     * @return uint64_t length in bytes
+     */
+    uint64_t dataLength() const;
+
+protected:
+    GcmStream(const AesKey &key, std::span<const uint8_t> iv);
+
+    bool canProcess(size_t inLen, size_t outLen);
+    void applyKeyStream(const uint8_t *in, uint8_t *out, size_t len);
+    void hash(const uint8_t *data, size_t len);
+    void computeTag(Tag &tag);
+
+private:
+    void flushHash();
+
+    AesKey m_key;
+    std::array<uint8_t, 16u> m_counter = {};
+    std::array<uint8_t, 16u> m_y0Encrypted = {};
+    std::array<uint8_t, 16u> m_hash = {};
+    std::array<uint8_t, 16u> m_hashBuffer = {};
+    std::array<uint8_t, 16u> m_keyStream = {};
+    size_t m_hashBufferLen = 0u;
+    size_t m_keyStreamPos = 16u;
+    uint64_t m_aadLen = 0u;
+    uint64_t m_dataLen = 0u;
+    bool m_isValid = false;
+};
+
+/**
+ * @brief GcmEncryptor class encrypts message in AES-GCM mode chunk by chunk.
+ *
+ */
+class GcmEncryptor final : public GcmStream
+{
+public:
+    /**
+     * @brief Construct a new GcmEncryptor object.
+     *
+     * @param key (in) AES-128 or AES-256 key
+     * @param iv (in) iv buffer, 12 bytes are recommended
+     */
+    GcmEncryptor(const AesKey &key, std::span<const uint8_t> iv);
+
+    /**
+     * @brief Encrypt next chunk of data.
+     * Output is produced immediately, in and out might point to the same memory.
+     *
+     * @param in (in) chunk of plain data
+     * @param out (out) buffer for encrypted data, at least in.size() bytes
+     * @return true if chunk was encrypted
+     * @return false if stream is invalid, output is too small or message is too long
+     */
+    bool update(std::span<const uint8_t> in, std::span<uint8_t> out);
+
+    /**
+     * @brief Encrypt next chunk of data.
+     *
+     * @param data (in) chunk of plain data
+     * @return ByteBuffer encrypted chunk, empty on failure
+     */
+    ByteBuffer update(const ByteBuffer &data);
+
+    /**
+     * @brief Finish encryption and produce authentication tag.
+     * Stream becomes invalid after this call.
+     *
+     * @param tag (out) tag to be filled in
+     * @return true if tag was produced
+     * @return false if stream is invalid
+     */
+    bool final(Tag &tag);
+};
+
+/**
+ * @brief GcmDecryptor class decrypts message in AES-GCM mode chunk by chunk.
+ * Decrypted chunks must not be trusted until final() succeeds.
+ *
+ */
+class GcmDecryptor final : public GcmStream
+{
+public:
+    /**
+     * @brief Construct a new GcmDecryptor object.
+     *
+     * @param key (in) AES-128 or AES-256 key
+     * @param iv (in) iv buffer
+     */
+    GcmDecryptor(const AesKey &key, std::span<const uint8_t> iv);
+
+    /**
+     * @brief Decrypt next chunk of data.
+     * Output is produced immediately, in and out might point to the same memory.
+     *
+     * @param in (in) chunk of encrypted data
+     * @param out (out) buffer for decrypted data, at least in.size() bytes
+     * @return true if chunk was decrypted
+     * @return false if stream is invalid, output is too small or message is too long
+     */
+    bool update(std::span<const uint8_t> in, std::span<uint8_t> out);
+
+    /**
+     * @brief Decrypt next chunk of data.
+     *
+     * @param data (in) chunk of encrypted data
+     * @return ByteBuffer decrypted chunk, empty on failure
+     */
+    ByteBuffer update(const ByteBuffer &data);
+
+    /**
+     * @brief Finish decryption and verify authentication tag.
+     * Stream becomes invalid after this call.
+     *
+     * @param tag (in) expected tag, 16 bytes
+     * @return true if tag matches
+     * @return false otherwise
+     */
+    bool final(std::span<const uint8_t> tag);
+};
+
+} // namespace psi::tools
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "HmacKey.h"
+
+#include <span>
+#include <string_view>
+
+namespace psi::tools {
+
+/**
+ * @brief Hkdf class derives key material from pseudorandom key using HKDF (RFC 5869).
+ * HMAC context of pseudorandom key is prepared once in constructor, output is written directly into caller provided
+ * memory, so expand operations do not allocate. Available for Sha256, Sha384 and Sha512 as HkdfSha256, HkdfSha384
+ * and HkdfSha512.
+ *
+ * @tparam Hash incremental hasher
+ */
+template <typename Hash>
+class Hkdf final
+{
+public:
+    static constexpr size_t HASH_SIZE = Hash::DIGEST_SIZE;
+    static constexpr size_t MAX_OUTPUT_SIZE = 255u * HASH_SIZE;
+
+    /**
+     * @brief Construct a new Hkdf object with empty pseudorandom key.
+     *
+     */
+    Hkdf() = default;
+
+    /**
+     * @brief Construct a new Hkdf object and prepare HMAC context of pseudorandom key.
+     *
+     * @param prk (in) pseudorandom key, usually output of extract()
+     */
+    explicit Hkdf(std::span<const uint8_t> prk);
+
+    /**
+     * @brief Extract pseudorandom key from input key material.
+     *
+     * @param salt (in) optional salt, might be empty
+     * @param ikm (in) input key material
+     * @param prk (out) output buffer of at least HASH_SIZE bytes
+     * @return true if key was written
+     * @return false if output is too small
+     */
+    static bool extract(std::span<const uint8_t> salt, std::span<const uint8_t> ikm, std::span<uint8_t> prk);
+
+    /**
+     * @brief Expand pseudorandom key into output key material.
+     *
+     * @param info (in) context and application specific information, might be empty
+     * @param out (out) output key material, up to MAX_OUTPUT_SIZE bytes
+     * @return true if output was filled
+     * @return false if output is too long
+     */
+    bool expand(std::span<const uint8_t> info, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Expand pseudorandom key with HkdfLabel structure of TLS 1.3 (RFC 8446 7.1) used as info.
+     * Label is used as is, so it must contain "tls13 " prefix.
+     *
+     * @param label (in) full label, up to 255 bytes
+     * @param context (in) context value, usually transcript hash, up to 255 bytes
+     * @param out (out) output key material, up to MAX_OUTPUT_SIZE bytes
+     * @return true if output was filled
+     * @return false if any of lengths is out of range
+     */
+    bool expandLabel(std::string_view label, std::span<const uint8_t> context, std::span<uint8_t> out) const;
+
+private:
+    bool expandParts(std::span<const std::span<const uint8_t>> info, std::span<uint8_t> out) const;
+
+    HmacKey<Hash> m_key;
+};
+
+extern template class Hkdf<Sha256>;
+extern template class Hkdf<Sha384>;
+extern template class Hkdf<Sha512>;
+
+using HkdfSha256 = Hkdf<Sha256>;
+using HkdfSha384 = Hkdf<Sha384>;
+using HkdfSha512 = Hkdf<Sha512>;
+
+} // namespace psi::tools
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "ByteBuffer.h"
+#include "Sha256.h"
+#include "Sha512.h"
+
+#include <span>
+
+namespace psi::tools {
+
+/**
+ * @brief HmacKey class represents HMAC key with precomputed inner and outer pad states.
+ * Blocks key ^ ipad and key ^ opad are hashed once in constructor, so every MAC costs only blocks of message and
+ * final block of outer hash. The same object might be reused by any number of MAC operations from any number of
+ * threads. Available for Sha256, Sha384 and Sha512 as HmacSha256Key, HmacSha384Key and HmacSha512Key.
+ *
+ * @tparam Hash incremental hasher
+ */
+template <typename Hash>
+class HmacKey final
+{
+public:
+    using Digest = typename Hash::Digest;
+    static constexpr size_t DIGEST_SIZE = Hash::DIGEST_SIZE;
+
+    /**
+     * @brief Construct a new HmacKey object with empty key.
+     *
+     */
+    HmacKey();
+
+    /**
+     * @brief Construct a new HmacKey object and precompute pad states.
+     *
+     * @param key key buffer of any length, keys longer than block of hash are hashed first
+     */
+    explicit HmacKey(const ByteBuffer &key);
+
+    /**
+     * @brief Construct a new HmacKey object and precompute pad states.
+     *
+     * @param key pointer to key data
+     * @param keyLen length of key
+     */
+    HmacKey(const uint8_t *key, size_t keyLen);
+
+    /**
+     * @brief Calculate MAC of message.
+     *
+     * @param data (in) message
+     * @return Digest MAC of DIGEST_SIZE bytes
+     */
+    Digest mac(std::span<const uint8_t> data) const;
+
+    /**
+     * @brief Calculate MAC of message.
+     *
+     * @param data (in) message buffer
+     * @return ByteBuffer MAC buffer of DIGEST_SIZE bytes
+     */
+    ByteBuffer mac(const ByteBuffer &data) const;
+
+    /**
+     * @brief Calculate MAC of message into caller provided buffer.
+     *
+     * @param data (in) message
+     * @param out (out) output buffer of at least DIGEST_SIZE bytes
+     * @return true if MAC was written
+     * @return false if output is too small
+     */
+    bool mac(std::span<const uint8_t> data, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Verify MAC of message in constant time.
+     *
+     * @param data (in) message
+     * @param tag (in) expected MAC of DIGEST_SIZE bytes, truncated MAC is rejected
+     * @return true if MAC matches
+     * @return false otherwise
+     */
+    bool verify(std::span<const uint8_t> data, std::span<const uint8_t> tag) const;
+
+    /**
+     * @brief Start MAC of message provided chunk by chunk.
+     * Chunks are passed to update() of returned hasher, MAC is produced by finish().
+     *
+     * @return Hash hasher initialized with inner pad state
+     */
+    Hash begin() const;
+
+    /**
+     * @brief Finish MAC of message started by begin().
+     * Hasher is reset afterwards.
+     *
+     * @param inner (in) hasher returned by begin() with all chunks of message
+     * @param out (out) output buffer of at least DIGEST_SIZE bytes
+     * @return true if MAC was written
+     * @return false if output is too small
+     */
+    bool finish(Hash &inner, std::span<uint8_t> out) const;
+
+private:
+    // hashers after pad blocks, their states are wiped by destructor of hasher
+    Hash m_inner;
+    Hash m_outer;
+};
+
+extern template class HmacKey<Sha256>;
+extern template class HmacKey<Sha384>;
+extern template class HmacKey<Sha512>;
+
+using HmacSha256Key = HmacKey<Sha256>;
+using HmacSha384Key = HmacKey<Sha384>;
+using HmacSha512Key = HmacKey<Sha512>;
+
+} // namespace psi::tools
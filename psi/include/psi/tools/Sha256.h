@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ByteBuffer.h"
+#include "ShaBlockBuffer.h"
+
+#include <array>
+#include <span>
+
+namespace psi::tools {
+
+/**
+ * @brief Sha256 class calculates SHA-256 hash of message provided chunk by chunk.
+ * Whole blocks are hashed directly from caller's memory, only incomplete block is copied into internal 64 bytes
+ * buffer, so hashing of data of any length requires constant memory.
+ *
+ */
+class Sha256 final
+{
+public:
+    using Digest = std::array<uint8_t, 32u>;
+    static constexpr size_t BLOCK_SIZE = 64u;
+    static constexpr size_t DIGEST_SIZE = 32u;
+
+    /**
+     * @brief Construct a new Sha256 object ready to accept data.
+     *
+     */
+    Sha256();
+
+    /**
+     * @brief Discard all provided data and start new hash.
+     *
+     */
+    void reset();
+
+    /**
+     * @brief Hash next chunk of message.
+     *
+     * @param data (in) chunk of message, might be of any length
+     */
+    void update(std::span<const uint8_t> data);
+
+    /**
+     * @brief Hash next chunk of message.
+     *
+     * @param data (in) chunk of message
+     */
+    void update(const ByteBuffer &data);
+
+    /**
+     * @brief Finish hashing and return hash of all provided chunks.
+     * Object is reset afterwards and might be reused for next message.
+     *
+     * @return Digest 32 bytes hash
+     */
+    Digest final();
+
+    /**
+     * @brief Finish hashing and write hash of all provided chunks into caller provided buffer.
+     * Object is reset afterwards and might be reused for next message.
+     *
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if hash was written
+     * @return false if output is too small, state is not changed in this case
+     */
+    bool final(std::span<uint8_t> out);
+
+    /**
+     * @brief Return number of hashed bytes since last reset.
+     *
+     * @return uint64_t length in bytes
+     */
+    uint64_t length() const;
+
+    /**
+     * @brief Calculate SHA-256 hash of message in one call.
+     *
+     * @param data (in) message
+     * @return Digest 32 bytes hash
+     */
+    static Digest hash(std::span<const uint8_t> data);
+
+    /**
+     * @brief Calculate SHA-256 hashes of many independent messages.
+     * Messages are hashed in parallel lanes of AVX2/AVX-512 registers if CPU supports them, so throughput on small
+     * messages is much higher than hashing them one by one. Messages might have different lengths.
+     *
+     * @param messages (in) list of messages
+     * @param digests (out) list of hashes, at least messages.size() entries
+     * @return true if hashes were written
+     * @return false if digests list is too small
+     */
+    static bool hashBatch(std::span<const std::span<const uint8_t>> messages, std::span<Digest> digests);
+
+private:
+    // state and incomplete block are wiped by destructor of buffer
+    ShaBlockBuffer<uint32_t, BLOCK_SIZE> m_block;
+};
+
+} // namespace psi::tools
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "ByteBuffer.h"
+#include "ShaBlockBuffer.h"
+
+#include <array>
+#include <span>
+
+namespace psi::tools {
+
+/**
+ * @brief Sha512 class calculates SHA-512 hash of message provided chunk by chunk.
+ * Whole blocks are hashed directly from caller's memory, only incomplete block is copied into internal 128 bytes
+ * buffer, so hashing of data of any length requires constant memory. On 64-bit CPUs SHA-512 processes more bytes
+ * per cycle than SHA-256.
+ *
+ */
+class Sha512 final
+{
+public:
+    using Digest = std::array<uint8_t, 64u>;
+    static constexpr size_t BLOCK_SIZE = 128u;
+    static constexpr size_t DIGEST_SIZE = 64u;
+
+    /**
+     * @brief Construct a new Sha512 object ready to accept data.
+     *
+     */
+    Sha512();
+
+    /**
+     * @brief Discard all provided data and start new hash.
+     *
+     */
+    void reset();
+
+    /**
+     * @brief Hash next chunk of message.
+     *
+     * @param data (in) chunk of message, might be of any length
+     */
+    void update(std::span<const uint8_t> data);
+
+    /**
+     * @brief Hash next chunk of message.
+     *
+     * @param data (in) chunk of message
+     */
+    void update(const ByteBuffer &data);
+
+    /**
+     * @brief Finish hashing and return hash of all provided chunks.
+     * Object is reset afterwards and might be reused for next message.
+     *
+     * @return Digest 64 bytes hash
+     */
+    Digest final();
+
+    /**
+     * @brief Finish hashing and write hash of all provided chunks into caller provided buffer.
+     * Object is reset afterwards and might be reused for next message.
+     *
+     * @param out (out) output buffer of at least 64 bytes
+     * @return true if hash was written
+     * @return false if output is too small, state is not changed in this case
+     */
+    bool final(std::span<uint8_t> out);
+
+    /**
+     * @brief Return number of hashed bytes since last reset.
+     *
+     * @return uint64_t length in bytes
+     */
+    uint64_t length() const;
+
+    /**
+     * @brief Calculate SHA-512 hash of message in one call.
+     *
+     * @param data (in) message
+     * @return Digest 64 bytes hash
+     */
+    static Digest hash(std::span<const uint8_t> data);
+
+private:
+    friend class Sha384;
+
+    // SHA-384 differs only by initial state and truncated output
+    explicit Sha512(size_t digestSize);
+
+    // state and incomplete block are wiped by destructor of buffer
+    ShaBlockBuffer<uint64_t, BLOCK_SIZE> m_block;
+    size_t m_digestSize = DIGEST_SIZE;
+};
+
+/**
+ * @brief Sha384 class calculates SHA-384 hash of message provided chunk by chunk.
+ * It is truncated SHA-512 with different initial state, memory usage is the same as of Sha512.
+ *
+ */
+class Sha384 final
+{
+public:
+    using Digest = std::array<uint8_t, 48u>;
+    static constexpr size_t BLOCK_SIZE = Sha512::BLOCK_SIZE;
+    static constexpr size_t DIGEST_SIZE = 48u;
+
+    /**
+     * @brief Construct a new Sha384 object ready to accept data.
+     *
+     */
+    Sha384();
+
+    /**
+     * @brief Discard all provided data and start new hash.
+     *
+     */
+    void reset();
+
+    /**
+     * @brief Hash next chunk of message.
+     *
+     * @param data (in) chunk of message, might be of any length
+     */
+    void update(std::span<const uint8_t> data);
+
+    /**
+     * @brief Hash next chunk of message.
+     *
+     * @param data (in) chunk of message
+     */
+    void update(const ByteBuffer &data);
+
+    /**
+     * @brief Finish hashing and return hash of all provided chunks.
+     * Object is reset afterwards and might be reused for next message.
+     *
+     * @return Digest 48 bytes hash
+     */
+    Digest final();
+
+    /**
+     * @brief Finish hashing and write hash of all provided chunks into caller provided buffer.
+     * Object is reset afterwards and might be reused for next message.
+     *
+     * @param out (out) output buffer of at least 48 bytes
+     * @return true if hash was written
+     * @return false if output is too small, state is not changed in this case
+     */
+    bool final(std::span<uint8_t> out);
+
+    /**
+     * @brief Return number of hashed bytes since last reset.
+     *
+     * @return uint64_t length in bytes
+     */
+    uint64_t length() const;
+
+    /**
+     * @brief Calculate SHA-384 hash of message in one call.
+     *
+     * @param data (in) message
+     * @return Digest 48 bytes hash
+     */
+    static Digest hash(std::span<const uint8_t> data);
+
+private:
+    Sha512 m_hash;
+};
+
+} // namespace psi::tools
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Tools.h"
+
+#include <algorithm>
+#include <array>
+#include <span>
+
+namespace psi::tools {
+
+/**
+ * @brief ShaBlockBuffer class keeps intermediate state of SHA-2 hash together with incomplete block of message.
+ * Whole blocks are passed to compress function directly from caller's memory, only incomplete block is copied into
+ * internal buffer. Init, compress and finish functions of concrete hash are provided by Sha256 and Sha512.
+ *
+ * @tparam Word type of state word
+ * @tparam BlockSize size of hashed block in bytes
+ */
+template <typename Word, size_t BlockSize>
+class ShaBlockBuffer final
+{
+public:
+    using InitFn = void (*)(Word *);
+    using CompressFn = void (*)(Word *, const uint8_t *, size_t);
+
+    ShaBlockBuffer() = default;
+
+    /**
+     * @brief Destroy the ShaBlockBuffer object and wipe buffered data and intermediate state.
+     *
+     */
+    ~ShaBlockBuffer();
+
+    ShaBlockBuffer(const ShaBlockBuffer &) = default;
+    ShaBlockBuffer &operator=(const ShaBlockBuffer &) = default;
+
+    /**
+     * @brief Discard all provided data and set initial state.
+     *
+     * @param init (in) function writing initial state of hash
+     */
+    void reset(InitFn init);
+
+    /**
+     * @brief Hash next chunk of message.
+     *
+     * @tparam Compress function hashing whole blocks into state
+     * @param data (in) chunk of message, might be of any length
+     */
+    template <CompressFn Compress>
+    void update(std::span<const uint8_t> data);
+
+    /**
+     * @brief Pad incomplete block and write hash by provided finish function.
+     * Object must be reset afterwards.
+     *
+     * @param finish (in) function of (state, tail, tailLen, totalLen, args...)
+     * @param args (in) output arguments passed to finish function
+     */
+    template <typename Finish, typename... Args>
+    void final(Finish finish, Args... args);
+
+    /**
+     * @brief Return number of hashed bytes since last reset.
+     *
+     * @return uint64_t length in bytes
+     */
+    uint64_t length() const;
+
+private:
+    std::array<Word, 8u> m_state = {};
+    std::array<uint8_t, BlockSize> m_buffer = {};
+    size_t m_bufferLen = 0u;
+    uint64_t m_length = 0u;
+};
+
+template <typename Word, size_t BlockSize>
+ShaBlockBuffer<Word, BlockSize>::~ShaBlockBuffer()
+{
+    mem_wipe(reinterpret_cast<uint8_t *>(m_state.data()), sizeof(m_state));
+    mem_wipe(m_buffer.data(), m_buffer.size());
+}
+
+template <typename Word, size_t BlockSize>
+void ShaBlockBuffer<Word, BlockSize>::reset(InitFn init)
+{
+    init(m_state.data());
+    mem_wipe(m_buffer.data(), m_buffer.size());
+    m_bufferLen = 0u;
+    m_length = 0u;
+}
+
+template <typename Word, size_t BlockSize>
+template <typename ShaBlockBuffer<Word, BlockSize>::CompressFn Compress>
+void ShaBlockBuffer<Word, BlockSize>::update(std::span<const uint8_t> data)
+{
+    const uint8_t *ptr = data.data();
+    size_t len = data.size();
+    m_length += len;
+
+    if (m_bufferLen && len) {
+        const size_t sz = std::min(len, BlockSize - m_bufferLen);
+        mem_copy(m_buffer.data(), m_bufferLen, ptr, 0, sz);
+        m_bufferLen += sz;
+        ptr = shift_ptr(ptr, sz);
+        len -= sz;
+        if (m_bufferLen < BlockSize) {
+            return;
+        }
+        Compress(m_state.data(), m_buffer.data(), 1u);
+        m_bufferLen = 0u;
+    }
+
+    const size_t blocks = len / BlockSize;
+    if (blocks) {
+        Compress(m_state.data(), ptr, blocks);
+        ptr = shift_ptr(ptr, blocks * BlockSize);
+        len -= blocks * BlockSize;
+    }
+
+    if (len) {
+        mem_copy(m_buffer.data(), 0, ptr, 0, len);
+        m_bufferLen = len;
+    }
+}
+
+template <typename Word, size_t BlockSize>
+template <typename Finish, typename... Args>
+void ShaBlockBuffer<Word, BlockSize>::final(Finish finish, Args... args)
+{
+    finish(m_state.data(), m_buffer.data(), m_bufferLen, m_length, args...);
+}
+
+template <typename Word, size_t BlockSize>
+uint64_t ShaBlockBuffer<Word, BlockSize>::length() const
+{
+    return m_length;
+}
+
+} // namespace psi::tools
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "Hkdf.h"
+
+#include <array>
+#include <span>
+#include <string_view>
+
+namespace psi::tools {
+
+/**
+ * @brief Tls13KeySchedule class implements key schedule of TLS 1.3 (RFC 8446 7.1) for SHA-256 cipher suites.
+ * Object moves through early, handshake and master stages, secrets of current stage are derived into caller provided
+ * buffers. HMAC context of current stage secret is prepared once per stage, no memory is allocated.
+ *
+ */
+class Tls13KeySchedule final
+{
+public:
+    static constexpr size_t HASH_SIZE = HkdfSha256::HASH_SIZE;
+    static constexpr size_t IV_SIZE = 12u;
+    using Secret = std::array<uint8_t, HASH_SIZE>;
+
+    enum class Stage : uint8_t
+    {
+        Early,
+        Handshake,
+        Master
+    };
+
+    /**
+     * @brief Construct a new Tls13KeySchedule object in early stage.
+     *
+     * @param psk (in) pre-shared key, empty if no PSK is used
+     */
+    explicit Tls13KeySchedule(std::span<const uint8_t> psk = {});
+
+    /**
+     * @brief Destroy the Tls13KeySchedule object and wipe current secret.
+     *
+     */
+    ~Tls13KeySchedule();
+
+    /**
+     * @brief Return current stage.
+     *
+     * @return Stage current stage
+     */
+    Stage stage() const;
+
+    /**
+     * @brief Return secret of current stage: early secret, handshake secret or master secret.
+     *
+     * @return const Secret& 32 bytes secret
+     */
+    const Secret &secret() const;
+
+    /**
+     * @brief Move from early to handshake stage.
+     *
+     * @param sharedSecret (in) (EC)DHE shared secret, empty in PSK-only mode
+     * @return true if stage was changed
+     * @return false if schedule is not in early stage
+     */
+    bool deriveHandshake(std::span<const uint8_t> sharedSecret);
+
+    /**
+     * @brief Move from handshake to master stage.
+     *
+     * @return true if stage was changed
+     * @return false if schedule is not in handshake stage
+     */
+    bool deriveMaster();
+
+    /**
+     * @brief Derive binder key, early stage only.
+     *
+     * @param external (in) true for external PSK ("ext binder"), false for resumption PSK ("res binder")
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool binderKey(bool external, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive client early traffic secret, early stage only.
+     *
+     * @param helloHash (in) 32 bytes hash of ClientHello
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool clientEarlyTrafficSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive early exporter master secret, early stage only.
+     *
+     * @param helloHash (in) 32 bytes hash of ClientHello
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool earlyExporterMasterSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive client handshake traffic secret, handshake stage only.
+     *
+     * @param helloHash (in) 32 bytes hash of ClientHello..ServerHello
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool clientHandshakeTrafficSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive server handshake traffic secret, handshake stage only.
+     *
+     * @param helloHash (in) 32 bytes hash of ClientHello..ServerHello
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool serverHandshakeTrafficSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive client application traffic secret, master stage only.
+     *
+     * @param handshakeHash (in) 32 bytes hash of ClientHello..server Finished
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool clientApplicationTrafficSecret(std::span<const uint8_t> handshakeHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive server application traffic secret, master stage only.
+     *
+     * @param handshakeHash (in) 32 bytes hash of ClientHello..server Finished
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool serverApplicationTrafficSecret(std::span<const uint8_t> handshakeHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive exporter master secret, master stage only.
+     *
+     * @param handshakeHash (in) 32 bytes hash of ClientHello..server Finished
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool exporterMasterSecret(std::span<const uint8_t> handshakeHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive resumption master secret, master stage only.
+     *
+     * @param handshakeHash (in) 32 bytes hash of ClientHello..client Finished
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if stage or buffer size is wrong
+     */
+    bool resumptionMasterSecret(std::span<const uint8_t> handshakeHash, std::span<uint8_t> out) const;
+
+    /**
+     * @brief Derive record protection key and IV from traffic secret.
+     *
+     * @param secret (in) 32 bytes traffic secret
+     * @param key (out) 16 bytes for AES-128-GCM or 32 bytes for AES-256-GCM/ChaCha20-Poly1305
+     * @param iv (out) 12 bytes buffer
+     * @return true if key and IV were written
+     * @return false if any of sizes is wrong
+     */
+    static bool trafficKeys(std::span<const uint8_t> secret, std::span<uint8_t> key, std::span<uint8_t> iv);
+
+    /**
+     * @brief Derive key of Finished message from handshake traffic secret.
+     *
+     * @param secret (in) 32 bytes handshake traffic secret
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if key was written
+     * @return false if any of sizes is wrong
+     */
+    static bool finishedKey(std::span<const uint8_t> secret, std::span<uint8_t> out);
+
+    /**
+     * @brief Derive next application traffic secret for KeyUpdate.
+     * Input and output might point to the same memory.
+     *
+     * @param secret (in) 32 bytes current application traffic secret
+     * @param out (out) output buffer of at least 32 bytes
+     * @return true if secret was written
+     * @return false if any of sizes is wrong
+     */
+    static bool nextTrafficSecret(std::span<const uint8_t> secret, std::span<uint8_t> out);
+
+private:
+    bool deriveSecret(Stage stage,
+                      std::string_view label,
+                      std::span<const uint8_t> hash,
+                      std::span<uint8_t> out) const;
+    static bool expandSecret(std::span<const uint8_t> secret, std::string_view label, std::span<uint8_t> out);
+    void advance(std::span<const uint8_t> ikm);
+
+    HkdfSha256 m_hkdf;
+    Secret m_secret = {};
+    Stage m_stage = Stage::Early;
+};
+
+} // namespace psi::tools
@@ -306,4 +306,37 @@ inline void mem_set(T *to, size_t to_offset, T value, size_t sz)
 #pragma clang diagnostic pop
 }
 
+/**
+ * @brief Compares two memory blocks in constant time.
+ * Duration depends only on size, not on position of the first difference.
+ * 
+ * @param a first block
+ * @param b second block
+ * @param sz number of bytes to compare
+ * @return true if blocks are equal
+ * @return false otherwise
+ */
+inline bool mem_equal_ct(const uint8_t *a, const uint8_t *b, size_t sz)
+{
+    volatile uint8_t diff = 0u;
+    for (size_t i = 0; i < sz; ++i) {
+        diff = diff | uint8_t(*shift_ptr(a, i) ^ *shift_ptr(b, i));
+    }
+    return diff == 0u;
+}
+
+/**
+ * @brief Fills memory block with zeroes, the write is not optimized away even if memory is not read later.
+ * 
+ * @param to memory block
+ * @param sz number of bytes
+ */
+inline void mem_wipe(uint8_t *to, size_t sz)
+{
+    volatile uint8_t *p = to;
+    for (size_t i = 0; i < sz; ++i) {
+        *shift_ptr(p, i) = 0u;
+    }
+}
+
 } // namespace psi::tools
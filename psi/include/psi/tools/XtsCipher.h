@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AesKey.h"
+#include "ByteBuffer.h"
+
+#include <span>
+
+namespace psi::tools {
+
+/**
+ * @brief XtsCipher class encrypts/decrypts fixed-size storage sectors in XTS-AES mode (IEEE 1619).
+ * Every sector is processed independently with its sector number as tweak, so any sector might be decrypted
+ * without touching its neighbours. Data is processed in place, large requests are split between all cores.
+ *
+ */
+class XtsCipher final
+{
+public:
+    /**
+     * @brief Construct a new invalid XtsCipher object.
+     *
+     */
+    XtsCipher() = default;
+
+    /**
+     * @brief Construct a new XtsCipher object and expand both of its keys.
+     *
+     * @param key key buffer, 32 bytes for XTS-AES-128 or 64 bytes for XTS-AES-256, halves must differ
+     */
+    explicit XtsCipher(const ByteBuffer &key);
+
+    /**
+     * @brief Construct a new XtsCipher object and expand both of its keys.
+     *
+     * @param key pointer to key data, data key followed by tweak key
+     * @param keyLen length of key, 32 bytes for XTS-AES-128 or 64 bytes for XTS-AES-256
+     */
+    XtsCipher(const uint8_t *key, size_t keyLen);
+
+    /**
+     * @brief Check if keys were successfully expanded.
+     *
+     * @return true if key has valid length and different halves
+     * @return false otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Encrypt consecutive sectors in place.
+     *
+     * @param data (in, out) sectors to be encrypted, length must be multiple of sectorSize
+     * @param sectorSize (in) size of every sector in bytes, at least 16
+     * @param firstSector (in) number of first sector in data
+     * @return true if sectors were encrypted
+     * @return false if cipher is invalid or sizes are invalid, data is not changed
+     */
+    bool encrypt(std::span<uint8_t> data, size_t sectorSize, uint64_t firstSector) const;
+
+    /**
+     * @brief Decrypt consecutive sectors in place.
+     *
+     * @param data (in, out) sectors to be decrypted, length must be multiple of sectorSize
+     * @param sectorSize (in) size of every sector in bytes, at least 16
+     * @param firstSector (in) number of first sector in data
+     * @return true if sectors were decrypted
+     * @return false if cipher is invalid or sizes are invalid, data is not changed
+     */
+    bool decrypt(std::span<uint8_t> data, size_t sectorSize, uint64_t firstSector) const;
+
+private:
+    bool canProcess(size_t len, size_t sectorSize) const;
+
+    AesKey m_dataKey;
+    AesKey m_tweakKey;
+};
+
+} // namespace psi::tools
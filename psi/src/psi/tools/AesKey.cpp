@@ -0,0 +1,56 @@
+#include "psi/tools/AesKey.h"
+
+#include "crypt/aes.h"
+#include "crypt/aes_gcm.h"
+
+namespace psi::tools {
+
+AesKey::AesKey(const ByteBuffer &key)
+    : AesKey(key.data(), key.size())
+{
+}
+
+AesKey::AesKey(const uint8_t *key, size_t keyLen)
+{
+    crypt::aes::expandKey(key, keyLen, *this);
+    if (isValid()) {
+        crypt::aes_gcm::prepareKey(*this);
+    }
+}
+
+AesKey::~AesKey()
+{
+    mem_wipe(reinterpret_cast<uint8_t *>(m_roundKeys.data()), sizeof(m_roundKeys));
+    mem_wipe(reinterpret_cast<uint8_t *>(m_decRoundKeys.data()), sizeof(m_decRoundKeys));
+    mem_wipe(reinterpret_cast<uint8_t *>(m_gHashTable.data()), sizeof(m_gHashTable));
+    mem_wipe(reinterpret_cast<uint8_t *>(m_gHashPowers.data()), sizeof(m_gHashPowers));
+}
+
+bool AesKey::isValid() const
+{
+    return m_rounds != 0u;
+}
+
+size_t AesKey::keySize() const
+{
+    switch (m_rounds) {
+    case 10u:
+        return 16u;
+    case 14u:
+        return 32u;
+    default:
+        return 0u;
+    }
+}
+
+uint8_t AesKey::rounds() const
+{
+    return m_rounds;
+}
+
+const AesKey::RoundKey &AesKey::roundKey(size_t round) const
+{
+    return m_roundKeys[round];
+}
+
+} // namespace psi::tools
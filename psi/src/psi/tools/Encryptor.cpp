@@ -1,15 +1,161 @@
 #include "psi/tools/Encryptor.h"
-
-#include <chrono>
+#include "psi/tools/Hkdf.h"
 
 #include "crypt/aes.h"
 #include "crypt/aes_gcm.h"
 #include "crypt/base64.h"
+#include "crypt/chacha20_poly1305.h"
+#include "crypt/csprng.h"
 #include "crypt/sha.h"
 #include "crypt/x25519.h"
 
 namespace psi::tools {
 
+namespace {
+
+// incomplete last block is followed by one byte with its length
+bool aesDecryptedLength(std::span<const uint8_t> data, size_t &outLen)
+{
+    const size_t lenOffset = data.size() % 16u;
+    if (lenOffset == 0u) {
+        outLen = data.size();
+        return true;
+    }
+
+    const uint8_t extraBytes = data.back();
+    if (lenOffset != 1u || data.size() < 17u || extraBytes == 0u || extraBytes > 15u) {
+        return false;
+    }
+    outLen = data.size() - 1u - 16u + extraBytes;
+    return true;
+}
+
+template <uint8_t Nr>
+bool encryptEcb(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key)
+{
+    if (key.rounds() != Nr || out.size() < Encryptor::aesEncryptedSize(data.size())) {
+        return false;
+    }
+
+    const size_t blocks = data.size() / 16u;
+    const size_t extraBytes = data.size() % 16u;
+    uint8_t lastChunk[16u] = {};
+    mem_copy(lastChunk, 0, data.data(), blocks * 16u, extraBytes);
+
+    crypt::aes::encryptBlocks(key, data.data(), out.data(), blocks);
+    if (extraBytes) {
+        crypt::aes::encryptBlock(key, lastChunk, shift_ptr(out.data(), blocks * 16u));
+        out[(blocks + 1u) * 16u] = uint8_t(extraBytes);
+        mem_wipe(lastChunk, sizeof(lastChunk));
+    }
+    return true;
+}
+
+template <uint8_t Nr>
+bool decryptEcb(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key)
+{
+    size_t outLen = 0;
+    if (key.rounds() != Nr || !aesDecryptedLength(data, outLen) || out.size() < outLen) {
+        return false;
+    }
+
+    const size_t blocks = outLen / 16u;
+    const size_t extraBytes = outLen % 16u;
+    crypt::aes::decryptBlocks(key, data.data(), out.data(), blocks);
+    if (extraBytes) {
+        uint8_t lastChunk[16u] = {};
+        crypt::aes::decryptBlock(key, shift_ptr(data.data(), blocks * 16u), lastChunk);
+        mem_copy(out.data(), blocks * 16u, lastChunk, 0, extraBytes);
+        mem_wipe(lastChunk, sizeof(lastChunk));
+    }
+    return true;
+}
+
+template <uint8_t Nr>
+bool encryptCbc(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key, std::span<const uint8_t> iv)
+{
+    if (key.rounds() != Nr || iv.size() != 16u || out.size() < Encryptor::aesCbcEncryptedSize(data.size())) {
+        return false;
+    }
+
+    crypt::aes::cbcEncryptPkcs7(key, iv.data(), data.data(), data.size(), out.data());
+    return true;
+}
+
+template <uint8_t Nr>
+bool decryptCbc(std::span<const uint8_t> data,
+                std::span<uint8_t> out,
+                const AesKey &key,
+                std::span<const uint8_t> iv,
+                size_t &outLen)
+{
+    if (key.rounds() != Nr || iv.size() != 16u || out.size() < data.size()) {
+        return false;
+    }
+
+    return crypt::aes::cbcDecryptPkcs7(key, iv.data(), data.data(), data.size(), out.data(), outLen);
+}
+
+template <uint8_t Nr>
+bool cryptCtr(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key, std::span<const uint8_t> iv)
+{
+    if (key.rounds() != Nr || iv.size() != 16u || out.size() < data.size()) {
+        return false;
+    }
+
+    uint8_t counter[16u];
+    mem_copy(counter, 0, iv.data(), 0, 16u);
+    crypt::aes::ctr128Xor(key, counter, data.data(), out.data(), data.size());
+    return true;
+}
+
+template <uint8_t Nr>
+bool encryptGcm(std::span<const uint8_t> data,
+                std::span<uint8_t> out,
+                const AesKey &key,
+                std::span<const uint8_t> iv,
+                std::span<uint8_t> tag,
+                std::span<const uint8_t> acc)
+{
+    if (key.rounds() != Nr || iv.empty() || tag.size() < 16u || out.size() < data.size()) {
+        return false;
+    }
+
+    crypt::aes_gcm::Tag fullTag = {};
+    if (!crypt::aes_gcm::encrypt(
+            data.data(), data.size(), key, iv.data(), iv.size(), acc.data(), acc.size(), out.data(), fullTag)) {
+        return false;
+    }
+    mem_copy(tag.data(), 0, fullTag.data(), 0, fullTag.size());
+    return true;
+}
+
+template <uint8_t Nr>
+bool decryptGcm(std::span<const uint8_t> data,
+                std::span<uint8_t> out,
+                const AesKey &key,
+                std::span<const uint8_t> iv,
+                std::span<const uint8_t> tag,
+                std::span<const uint8_t> acc)
+{
+    if (key.rounds() != Nr || iv.empty() || tag.size() != 16u || out.size() < data.size()) {
+        return false;
+    }
+
+    return crypt::aes_gcm::decrypt(data.data(),
+                                   data.size(),
+                                   key,
+                                   iv.data(),
+                                   iv.size(),
+                                   acc.data(),
+                                   acc.size(),
+                                   tag.data(),
+                                   tag.size(),
+                                   out.data());
+}
+
+} // namespace
+
 ByteBuffer Encryptor::encryptBase64(const ByteBuffer &inputBuffer)
 {
     return crypt::base64::encryptBase64(inputBuffer);
@@ -20,24 +166,108 @@ ByteBuffer Encryptor::decryptBase64(const ByteBuffer &inputBuffer)
     return crypt::base64::decryptBase64(inputBuffer);
 }
 
+size_t Encryptor::base64EncodedSize(size_t dataLen)
+{
+    return crypt::base64::encodedSize(dataLen);
+}
+
+size_t Encryptor::base64DecodedSize(std::span<const uint8_t> data)
+{
+    return crypt::base64::decodedSize(data.data(), data.size());
+}
+
+bool Encryptor::encryptBase64(std::span<const uint8_t> data, std::span<uint8_t> out)
+{
+    if (out.size() < crypt::base64::encodedSize(data.size())) {
+        return false;
+    }
+
+    crypt::base64::encode(data.data(), data.size(), out.data());
+    return true;
+}
+
+bool Encryptor::decryptBase64(std::span<const uint8_t> data, std::span<uint8_t> out)
+{
+    // empty string is valid encoding of empty data
+    if (data.empty()) {
+        return true;
+    }
+
+    const size_t outSize = crypt::base64::decodedSize(data.data(), data.size());
+    if (outSize == 0 || out.size() < outSize) {
+        return false;
+    }
+
+    return crypt::base64::decode(data.data(), data.size(), out.data());
+}
+
+size_t Encryptor::aesCbcEncryptedSize(size_t dataLen)
+{
+    return dataLen + 16u - dataLen % 16u;
+}
+
 ByteBuffer Encryptor::encryptAes128(const ByteBuffer &inputData, const ByteBuffer &key)
 {
     return crypt::aes::encryptAes_impl<4, 10>(inputData, key);
 }
 
+ByteBuffer Encryptor::encryptAes128(const ByteBuffer &inputData, const AesKey &key)
+{
+    return crypt::aes::encryptAes_impl<4, 10>(inputData, key);
+}
+
 ByteBuffer Encryptor::decryptAes128(const ByteBuffer &inputData, const ByteBuffer &key)
 {
     return crypt::aes::decryptAes_impl<4, 10>(inputData, key);
 }
 
+ByteBuffer Encryptor::decryptAes128(const ByteBuffer &inputData, const AesKey &key)
+{
+    return crypt::aes::decryptAes_impl<4, 10>(inputData, key);
+}
+
+size_t Encryptor::aesEncryptedSize(size_t dataLen)
+{
+    const size_t extraBytes = dataLen % 16u;
+    return extraBytes == 0u ? dataLen : dataLen + 16u - extraBytes + 1u;
+}
+
+size_t Encryptor::aesDecryptedSize(std::span<const uint8_t> data)
+{
+    size_t outLen = 0;
+    return aesDecryptedLength(data, outLen) ? outLen : 0u;
+}
+
+bool Encryptor::encryptAes128(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key)
+{
+    return encryptEcb<10u>(data, out, key);
+}
+
+bool Encryptor::decryptAes128(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key)
+{
+    return decryptEcb<10u>(data, out, key);
+}
+
 ByteBuffer Encryptor::encryptAes128Gcm(const ByteBuffer &inputData,
                                        const ByteBuffer &key,
                                        const ByteBuffer &iv,
                                        ByteBuffer &tagBuffer,
                                        const ByteBuffer &acc)
 {
-    crypt::aes_gcm::Tag tag;
-    auto encoded = crypt::aes_gcm::encrypt(inputData, key, iv, tag, acc);
+    crypt::aes_gcm::Tag tag = {};
+    auto encoded = crypt::aes_gcm::encrypt_impl<4, 10>(inputData, key, iv, tag, acc);
+    tagBuffer.write(tag);
+    return encoded;
+}
+
+ByteBuffer Encryptor::encryptAes128Gcm(const ByteBuffer &inputData,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       ByteBuffer &tagBuffer,
+                                       const ByteBuffer &acc)
+{
+    crypt::aes_gcm::Tag tag = {};
+    auto encoded = crypt::aes_gcm::encrypt_impl<4, 10>(inputData, key, iv, tag, acc);
     tagBuffer.write(tag);
     return encoded;
 }
@@ -48,7 +278,109 @@ ByteBuffer Encryptor::decryptAes128Gcm(const ByteBuffer &inputData,
                                        const ByteBuffer &tag,
                                        const ByteBuffer &acc)
 {
-    return crypt::aes_gcm::decrypt(inputData, key, iv, tag, acc);
+    return crypt::aes_gcm::decrypt_impl<4, 10>(inputData, key, iv, tag, acc);
+}
+
+ByteBuffer Encryptor::decryptAes128Gcm(const ByteBuffer &inputData,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       const ByteBuffer &tag,
+                                       const ByteBuffer &acc)
+{
+    return crypt::aes_gcm::decrypt_impl<4, 10>(inputData, key, iv, tag, acc);
+}
+
+ByteBuffer Encryptor::encryptAes128Cbc(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::encryptCbc_impl<4, 10>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes128Cbc(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::decryptCbc_impl<4, 10>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::encryptAes128Cbc(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::encryptCbc_impl<4, 10>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes128Cbc(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::decryptCbc_impl<4, 10>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::encryptAes128Ctr(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<4, 10>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes128Ctr(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<4, 10>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::encryptAes128Ctr(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<4, 10>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes128Ctr(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<4, 10>(inputData, key, iv);
+}
+
+bool Encryptor::encryptAes128Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv)
+{
+    return encryptCbc<10u>(data, out, key, iv);
+}
+
+bool Encryptor::decryptAes128Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 size_t &outLen)
+{
+    return decryptCbc<10u>(data, out, key, iv, outLen);
+}
+
+bool Encryptor::encryptAes128Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv)
+{
+    return cryptCtr<10u>(data, out, key, iv);
+}
+
+bool Encryptor::decryptAes128Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv)
+{
+    return cryptCtr<10u>(data, out, key, iv);
+}
+
+bool Encryptor::encryptAes128Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<uint8_t> tag,
+                                 std::span<const uint8_t> add)
+{
+    return encryptGcm<10u>(data, out, key, iv, tag, add);
+}
+
+bool Encryptor::decryptAes128Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<const uint8_t> tag,
+                                 std::span<const uint8_t> add)
+{
+    return decryptGcm<10u>(data, out, key, iv, tag, add);
 }
 
 ByteBuffer Encryptor::encryptAes256(const ByteBuffer &inputData, const ByteBuffer &key)
@@ -56,94 +388,398 @@ ByteBuffer Encryptor::encryptAes256(const ByteBuffer &inputData, const ByteBuffe
     return crypt::aes::encryptAes_impl<8, 14>(inputData, key);
 }
 
+ByteBuffer Encryptor::encryptAes256(const ByteBuffer &inputData, const AesKey &key)
+{
+    return crypt::aes::encryptAes_impl<8, 14>(inputData, key);
+}
+
 ByteBuffer Encryptor::decryptAes256(const ByteBuffer &inputData, const ByteBuffer &key)
 {
     return crypt::aes::decryptAes_impl<8, 14>(inputData, key);
 }
 
+ByteBuffer Encryptor::decryptAes256(const ByteBuffer &inputData, const AesKey &key)
+{
+    return crypt::aes::decryptAes_impl<8, 14>(inputData, key);
+}
+
+bool Encryptor::encryptAes256(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key)
+{
+    return encryptEcb<14u>(data, out, key);
+}
+
+bool Encryptor::decryptAes256(std::span<const uint8_t> data, std::span<uint8_t> out, const AesKey &key)
+{
+    return decryptEcb<14u>(data, out, key);
+}
+
+ByteBuffer Encryptor::encryptAes256Gcm(const ByteBuffer &inputData,
+                                       const ByteBuffer &key,
+                                       const ByteBuffer &iv,
+                                       ByteBuffer &tagBuffer,
+                                       const ByteBuffer &acc)
+{
+    crypt::aes_gcm::Tag tag = {};
+    auto encoded = crypt::aes_gcm::encrypt_impl<8, 14>(inputData, key, iv, tag, acc);
+    tagBuffer.write(tag);
+    return encoded;
+}
+
+ByteBuffer Encryptor::encryptAes256Gcm(const ByteBuffer &inputData,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       ByteBuffer &tagBuffer,
+                                       const ByteBuffer &acc)
+{
+    crypt::aes_gcm::Tag tag = {};
+    auto encoded = crypt::aes_gcm::encrypt_impl<8, 14>(inputData, key, iv, tag, acc);
+    tagBuffer.write(tag);
+    return encoded;
+}
+
+ByteBuffer Encryptor::decryptAes256Gcm(const ByteBuffer &inputData,
+                                       const ByteBuffer &key,
+                                       const ByteBuffer &iv,
+                                       const ByteBuffer &tag,
+                                       const ByteBuffer &acc)
+{
+    return crypt::aes_gcm::decrypt_impl<8, 14>(inputData, key, iv, tag, acc);
+}
+
+ByteBuffer Encryptor::decryptAes256Gcm(const ByteBuffer &inputData,
+                                       const AesKey &key,
+                                       const ByteBuffer &iv,
+                                       const ByteBuffer &tag,
+                                       const ByteBuffer &acc)
+{
+    return crypt::aes_gcm::decrypt_impl<8, 14>(inputData, key, iv, tag, acc);
+}
+
+ByteBuffer Encryptor::encryptAes256Cbc(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::encryptCbc_impl<8, 14>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes256Cbc(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::decryptCbc_impl<8, 14>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::encryptAes256Cbc(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::encryptCbc_impl<8, 14>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes256Cbc(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::decryptCbc_impl<8, 14>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::encryptAes256Ctr(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<8, 14>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes256Ctr(const ByteBuffer &inputData, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<8, 14>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::encryptAes256Ctr(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<8, 14>(inputData, key, iv);
+}
+
+ByteBuffer Encryptor::decryptAes256Ctr(const ByteBuffer &inputData, const AesKey &key, const ByteBuffer &iv)
+{
+    return crypt::aes::cryptCtr_impl<8, 14>(inputData, key, iv);
+}
+
+bool Encryptor::encryptAes256Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv)
+{
+    return encryptCbc<14u>(data, out, key, iv);
+}
+
+bool Encryptor::decryptAes256Cbc(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 size_t &outLen)
+{
+    return decryptCbc<14u>(data, out, key, iv, outLen);
+}
+
+bool Encryptor::encryptAes256Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv)
+{
+    return cryptCtr<14u>(data, out, key, iv);
+}
+
+bool Encryptor::decryptAes256Ctr(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv)
+{
+    return cryptCtr<14u>(data, out, key, iv);
+}
+
+bool Encryptor::encryptAes256Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<uint8_t> tag,
+                                 std::span<const uint8_t> add)
+{
+    return encryptGcm<14u>(data, out, key, iv, tag, add);
+}
+
+bool Encryptor::decryptAes256Gcm(std::span<const uint8_t> data,
+                                 std::span<uint8_t> out,
+                                 const AesKey &key,
+                                 std::span<const uint8_t> iv,
+                                 std::span<const uint8_t> tag,
+                                 std::span<const uint8_t> add)
+{
+    return decryptGcm<14u>(data, out, key, iv, tag, add);
+}
+
+ByteBuffer Encryptor::encryptChaCha20Poly1305(const ByteBuffer &inputData,
+                                              const ByteBuffer &key,
+                                              const ByteBuffer &iv,
+                                              ByteBuffer &tagBuffer,
+                                              const ByteBuffer &acc)
+{
+    crypt::chacha20_poly1305::Tag tag = {};
+    auto encoded = crypt::chacha20_poly1305::encrypt(inputData, key, iv, tag, acc);
+    tagBuffer.write(tag);
+    return encoded;
+}
+
+ByteBuffer Encryptor::decryptChaCha20Poly1305(const ByteBuffer &inputData,
+                                              const ByteBuffer &key,
+                                              const ByteBuffer &iv,
+                                              const ByteBuffer &tag,
+                                              const ByteBuffer &acc)
+{
+    return crypt::chacha20_poly1305::decrypt(inputData, key, iv, tag, acc);
+}
+
+bool Encryptor::encryptChaCha20Poly1305(std::span<const uint8_t> data,
+                                        std::span<uint8_t> out,
+                                        std::span<const uint8_t> key,
+                                        std::span<const uint8_t> iv,
+                                        std::span<uint8_t> tag,
+                                        std::span<const uint8_t> add)
+{
+    using crypt::chacha20_poly1305;
+    if (key.size() != chacha20_poly1305::KEY_SIZE || iv.size() != chacha20_poly1305::NONCE_SIZE
+        || tag.size() != chacha20_poly1305::TAG_SIZE || out.size() < data.size()) {
+        return false;
+    }
+
+    return chacha20_poly1305::encrypt(
+        key.data(), iv.data(), add.data(), add.size(), data.data(), data.size(), out.data(), tag.data());
+}
+
+bool Encryptor::decryptChaCha20Poly1305(std::span<const uint8_t> data,
+                                        std::span<uint8_t> out,
+                                        std::span<const uint8_t> key,
+                                        std::span<const uint8_t> iv,
+                                        std::span<const uint8_t> tag,
+                                        std::span<const uint8_t> add)
+{
+    using crypt::chacha20_poly1305;
+    if (key.size() != chacha20_poly1305::KEY_SIZE || iv.size() != chacha20_poly1305::NONCE_SIZE
+        || tag.size() != chacha20_poly1305::TAG_SIZE || out.size() < data.size()) {
+        return false;
+    }
+
+    return chacha20_poly1305::decrypt(
+        key.data(), iv.data(), add.data(), add.size(), data.data(), data.size(), tag.data(), out.data());
+}
+
+bool Encryptor::hasAesAcceleration()
+{
+    return crypt::aes::backend() == crypt::aes::Backend::AesNi;
+}
+
 ByteBuffer Encryptor::sha256(const ByteBuffer &data)
 {
     return crypt::sha::encode256(data);
 }
 
+bool Encryptor::sha256(std::span<const uint8_t> data, std::span<uint8_t> out)
+{
+    if (out.size() < 32u) {
+        return false;
+    }
+
+    crypt::sha::encode256(data.data(), data.size(), out.data());
+    return true;
+}
+
+ByteBuffer Encryptor::sha512(const ByteBuffer &data)
+{
+    return crypt::sha::encode512(data);
+}
+
+bool Encryptor::sha512(std::span<const uint8_t> data, std::span<uint8_t> out)
+{
+    if (out.size() < 64u) {
+        return false;
+    }
+
+    crypt::sha::encode512(data.data(), data.size(), out.data());
+    return true;
+}
+
+ByteBuffer Encryptor::sha384(const ByteBuffer &data)
+{
+    return crypt::sha::encode384(data);
+}
+
+bool Encryptor::sha384(std::span<const uint8_t> data, std::span<uint8_t> out)
+{
+    if (out.size() < 48u) {
+        return false;
+    }
+
+    crypt::sha::encode384(data.data(), data.size(), out.data());
+    return true;
+}
+
 ByteBuffer Encryptor::hmac256(const ByteBuffer &key, const ByteBuffer &data)
 {
     return crypt::sha::hmac256(key, data);
 }
 
+bool Encryptor::hmac256(std::span<const uint8_t> key, std::span<const uint8_t> data, std::span<uint8_t> out)
+{
+    return HmacSha256Key(key.data(), key.size()).mac(data, out);
+}
+
+ByteBuffer Encryptor::hmac512(const ByteBuffer &key, const ByteBuffer &data)
+{
+    return crypt::sha::hmac512(key, data);
+}
+
+ByteBuffer Encryptor::hmac384(const ByteBuffer &key, const ByteBuffer &data)
+{
+    return crypt::sha::hmac384(key, data);
+}
+
 ByteBuffer Encryptor::hkdf256(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len)
 {
     return crypt::sha::hkdf256(key, seed, info, len);
 }
 
+bool Encryptor::hkdf256(std::span<const uint8_t> key,
+                        std::span<const uint8_t> seed,
+                        std::span<const uint8_t> info,
+                        std::span<uint8_t> out)
+{
+    std::array<uint8_t, HkdfSha256::HASH_SIZE> prk = {};
+    HkdfSha256::extract(seed, key, prk);
+    const bool isOk = HkdfSha256(prk).expand(info, out);
+    mem_wipe(prk.data(), prk.size());
+    return isOk;
+}
+
 ByteBuffer Encryptor::hkdf256Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
 {
     return crypt::sha::hkdf256Expand(prk, info, len);
 }
 
+bool Encryptor::hkdf256Expand(std::span<const uint8_t> prk, std::span<const uint8_t> info, std::span<uint8_t> out)
+{
+    return HkdfSha256(prk).expand(info, out);
+}
+
 ByteBuffer Encryptor::hkdf256ExpandLabel(const ByteBuffer &prk, const std::string &label, const ByteBuffer &hash, size_t len)
 {
-    prk.resetRead();
-    hash.resetRead();
+    ByteBuffer okm(len);
+    const HkdfSha256 hkdf(std::span<const uint8_t>(prk.data(), prk.size()));
+    const std::span<const uint8_t> context(hash.data(), hash.size());
+    if (!hkdf.expandLabel(label, context, std::span<uint8_t>(okm.data(), len))) {
+        return {};
+    }
+    okm.skipWrite(len);
+    return okm;
+}
 
-    ByteBuffer info(3u + label.size() + 1u + hash.size());
-    info.write(uint8_t(0));
-    info.write(uint8_t(len));
-    info.write(uint8_t(label.size()));
-    info.writeString(label);
-    info.write(uint8_t(hash.size()));
-    hash.readToByteBuffer(info, hash.size());
-    return crypt::sha::hkdf256Expand(prk, info, len);
+bool Encryptor::hkdf256ExpandLabel(std::span<const uint8_t> prk,
+                                   std::string_view label,
+                                   std::span<const uint8_t> hash,
+                                   std::span<uint8_t> out)
+{
+    return HkdfSha256(prk).expandLabel(label, hash, out);
 }
 
-ByteBuffer Encryptor::generateSessionKey()
+ByteBuffer Encryptor::hkdf512(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len)
 {
-    using namespace std::chrono;
-
-    auto timePoint = high_resolution_clock::now();
-    auto inMicroSec = duration_cast<microseconds>(timePoint.time_since_epoch());
-    uint32_t rand1 = static_cast<uint32_t>(inMicroSec.count());
-    srand(rand1);
-    uint16_t rand2 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand3 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand4 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand5 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand6 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand7 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand8 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand9 = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t randa = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t randb = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t randc = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t randd = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rande = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t randf = static_cast<uint16_t>(rand() % 0xffff);
-    uint16_t rand0 = static_cast<uint16_t>(rand() % 0xffff);
+    return crypt::sha::hkdf512(key, seed, info, len);
+}
 
-    ByteBuffer sessionKey(32u);
-    sessionKey.write(rand1);
-    sessionKey.write(rand2);
-    sessionKey.write(rand3);
-    sessionKey.write(rand4);
-    sessionKey.write(rand5);
-    sessionKey.write(rand6);
-    sessionKey.write(rand7);
-    sessionKey.write(rand8);
-    sessionKey.write(rand9);
-    sessionKey.write(randa);
-    sessionKey.write(randb);
-    sessionKey.write(randc);
-    sessionKey.write(randd);
-    sessionKey.write(rande);
-    sessionKey.write(randf);
-    sessionKey.write(rand0);
+ByteBuffer Encryptor::hkdf512Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
+{
+    return crypt::sha::hkdf512Expand(prk, info, len);
+}
 
+ByteBuffer Encryptor::hkdf384(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len)
+{
+    return crypt::sha::hkdf384(key, seed, info, len);
+}
+
+ByteBuffer Encryptor::hkdf384Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
+{
+    return crypt::sha::hkdf384Expand(prk, info, len);
+}
+
+ByteBuffer Encryptor::hkdf384ExpandLabel(const ByteBuffer &prk, const std::string &label, const ByteBuffer &hash, size_t len)
+{
+    ByteBuffer okm(len);
+    const HkdfSha384 hkdf(std::span<const uint8_t>(prk.data(), prk.size()));
+    const std::span<const uint8_t> context(hash.data(), hash.size());
+    if (!hkdf.expandLabel(label, context, std::span<uint8_t>(okm.data(), len))) {
+        return {};
+    }
+    okm.skipWrite(len);
+    return okm;
+}
+
+ByteBuffer Encryptor::generateSessionKey()
+{
+    ByteBuffer sessionKey(32u);
+    if (!crypt::csprng::fill(sessionKey.data(), sessionKey.size())) {
+        return {};
+    }
+    sessionKey.skipWrite(sessionKey.size());
     return sessionKey;
 }
 
-void Encryptor::x25519_generate_keypair(ByteBuffer &publicKey, ByteBuffer &privateKey)
+ByteBuffer Encryptor::generateIv(size_t len)
+{
+    ByteBuffer iv(len);
+    if (!crypt::csprng::fill(iv.data(), len)) {
+        return {};
+    }
+    iv.skipWrite(len);
+    return iv;
+}
+
+bool Encryptor::generateRandom(std::span<uint8_t> out)
+{
+    return crypt::csprng::fill(out.data(), out.size());
+}
+
+bool Encryptor::x25519_generate_keypair(ByteBuffer &publicKey, ByteBuffer &privateKey)
 {
-    crypt::x25519::generate_keypair(publicKey.data(), privateKey.data());
+    return crypt::x25519::generate_keypair(publicKey.data(), privateKey.data());
 }
 
 ByteBuffer Encryptor::x25519_scalarmult_base(const ByteBuffer &privateKey)
@@ -0,0 +1,17 @@
+#include "psi/tools/GcmBatch.h"
+
+#include "crypt/aes_gcm.h"
+
+namespace psi::tools {
+
+size_t GcmBatch::seal(const AesKey &key, std::span<GcmRecord> records)
+{
+    return crypt::aes_gcm::cryptBatch(key, records, false);
+}
+
+size_t GcmBatch::open(const AesKey &key, std::span<GcmRecord> records)
+{
+    return crypt::aes_gcm::cryptBatch(key, records, true);
+}
+
+} // namespace psi::tools
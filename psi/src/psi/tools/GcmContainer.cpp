@@ -0,0 +1,453 @@
+#include "psi/tools/GcmContainer.h"
+
+#include "crypt/aes_gcm.h"
+#include "crypt/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace psi::tools {
+
+/**
+ * @brief Read-only memory mapping of whole file.
+ *
+ */
+class MappedFile final
+{
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0u;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &path)
+{
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        return;
+    }
+
+    m_data = static_cast<const uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data) {
+        m_size = size_t(size.QuadPart);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *addr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            m_data = static_cast<const uint8_t *>(addr);
+            m_size = size_t(st.st_size);
+        }
+    }
+
+    // mapping stays valid after descriptor is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data) {
+        munmap(const_cast<uint8_t *>(m_data), m_size);
+    }
+}
+
+#endif
+
+namespace {
+
+constexpr size_t AAD_SIZE = 21u;
+
+void storeLe32(uint8_t *p, size_t offset, uint32_t value)
+{
+    for (size_t i = 0; i < 4u; ++i) {
+        *shift_ptr(p, offset + i) = uint8_t(value >> (i * 8u));
+    }
+}
+
+void storeLe64(uint8_t *p, size_t offset, uint64_t value)
+{
+    for (size_t i = 0; i < 8u; ++i) {
+        *shift_ptr(p, offset + i) = uint8_t(value >> (i * 8u));
+    }
+}
+
+uint32_t loadLe32(const uint8_t *p, size_t offset)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4u; ++i) {
+        value |= uint32_t(*shift_ptr(p, offset + i)) << (i * 8u);
+    }
+    return value;
+}
+
+uint64_t loadLe64(const uint8_t *p, size_t offset)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8u; ++i) {
+        value |= uint64_t(*shift_ptr(p, offset + i)) << (i * 8u);
+    }
+    return value;
+}
+
+void makeIv(const GcmContainerFormat::Nonce &nonce, uint64_t index, uint8_t (&iv)[12u])
+{
+    mem_copy(iv, 0, nonce.data(), 0, 8u);
+    iv[8] = uint8_t(index >> 24);
+    iv[9] = uint8_t(index >> 16);
+    iv[10] = uint8_t(index >> 8);
+    iv[11] = uint8_t(index);
+}
+
+void makeAad(const GcmContainerFormat::Nonce &nonce, uint32_t chunkSize, bool isLast, uint8_t (&aad)[AAD_SIZE])
+{
+    mem_copy(aad, 0, GcmContainerFormat::MAGIC.data(), 0, 8u);
+    storeLe32(aad, 8u, chunkSize);
+    mem_copy(aad, 12u, nonce.data(), 0, 8u);
+    aad[20] = isLast ? 1u : 0u;
+}
+
+} // namespace
+
+GcmContainerWriter::GcmContainerWriter(const std::string &path,
+                                       const AesKey &key,
+                                       const GcmContainerFormat::Nonce &nonce,
+                                       uint32_t chunkSize)
+    : m_file(path, std::ios::binary | std::ios::trunc)
+    , m_key(key)
+    , m_nonce(nonce)
+    , m_chunkSize(chunkSize)
+{
+    if (!m_file || !m_key.isValid() || m_chunkSize == 0u) {
+        return;
+    }
+
+    // header is written when all sizes are known
+    const std::array<char, GcmContainerFormat::HEADER_SIZE> header = {};
+    m_file.write(header.data(), header.size());
+    m_fileOffset = GcmContainerFormat::HEADER_SIZE;
+    m_chunk.reserve(m_chunkSize);
+    m_isValid = bool(m_file);
+}
+
+GcmContainerWriter::~GcmContainerWriter()
+{
+    if (m_isValid) {
+        finish();
+    }
+    mem_wipe(m_chunk.data(), m_chunk.size());
+}
+
+bool GcmContainerWriter::isValid() const
+{
+    return m_isValid;
+}
+
+bool GcmContainerWriter::write(std::span<const uint8_t> data)
+{
+    if (!m_isValid) {
+        return false;
+    }
+
+    size_t offset = 0;
+    while (offset < data.size()) {
+        // full chunk is sealed only when more data arrives, so the last one is known on finish()
+        if (m_chunk.size() == m_chunkSize && !sealChunk(false)) {
+            return false;
+        }
+        const size_t sz = std::min(data.size() - offset, size_t(m_chunkSize) - m_chunk.size());
+        m_chunk.insert(m_chunk.end(), data.begin() + ptrdiff_t(offset), data.begin() + ptrdiff_t(offset + sz));
+        offset += sz;
+    }
+
+    m_plainSize += data.size();
+    return true;
+}
+
+bool GcmContainerWriter::write(const ByteBuffer &data)
+{
+    return write(std::span(data.data(), data.size()));
+}
+
+bool GcmContainerWriter::finish()
+{
+    if (!m_isValid || !sealChunk(true)) {
+        m_isValid = false;
+        return false;
+    }
+    m_isValid = false;
+
+    const uint64_t indexOffset = m_fileOffset;
+    std::vector<uint8_t> index(m_offsets.size() * 8u);
+    for (size_t i = 0; i < m_offsets.size(); ++i) {
+        storeLe64(index.data(), i * 8u, m_offsets[i]);
+    }
+    m_file.write(reinterpret_cast<const char *>(index.data()), std::streamsize(index.size()));
+
+    std::array<uint8_t, GcmContainerFormat::HEADER_SIZE> header = {};
+    mem_copy(header.data(), 0, GcmContainerFormat::MAGIC.data(), 0, 8u);
+    storeLe32(header.data(), 8u, m_chunkSize);
+    mem_copy(header.data(), 16u, m_nonce.data(), 0, 8u);
+    storeLe64(header.data(), 24u, m_plainSize);
+    storeLe64(header.data(), 32u, m_offsets.size());
+    storeLe64(header.data(), 40u, indexOffset);
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char *>(header.data()), std::streamsize(header.size()));
+    m_file.close();
+
+    return !m_file.fail();
+}
+
+bool GcmContainerWriter::sealChunk(bool isLast)
+{
+    if (m_offsets.size() >= GcmContainerFormat::MAX_CHUNKS) {
+        m_isValid = false;
+        return false;
+    }
+
+    uint8_t iv[12u];
+    makeIv(m_nonce, m_offsets.size(), iv);
+    uint8_t aad[AAD_SIZE];
+    makeAad(m_nonce, m_chunkSize, isLast, aad);
+
+    const size_t len = m_chunk.size();
+    m_sealed.resize(len + GcmContainerFormat::TAG_SIZE);
+    crypt::aes_gcm::Tag tag = {};
+    crypt::aes_gcm::encrypt(m_chunk.data(), len, m_key, iv, sizeof(iv), aad, sizeof(aad), m_sealed.data(), tag);
+    mem_copy(m_sealed.data(), len, tag.data(), 0, tag.size());
+
+    m_file.write(reinterpret_cast<const char *>(m_sealed.data()), std::streamsize(m_sealed.size()));
+    m_offsets.emplace_back(m_fileOffset);
+    m_fileOffset += m_sealed.size();
+
+    mem_wipe(m_chunk.data(), len);
+    m_chunk.clear();
+
+    if (!m_file) {
+        m_isValid = false;
+        return false;
+    }
+    return true;
+}
+
+GcmContainerReader::GcmContainerReader(const std::string &path, const AesKey &key)
+    : m_file(std::make_unique<MappedFile>(path))
+    , m_key(key)
+{
+    const uint8_t *data = m_file->data();
+    const uint64_t fileSize = m_file->size();
+    if (!m_key.isValid() || fileSize < GcmContainerFormat::HEADER_SIZE
+        || !std::equal(GcmContainerFormat::MAGIC.begin(), GcmContainerFormat::MAGIC.end(), data)) {
+        return;
+    }
+
+    m_chunkSize = loadLe32(data, 8u);
+    mem_copy(m_nonce.data(), 0, data, 16u, 8u);
+    m_plainSize = loadLe64(data, 24u);
+    m_chunkCount = loadLe64(data, 32u);
+    const uint64_t indexOffset = loadLe64(data, 40u);
+
+    if (m_chunkSize == 0u || m_chunkCount == 0u || m_chunkCount > GcmContainerFormat::MAX_CHUNKS) {
+        return;
+    }
+    const uint64_t expectedChunks =
+        std::max<uint64_t>(1u, m_plainSize / m_chunkSize + uint64_t(m_plainSize % m_chunkSize != 0u));
+    if (m_chunkCount != expectedChunks || m_plainSize > m_chunkCount * m_chunkSize
+        || indexOffset < GcmContainerFormat::HEADER_SIZE || indexOffset > fileSize
+        || (fileSize - indexOffset) != m_chunkCount * 8u) {
+        return;
+    }
+
+    m_index = shift_ptr(data, indexOffset);
+    m_isValid = true;
+}
+
+GcmContainerReader::~GcmContainerReader() = default;
+
+bool GcmContainerReader::isValid() const
+{
+    return m_isValid;
+}
+
+uint64_t GcmContainerReader::size() const
+{
+    return m_plainSize;
+}
+
+uint32_t GcmContainerReader::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+uint64_t GcmContainerReader::chunkCount() const
+{
+    return m_chunkCount;
+}
+
+bool GcmContainerReader::read(uint64_t offset, std::span<uint8_t> out) const
+{
+    if (!m_isValid || offset > m_plainSize || m_plainSize - offset < out.size()) {
+        return false;
+    }
+    if (out.empty()) {
+        return true;
+    }
+
+    const uint64_t end = offset + out.size();
+    const uint64_t first = offset / m_chunkSize;
+    const uint64_t last = (end - 1u) / m_chunkSize;
+
+    std::atomic<bool> isOk = true;
+    auto processChunk = [&](size_t j) {
+        const uint64_t index = first + j;
+        const uint64_t chunkBegin = index * m_chunkSize;
+        const size_t chunkLen = size_t(std::min<uint64_t>(m_chunkSize, m_plainSize - chunkBegin));
+        const uint64_t from = std::max(offset, chunkBegin);
+        const uint64_t to = std::min(end, chunkBegin + chunkLen);
+
+        // chunks covered entirely are decrypted directly into output
+        if (from == chunkBegin && to == chunkBegin + chunkLen) {
+            if (!openChunk(index, shift_ptr(out.data(), size_t(chunkBegin - offset)))) {
+                isOk = false;
+            }
+            return;
+        }
+
+        std::vector<uint8_t> chunk(chunkLen);
+        if (!openChunk(index, chunk.data())) {
+            isOk = false;
+            return;
+        }
+        mem_copy(out.data(), size_t(from - offset), chunk.data(), size_t(from - chunkBegin), size_t(to - from));
+        mem_wipe(chunk.data(), chunk.size());
+    };
+
+    const size_t chunks = size_t(last - first + 1u);
+    if (out.size() >= crypt::parallel::THRESHOLD) {
+        crypt::parallel::forEach(chunks, processChunk);
+    } else {
+        for (size_t j = 0; j < chunks && isOk; ++j) {
+            processChunk(j);
+        }
+    }
+
+    if (!isOk) {
+        mem_wipe(out.data(), out.size());
+    }
+    return isOk;
+}
+
+ByteBuffer GcmContainerReader::read(uint64_t offset, size_t len) const
+{
+    ByteBuffer result(len);
+    if (!read(offset, std::span(result.data(), len))) {
+        return {};
+    }
+    result.skipWrite(len);
+    return result;
+}
+
+bool GcmContainerReader::openChunk(uint64_t index, uint8_t *out) const
+{
+    if (index >= m_chunkCount) {
+        return false;
+    }
+
+    const uint64_t chunkBegin = index * m_chunkSize;
+    const size_t chunkLen = size_t(std::min<uint64_t>(m_chunkSize, m_plainSize - chunkBegin));
+    const uint64_t chunkOffset = loadLe64(m_index, size_t(index * 8u));
+    const uint64_t indexOffset = uint64_t(m_index - m_file->data());
+    if (chunkOffset < GcmContainerFormat::HEADER_SIZE || chunkOffset > indexOffset
+        || indexOffset - chunkOffset < chunkLen + GcmContainerFormat::TAG_SIZE) {
+        return false;
+    }
+
+    uint8_t iv[12u];
+    makeIv(m_nonce, index, iv);
+    uint8_t aad[AAD_SIZE];
+    makeAad(m_nonce, m_chunkSize, index + 1u == m_chunkCount, aad);
+
+    const uint8_t *sealed = shift_ptr(m_file->data(), size_t(chunkOffset));
+    return crypt::aes_gcm::decrypt(sealed,
+                                   chunkLen,
+                                   m_key,
+                                   iv,
+                                   sizeof(iv),
+                                   aad,
+                                   sizeof(aad),
+                                   shift_ptr(sealed, chunkLen),
+                                   GcmContainerFormat::TAG_SIZE,
+                                   out);
+}
+
+} // namespace psi::tools
@@ -0,0 +1,220 @@
+#include "psi/tools/GcmStream.h"
+
+#include "crypt/aes.h"
+#include "crypt/aes_gcm.h"
+
+#include <algorithm>
+
+namespace psi::tools {
+
+GcmStream::GcmStream(const AesKey &key, std::span<const uint8_t> iv)
+    : m_key(key)
+    , m_isValid(key.isValid())
+{
+    if (!m_isValid) {
+        return;
+    }
+
+    crypt::aes_gcm::initCounter(m_key, iv.data(), iv.size(), m_counter);
+    crypt::aes::encryptBlock(m_key, m_counter.data(), m_y0Encrypted.data());
+    crypt::aes_gcm::incr(m_counter);
+}
+
+GcmStream::~GcmStream()
+{
+    mem_wipe(m_keyStream.data(), m_keyStream.size());
+}
+
+bool GcmStream::isValid() const
+{
+    return m_isValid;
+}
+
+bool GcmStream::updateAad(std::span<const uint8_t> aad)
+{
+    if (!m_isValid || m_dataLen != 0u) {
+        return false;
+    }
+
+    hash(aad.data(), aad.size());
+    m_aadLen += aad.size();
+    return true;
+}
+
+uint64_t GcmStream::aadLength() const
+{
+    return m_aadLen;
+}
+
+uint64_t GcmStream::dataLength() const
+{
+    return m_dataLen;
+}
+
+bool GcmStream::canProcess(size_t inLen, size_t outLen)
+{
+    if (!m_isValid || outLen < inLen || MAX_DATA_LENGTH - m_dataLen < inLen) {
+        return false;
+    }
+
+    // additional data is padded with zeroes before the first payload block
+    if (m_dataLen == 0u && inLen != 0u) {
+        flushHash();
+    }
+
+    return true;
+}
+
+void GcmStream::applyKeyStream(const uint8_t *in, uint8_t *out, size_t len)
+{
+    size_t offset = 0;
+
+    // rest of key stream left from previous chunk
+    for (; offset < len && m_keyStreamPos < 16u; ++offset, ++m_keyStreamPos) {
+        *shift_ptr(out, offset) = *shift_ptr(in, offset) ^ m_keyStream[m_keyStreamPos];
+    }
+
+    const size_t fullLen = (len - offset) & ~size_t(15u);
+    crypt::aes::ctr32Xor(m_key, m_counter.data(), shift_ptr(in, offset), shift_ptr(out, offset), fullLen);
+    offset += fullLen;
+
+    if (offset < len) {
+        m_keyStream = {};
+        crypt::aes::ctr32Xor(m_key, m_counter.data(), m_keyStream.data(), m_keyStream.data(), 16u);
+        for (m_keyStreamPos = 0; offset < len; ++offset, ++m_keyStreamPos) {
+            *shift_ptr(out, offset) = *shift_ptr(in, offset) ^ m_keyStream[m_keyStreamPos];
+        }
+    }
+
+    m_dataLen += len;
+}
+
+void GcmStream::hash(const uint8_t *data, size_t len)
+{
+    size_t offset = 0;
+
+    if (m_hashBufferLen != 0u) {
+        const size_t sz = std::min(len, 16u - m_hashBufferLen);
+        mem_copy(m_hashBuffer.data(), m_hashBufferLen, data, 0, sz);
+        m_hashBufferLen += sz;
+        offset += sz;
+        if (m_hashBufferLen != 16u) {
+            return;
+        }
+        crypt::aes_gcm::ghashBlock(m_key, m_hashBuffer.data(), 16u, m_hash);
+        m_hashBufferLen = 0u;
+    }
+
+    const size_t fullLen = (len - offset) & ~size_t(15u);
+    if (fullLen) {
+        crypt::aes_gcm::ghashBlock(m_key, shift_ptr(data, offset), fullLen, m_hash);
+        offset += fullLen;
+    }
+
+    if (offset < len) {
+        m_hashBufferLen = len - offset;
+        mem_copy(m_hashBuffer.data(), 0, data, offset, m_hashBufferLen);
+    }
+}
+
+void GcmStream::flushHash()
+{
+    if (m_hashBufferLen != 0u) {
+        // ghashBlock pads partial block with zeroes
+        crypt::aes_gcm::ghashBlock(m_key, m_hashBuffer.data(), m_hashBufferLen, m_hash);
+        m_hashBufferLen = 0u;
+    }
+}
+
+// T: GHASH(H,A,C) XOR E(K, Y[0])
+void GcmStream::computeTag(Tag &tag)
+{
+    flushHash();
+
+    crypt::aes_gcm::DataBlock16 lengthBlock = {};
+    crypt::aes_gcm::encodeLengths(m_aadLen, m_dataLen, lengthBlock);
+    crypt::aes_gcm::ghashBlock(m_key, lengthBlock.data(), 16u, m_hash);
+    crypt::aes_gcm::xorBlocks(m_hash, m_y0Encrypted, tag);
+
+    // unused rest of key stream block is not needed anymore
+    mem_wipe(m_keyStream.data(), m_keyStream.size());
+    m_keyStreamPos = 16u;
+    m_isValid = false;
+}
+
+GcmEncryptor::GcmEncryptor(const AesKey &key, std::span<const uint8_t> iv)
+    : GcmStream(key, iv)
+{
+}
+
+bool GcmEncryptor::update(std::span<const uint8_t> in, std::span<uint8_t> out)
+{
+    if (!canProcess(in.size(), out.size())) {
+        return false;
+    }
+
+    applyKeyStream(in.data(), out.data(), in.size());
+    hash(out.data(), in.size());
+    return true;
+}
+
+ByteBuffer GcmEncryptor::update(const ByteBuffer &data)
+{
+    ByteBuffer out(data.length());
+    if (!update(std::span(data.data(), data.length()), std::span(out.data(), out.size()))) {
+        return {};
+    }
+    out.skipWrite(data.length());
+    return out;
+}
+
+bool GcmEncryptor::final(Tag &tag)
+{
+    if (!isValid()) {
+        return false;
+    }
+
+    computeTag(tag);
+    return true;
+}
+
+GcmDecryptor::GcmDecryptor(const AesKey &key, std::span<const uint8_t> iv)
+    : GcmStream(key, iv)
+{
+}
+
+bool GcmDecryptor::update(std::span<const uint8_t> in, std::span<uint8_t> out)
+{
+    if (!canProcess(in.size(), out.size())) {
+        return false;
+    }
+
+    // cipher text is authenticated before it might be overwritten by in-place decryption
+    hash(in.data(), in.size());
+    applyKeyStream(in.data(), out.data(), in.size());
+    return true;
+}
+
+ByteBuffer GcmDecryptor::update(const ByteBuffer &data)
+{
+    ByteBuffer out(data.length());
+    if (!update(std::span(data.data(), data.length()), std::span(out.data(), out.size()))) {
+        return {};
+    }
+    out.skipWrite(data.length());
+    return out;
+}
+
+bool GcmDecryptor::final(std::span<const uint8_t> tag)
+{
+    Tag computed = {};
+    if (!isValid() || tag.size() != computed.size()) {
+        return false;
+    }
+
+    computeTag(computed);
+
+    return mem_equal_ct(computed.data(), tag.data(), computed.size());
+}
+
+} // namespace psi::tools
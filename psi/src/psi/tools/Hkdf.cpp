@@ -0,0 +1,78 @@
+#include "psi/tools/Hkdf.h"
+
+#include <algorithm>
+
+namespace psi::tools {
+
+template <typename Hash>
+Hkdf<Hash>::Hkdf(std::span<const uint8_t> prk)
+    : m_key(prk.data(), prk.size())
+{
+}
+
+template <typename Hash>
+bool Hkdf<Hash>::extract(std::span<const uint8_t> salt, std::span<const uint8_t> ikm, std::span<uint8_t> prk)
+{
+    return HmacKey<Hash>(salt.data(), salt.size()).mac(ikm, prk);
+}
+
+template <typename Hash>
+bool Hkdf<Hash>::expand(std::span<const uint8_t> info, std::span<uint8_t> out) const
+{
+    const std::span<const uint8_t> parts[] = {info};
+    return expandParts(parts, out);
+}
+
+template <typename Hash>
+bool Hkdf<Hash>::expandLabel(std::string_view label, std::span<const uint8_t> context, std::span<uint8_t> out) const
+{
+    if (label.size() > 255u || context.size() > 255u || out.size() > MAX_OUTPUT_SIZE) {
+        return false;
+    }
+
+    // struct { uint16 length; opaque label<7..255>; opaque context<0..255>; } HkdfLabel
+    const uint8_t header[3] = {uint8_t(out.size() >> 8), uint8_t(out.size()), uint8_t(label.size())};
+    const uint8_t contextLen = uint8_t(context.size());
+    const std::span<const uint8_t> parts[] = {
+        header,
+        std::span(reinterpret_cast<const uint8_t *>(label.data()), label.size()),
+        std::span(&contextLen, 1u),
+        context,
+    };
+    return expandParts(parts, out);
+}
+
+template <typename Hash>
+bool Hkdf<Hash>::expandParts(std::span<const std::span<const uint8_t>> info, std::span<uint8_t> out) const
+{
+    if (out.size() > MAX_OUTPUT_SIZE) {
+        return false;
+    }
+
+    // T(i) = HMAC(PRK, T(i - 1) | info | i)
+    typename HmacKey<Hash>::Digest t = {};
+    size_t tLen = 0u;
+    uint8_t counter = 1u;
+    for (size_t offset = 0; offset < out.size(); offset += HASH_SIZE) {
+        auto inner = m_key.begin();
+        inner.update(std::span(t).first(tLen));
+        for (const auto &part : info) {
+            inner.update(part);
+        }
+        inner.update(std::span(&counter, 1u));
+        m_key.finish(inner, t);
+        tLen = HASH_SIZE;
+        ++counter;
+
+        mem_copy(out.data(), offset, t.data(), 0, std::min(HASH_SIZE, out.size() - offset));
+    }
+
+    mem_wipe(t.data(), t.size());
+    return true;
+}
+
+template class Hkdf<Sha256>;
+template class Hkdf<Sha384>;
+template class Hkdf<Sha512>;
+
+} // namespace psi::tools
@@ -0,0 +1,112 @@
+#include "psi/tools/HmacKey.h"
+
+namespace psi::tools {
+
+template <typename Hash>
+HmacKey<Hash>::HmacKey()
+    : HmacKey(nullptr, 0u)
+{
+}
+
+template <typename Hash>
+HmacKey<Hash>::HmacKey(const ByteBuffer &key)
+    : HmacKey(key.data(), key.size())
+{
+}
+
+template <typename Hash>
+HmacKey<Hash>::HmacKey(const uint8_t *key, size_t keyLen)
+{
+    uint8_t block[Hash::BLOCK_SIZE] = {};
+    if (keyLen > Hash::BLOCK_SIZE) {
+        Hash h;
+        h.update(std::span<const uint8_t>(key, keyLen));
+        h.final(std::span<uint8_t>(block, Hash::DIGEST_SIZE));
+    } else if (keyLen) {
+        mem_copy(block, 0, key, 0, keyLen);
+    }
+
+    for (size_t i = 0; i < Hash::BLOCK_SIZE; ++i) {
+        block[i] ^= 0x36u;
+    }
+    m_inner.update(block);
+
+    // 0x36 ^ 0x5c turns inner pad into outer pad
+    for (size_t i = 0; i < Hash::BLOCK_SIZE; ++i) {
+        block[i] ^= 0x36u ^ 0x5cu;
+    }
+    m_outer.update(block);
+
+    mem_wipe(block, sizeof(block));
+}
+
+template <typename Hash>
+typename HmacKey<Hash>::Digest HmacKey<Hash>::mac(std::span<const uint8_t> data) const
+{
+    Digest result = {};
+    mac(data, result);
+    return result;
+}
+
+template <typename Hash>
+ByteBuffer HmacKey<Hash>::mac(const ByteBuffer &data) const
+{
+    ByteBuffer result(DIGEST_SIZE);
+    mac(std::span<const uint8_t>(data.data(), data.size()), std::span<uint8_t>(result.data(), result.size()));
+    result.skipWrite(DIGEST_SIZE);
+    return result;
+}
+
+template <typename Hash>
+bool HmacKey<Hash>::mac(std::span<const uint8_t> data, std::span<uint8_t> out) const
+{
+    if (out.size() < DIGEST_SIZE) {
+        return false;
+    }
+
+    // whole blocks are hashed directly from message
+    Hash inner = m_inner;
+    inner.update(data);
+    return finish(inner, out);
+}
+
+template <typename Hash>
+bool HmacKey<Hash>::verify(std::span<const uint8_t> data, std::span<const uint8_t> tag) const
+{
+    if (tag.size() != DIGEST_SIZE) {
+        return false;
+    }
+
+    Digest expected = {};
+    mac(data, expected);
+    const bool isEqual = mem_equal_ct(expected.data(), tag.data(), expected.size());
+    mem_wipe(expected.data(), expected.size());
+    return isEqual;
+}
+
+template <typename Hash>
+Hash HmacKey<Hash>::begin() const
+{
+    return m_inner;
+}
+
+template <typename Hash>
+bool HmacKey<Hash>::finish(Hash &inner, std::span<uint8_t> out) const
+{
+    if (out.size() < DIGEST_SIZE) {
+        return false;
+    }
+
+    Digest innerDigest = inner.final();
+    Hash outer = m_outer;
+    outer.update(innerDigest);
+    outer.final(out);
+    mem_wipe(innerDigest.data(), innerDigest.size());
+    return true;
+}
+
+template class HmacKey<Sha256>;
+template class HmacKey<Sha384>;
+template class HmacKey<Sha512>;
+
+} // namespace psi::tools
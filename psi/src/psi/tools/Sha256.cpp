@@ -0,0 +1,62 @@
+#include "psi/tools/Sha256.h"
+
+#include "crypt/sha.h"
+
+namespace psi::tools {
+
+Sha256::Sha256()
+{
+    reset();
+}
+
+void Sha256::reset()
+{
+    m_block.reset(crypt::sha::hashInit);
+}
+
+void Sha256::update(std::span<const uint8_t> data)
+{
+    m_block.update<crypt::sha::compress256>(data);
+}
+
+void Sha256::update(const ByteBuffer &data)
+{
+    update(std::span<const uint8_t>(data.data(), data.size()));
+}
+
+Sha256::Digest Sha256::final()
+{
+    Digest result = {};
+    final(result);
+    return result;
+}
+
+bool Sha256::final(std::span<uint8_t> out)
+{
+    if (out.size() < DIGEST_SIZE) {
+        return false;
+    }
+
+    m_block.final(crypt::sha::finish256, out.data());
+    reset();
+    return true;
+}
+
+uint64_t Sha256::length() const
+{
+    return m_block.length();
+}
+
+Sha256::Digest Sha256::hash(std::span<const uint8_t> data)
+{
+    Digest result = {};
+    crypt::sha::encode256(data.data(), data.size(), result.data());
+    return result;
+}
+
+bool Sha256::hashBatch(std::span<const std::span<const uint8_t>> messages, std::span<Digest> digests)
+{
+    return crypt::sha::encode256Batch(messages, digests);
+}
+
+} // namespace psi::tools
@@ -0,0 +1,107 @@
+#include "psi/tools/Sha512.h"
+
+#include "crypt/sha.h"
+
+namespace psi::tools {
+
+Sha512::Sha512()
+{
+    reset();
+}
+
+Sha512::Sha512(size_t digestSize)
+    : m_digestSize(digestSize)
+{
+    reset();
+}
+
+void Sha512::reset()
+{
+    m_block.reset(m_digestSize == Sha384::DIGEST_SIZE ? crypt::sha::hashInit384 : crypt::sha::hashInit512);
+}
+
+void Sha512::update(std::span<const uint8_t> data)
+{
+    m_block.update<crypt::sha::compress512>(data);
+}
+
+void Sha512::update(const ByteBuffer &data)
+{
+    update(std::span<const uint8_t>(data.data(), data.size()));
+}
+
+Sha512::Digest Sha512::final()
+{
+    Digest result = {};
+    final(result);
+    return result;
+}
+
+bool Sha512::final(std::span<uint8_t> out)
+{
+    if (out.size() < m_digestSize) {
+        return false;
+    }
+
+    m_block.final(crypt::sha::finish512, out.data(), m_digestSize);
+    reset();
+    return true;
+}
+
+uint64_t Sha512::length() const
+{
+    return m_block.length();
+}
+
+Sha512::Digest Sha512::hash(std::span<const uint8_t> data)
+{
+    Digest result = {};
+    crypt::sha::encode512(data.data(), data.size(), result.data());
+    return result;
+}
+
+Sha384::Sha384()
+    : m_hash(DIGEST_SIZE)
+{
+}
+
+void Sha384::reset()
+{
+    m_hash.reset();
+}
+
+void Sha384::update(std::span<const uint8_t> data)
+{
+    m_hash.update(data);
+}
+
+void Sha384::update(const ByteBuffer &data)
+{
+    m_hash.update(data);
+}
+
+Sha384::Digest Sha384::final()
+{
+    Digest result = {};
+    m_hash.final(result);
+    return result;
+}
+
+bool Sha384::final(std::span<uint8_t> out)
+{
+    return m_hash.final(out);
+}
+
+uint64_t Sha384::length() const
+{
+    return m_hash.length();
+}
+
+Sha384::Digest Sha384::hash(std::span<const uint8_t> data)
+{
+    Digest result = {};
+    crypt::sha::encode384(data.data(), data.size(), result.data());
+    return result;
+}
+
+} // namespace psi::tools
@@ -0,0 +1,160 @@
+#include "psi/tools/Tls13KeySchedule.h"
+
+namespace psi::tools {
+
+namespace {
+
+// SHA-256 of empty string, context of "derived" secrets
+constexpr uint8_t EMPTY_HASH[Tls13KeySchedule::HASH_SIZE] = {
+    0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+    0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55};
+
+// missing PSK or (EC)DHE input is replaced by string of zeros
+constexpr uint8_t ZEROS[Tls13KeySchedule::HASH_SIZE] = {};
+
+} // namespace
+
+Tls13KeySchedule::Tls13KeySchedule(std::span<const uint8_t> psk)
+{
+    HkdfSha256::extract({}, psk.empty() ? std::span<const uint8_t>(ZEROS) : psk, m_secret);
+    m_hkdf = HkdfSha256(m_secret);
+}
+
+Tls13KeySchedule::~Tls13KeySchedule()
+{
+    mem_wipe(m_secret.data(), m_secret.size());
+}
+
+Tls13KeySchedule::Stage Tls13KeySchedule::stage() const
+{
+    return m_stage;
+}
+
+const Tls13KeySchedule::Secret &Tls13KeySchedule::secret() const
+{
+    return m_secret;
+}
+
+bool Tls13KeySchedule::deriveHandshake(std::span<const uint8_t> sharedSecret)
+{
+    if (m_stage != Stage::Early) {
+        return false;
+    }
+
+    advance(sharedSecret.empty() ? std::span<const uint8_t>(ZEROS) : sharedSecret);
+    m_stage = Stage::Handshake;
+    return true;
+}
+
+bool Tls13KeySchedule::deriveMaster()
+{
+    if (m_stage != Stage::Handshake) {
+        return false;
+    }
+
+    advance(ZEROS);
+    m_stage = Stage::Master;
+    return true;
+}
+
+bool Tls13KeySchedule::binderKey(bool external, std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Early, external ? "tls13 ext binder" : "tls13 res binder", EMPTY_HASH, out);
+}
+
+bool Tls13KeySchedule::clientEarlyTrafficSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Early, "tls13 c e traffic", helloHash, out);
+}
+
+bool Tls13KeySchedule::earlyExporterMasterSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Early, "tls13 e exp master", helloHash, out);
+}
+
+bool Tls13KeySchedule::clientHandshakeTrafficSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Handshake, "tls13 c hs traffic", helloHash, out);
+}
+
+bool Tls13KeySchedule::serverHandshakeTrafficSecret(std::span<const uint8_t> helloHash, std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Handshake, "tls13 s hs traffic", helloHash, out);
+}
+
+bool Tls13KeySchedule::clientApplicationTrafficSecret(std::span<const uint8_t> handshakeHash,
+                                                      std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Master, "tls13 c ap traffic", handshakeHash, out);
+}
+
+bool Tls13KeySchedule::serverApplicationTrafficSecret(std::span<const uint8_t> handshakeHash,
+                                                      std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Master, "tls13 s ap traffic", handshakeHash, out);
+}
+
+bool Tls13KeySchedule::exporterMasterSecret(std::span<const uint8_t> handshakeHash, std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Master, "tls13 exp master", handshakeHash, out);
+}
+
+bool Tls13KeySchedule::resumptionMasterSecret(std::span<const uint8_t> handshakeHash, std::span<uint8_t> out) const
+{
+    return deriveSecret(Stage::Master, "tls13 res master", handshakeHash, out);
+}
+
+bool Tls13KeySchedule::trafficKeys(std::span<const uint8_t> secret, std::span<uint8_t> key, std::span<uint8_t> iv)
+{
+    if (secret.size() != HASH_SIZE || (key.size() != 16u && key.size() != 32u) || iv.size() != IV_SIZE) {
+        return false;
+    }
+
+    const HkdfSha256 hkdf(secret);
+    return hkdf.expandLabel("tls13 key", {}, key) && hkdf.expandLabel("tls13 iv", {}, iv);
+}
+
+bool Tls13KeySchedule::finishedKey(std::span<const uint8_t> secret, std::span<uint8_t> out)
+{
+    return expandSecret(secret, "tls13 finished", out);
+}
+
+bool Tls13KeySchedule::nextTrafficSecret(std::span<const uint8_t> secret, std::span<uint8_t> out)
+{
+    return expandSecret(secret, "tls13 traffic upd", out);
+}
+
+bool Tls13KeySchedule::deriveSecret(Stage stage,
+                                    std::string_view label,
+                                    std::span<const uint8_t> hash,
+                                    std::span<uint8_t> out) const
+{
+    if (m_stage != stage || hash.size() != HASH_SIZE || out.size() < HASH_SIZE) {
+        return false;
+    }
+
+    return m_hkdf.expandLabel(label, hash, out.first(HASH_SIZE));
+}
+
+bool Tls13KeySchedule::expandSecret(std::span<const uint8_t> secret, std::string_view label, std::span<uint8_t> out)
+{
+    if (secret.size() != HASH_SIZE || out.size() < HASH_SIZE) {
+        return false;
+    }
+
+    // HMAC context is prepared before output is written, so secret and out might overlap
+    const HkdfSha256 hkdf(secret);
+    return hkdf.expandLabel(label, {}, out.first(HASH_SIZE));
+}
+
+void Tls13KeySchedule::advance(std::span<const uint8_t> ikm)
+{
+    // Derive-Secret(secret, "derived", "") is salt of next stage
+    Secret derived = {};
+    m_hkdf.expandLabel("tls13 derived", EMPTY_HASH, derived);
+    HkdfSha256::extract(derived, ikm, m_secret);
+    m_hkdf = HkdfSha256(m_secret);
+    mem_wipe(derived.data(), derived.size());
+}
+
+} // namespace psi::tools
@@ -0,0 +1,58 @@
+#include "psi/tools/XtsCipher.h"
+
+#include "crypt/aes_xts.h"
+
+namespace psi::tools {
+
+XtsCipher::XtsCipher(const ByteBuffer &key)
+    : XtsCipher(key.data(), key.size())
+{
+}
+
+XtsCipher::XtsCipher(const uint8_t *key, size_t keyLen)
+{
+    if (keyLen != 32u && keyLen != 64u) {
+        return;
+    }
+
+    // equal halves turn XTS into ECB-like mode for some sectors, such keys are rejected
+    const size_t halfLen = keyLen / 2u;
+    if (mem_equal_ct(key, shift_ptr(key, halfLen), halfLen)) {
+        return;
+    }
+
+    m_dataKey = AesKey(key, halfLen);
+    m_tweakKey = AesKey(shift_ptr(key, halfLen), halfLen);
+}
+
+bool XtsCipher::isValid() const
+{
+    return m_dataKey.isValid() && m_tweakKey.isValid();
+}
+
+bool XtsCipher::encrypt(std::span<uint8_t> data, size_t sectorSize, uint64_t firstSector) const
+{
+    if (!canProcess(data.size(), sectorSize)) {
+        return false;
+    }
+
+    crypt::aes_xts::cryptSectors(m_dataKey, m_tweakKey, firstSector, data.data(), data.size(), sectorSize, false);
+    return true;
+}
+
+bool XtsCipher::decrypt(std::span<uint8_t> data, size_t sectorSize, uint64_t firstSector) const
+{
+    if (!canProcess(data.size(), sectorSize)) {
+        return false;
+    }
+
+    crypt::aes_xts::cryptSectors(m_dataKey, m_tweakKey, firstSector, data.data(), data.size(), sectorSize, true);
+    return true;
+}
+
+bool XtsCipher::canProcess(size_t len, size_t sectorSize) const
+{
+    return isValid() && sectorSize >= 16u && len % sectorSize == 0u;
+}
+
+} // namespace psi::tools
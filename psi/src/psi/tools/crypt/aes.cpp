@@ -8,10 +8,30 @@ template ByteBuffer aes::encryptAes_impl<4u, 10u>(const ByteBuffer &, const Byte
 template ByteBuffer aes::encryptAes_impl<4u, 10u>(const uint8_t *, size_t dataLen, const ByteBuffer &);
 template ByteBuffer aes::decryptAes_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &);
 template ByteBuffer aes::decryptAes_impl<4u, 10u>(const uint8_t *, size_t dataLen, const ByteBuffer &);
+template ByteBuffer aes::encryptAes_impl<4u, 10u>(const ByteBuffer &, const AesKey &);
+template ByteBuffer aes::encryptAes_impl<4u, 10u>(const uint8_t *, size_t dataLen, const AesKey &);
+template ByteBuffer aes::decryptAes_impl<4u, 10u>(const ByteBuffer &, const AesKey &);
+template ByteBuffer aes::decryptAes_impl<4u, 10u>(const uint8_t *, size_t dataLen, const AesKey &);
 template void aes::generateSubKeys_impl<4u, 10u>(uint8_t[4u * 4u], aes::SubKeys<10u + 1u>&);
+template ByteBuffer aes::encryptCbc_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+template ByteBuffer aes::encryptCbc_impl<4u, 10u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+template ByteBuffer aes::decryptCbc_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+template ByteBuffer aes::decryptCbc_impl<4u, 10u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+template ByteBuffer aes::cryptCtr_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+template ByteBuffer aes::cryptCtr_impl<4u, 10u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
 // AES-256
 template ByteBuffer aes::encryptAes_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &);
 template ByteBuffer aes::decryptAes_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &);
+template ByteBuffer aes::encryptAes_impl<8u, 14u>(const ByteBuffer &, const AesKey &);
+template ByteBuffer aes::encryptAes_impl<8u, 14u>(const uint8_t *, size_t dataLen, const AesKey &);
+template ByteBuffer aes::decryptAes_impl<8u, 14u>(const ByteBuffer &, const AesKey &);
+template ByteBuffer aes::decryptAes_impl<8u, 14u>(const uint8_t *, size_t dataLen, const AesKey &);
 template void aes::generateSubKeys_impl<8u, 14u>(uint8_t[8u * 4u], aes::SubKeys<14u + 1u>&);
+template ByteBuffer aes::encryptCbc_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+template ByteBuffer aes::encryptCbc_impl<8u, 14u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+template ByteBuffer aes::decryptCbc_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+template ByteBuffer aes::decryptCbc_impl<8u, 14u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+template ByteBuffer aes::cryptCtr_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+template ByteBuffer aes::cryptCtr_impl<8u, 14u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
 
 } // namespace psi::tools::crypt
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "psi/tools/AesKey.h"
 #include "psi/tools/ByteBuffer.h"
 
 #include <array>
@@ -15,6 +16,14 @@ public:
     template <size_t N>
     using SubKeys = std::array<SubKey, N>;
 
+    enum class Backend : uint8_t
+    {
+        Portable,
+        TTable,
+        Bitsliced,
+        AesNi
+    };
+
     static const std::array<uint8_t, 256u> m_sBox;
     static const std::array<uint8_t, 256u> m_iBox;
     static const std::array<uint8_t, 10u> m_rCon;
@@ -34,6 +43,23 @@ public:
     static void doRoundKeyEncode(const SubKey &key, DataBlock16 &block, bool isFinal = false);
     static void doRoundKeyDecode(const SubKey &key, DataBlock16 &block, bool isFinal = false);
 
+    static Backend backend();
+    static Backend ctrBackend();
+    static void expandKey(const uint8_t *key, size_t keyLen, AesKey &ctx);
+    static void encryptBlock(const AesKey &key, const uint8_t *in, uint8_t *out);
+    static void decryptBlock(const AesKey &key, const uint8_t *in, uint8_t *out);
+    static void encryptBlocks(const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void decryptBlocks(const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void encryptBlocks(Backend backend, const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void decryptBlocks(Backend backend, const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void ctr32Xor(const AesKey &key, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t len);
+    static void ctr32Xor(Backend backend,
+                         const AesKey &key,
+                         uint8_t *counter,
+                         const uint8_t *in,
+                         uint8_t *out,
+                         size_t len);
+
     template <uint8_t Nk, uint8_t Nr>
     static ByteBuffer encryptAes_impl(const ByteBuffer &data, const ByteBuffer &key);
     template <uint8_t Nk, uint8_t Nr>
@@ -42,24 +68,88 @@ public:
     static ByteBuffer encryptAes_impl(const uint8_t *data, size_t dataLen, const ByteBuffer &key);
     template <uint8_t Nk, uint8_t Nr>
     static ByteBuffer encryptAes_impl2(const uint8_t *data, size_t dataLen, const ByteBuffer &key);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer encryptAes_impl(const ByteBuffer &data, const AesKey &key);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer encryptAes_impl(const uint8_t *data, size_t dataLen, const AesKey &key);
 
     template <uint8_t Nk, uint8_t Nr>
     static ByteBuffer decryptAes_impl(const ByteBuffer &data, const ByteBuffer &key);
     template <uint8_t Nk, uint8_t Nr>
     static ByteBuffer decryptAes_impl(const uint8_t *data, size_t dataLen, const ByteBuffer &key);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer decryptAes_impl(const ByteBuffer &data, const AesKey &key);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer decryptAes_impl(const uint8_t *data, size_t dataLen, const AesKey &key);
 
     template <uint8_t Nk, uint8_t Nr>
     static void generateSubKeys_impl(uint8_t key[Nk * 4u], SubKeys<Nr + 1u> &);
+
+    static void addCounter(uint8_t *counter, uint64_t blocks);
+    static void ctr128Xor(const AesKey &key, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t len);
+    static void cbcEncrypt(const AesKey &key, const uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void cbcDecrypt(const AesKey &key, const uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void cbcEncryptPkcs7(const AesKey &key, const uint8_t *iv, const uint8_t *in, size_t len, uint8_t *out);
+    static bool cbcDecryptPkcs7(const AesKey &key,
+                                const uint8_t *iv,
+                                const uint8_t *in,
+                                size_t len,
+                                uint8_t *out,
+                                size_t &outLen);
+
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer encryptCbc_impl(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer encryptCbc_impl(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer decryptCbc_impl(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer decryptCbc_impl(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer cryptCtr_impl(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv);
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer cryptCtr_impl(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv);
+
+private:
+    static void ctr128XorSegment(const AesKey &key, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t len);
+    static void cbcDecryptSegment(const AesKey &key,
+                                  const uint8_t *chain,
+                                  const uint8_t *in,
+                                  uint8_t *out,
+                                  size_t blocks);
+
+    // inputs from parallel::THRESHOLD are split into segments processed by separate threads
+    static constexpr size_t PARALLEL_SEGMENT = 1024u * 1024u;
 };
 
 extern template ByteBuffer aes::encryptAes_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &);
 extern template ByteBuffer aes::encryptAes_impl<4u, 10u>(const uint8_t *, size_t, const ByteBuffer &);
 extern template ByteBuffer aes::decryptAes_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &);
 extern template ByteBuffer aes::decryptAes_impl<4u, 10u>(const uint8_t *, size_t, const ByteBuffer &);
+extern template ByteBuffer aes::encryptAes_impl<4u, 10u>(const ByteBuffer &, const AesKey &);
+extern template ByteBuffer aes::encryptAes_impl<4u, 10u>(const uint8_t *, size_t, const AesKey &);
+extern template ByteBuffer aes::decryptAes_impl<4u, 10u>(const ByteBuffer &, const AesKey &);
+extern template ByteBuffer aes::decryptAes_impl<4u, 10u>(const uint8_t *, size_t, const AesKey &);
 extern template void aes::generateSubKeys_impl<4u, 10u>(uint8_t[4u * 4u], aes::SubKeys<10u + 1u> &);
+extern template ByteBuffer aes::encryptCbc_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+extern template ByteBuffer aes::encryptCbc_impl<4u, 10u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+extern template ByteBuffer aes::decryptCbc_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+extern template ByteBuffer aes::decryptCbc_impl<4u, 10u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+extern template ByteBuffer aes::cryptCtr_impl<4u, 10u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+extern template ByteBuffer aes::cryptCtr_impl<4u, 10u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
 
 extern template ByteBuffer aes::encryptAes_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &);
 extern template ByteBuffer aes::decryptAes_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &);
+extern template ByteBuffer aes::encryptAes_impl<8u, 14u>(const ByteBuffer &, const AesKey &);
+extern template ByteBuffer aes::encryptAes_impl<8u, 14u>(const uint8_t *, size_t, const AesKey &);
+extern template ByteBuffer aes::decryptAes_impl<8u, 14u>(const ByteBuffer &, const AesKey &);
+extern template ByteBuffer aes::decryptAes_impl<8u, 14u>(const uint8_t *, size_t, const AesKey &);
 extern template void aes::generateSubKeys_impl<8u, 14u>(uint8_t[8u * 4u], aes::SubKeys<14u + 1u> &);
+extern template ByteBuffer aes::encryptCbc_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+extern template ByteBuffer aes::encryptCbc_impl<8u, 14u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+extern template ByteBuffer aes::decryptCbc_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+extern template ByteBuffer aes::decryptCbc_impl<8u, 14u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
+extern template ByteBuffer aes::cryptCtr_impl<8u, 14u>(const ByteBuffer &, const ByteBuffer &, const ByteBuffer &);
+extern template ByteBuffer aes::cryptCtr_impl<8u, 14u>(const ByteBuffer &, const AesKey &, const ByteBuffer &);
 
 } // namespace psi::tools::crypt
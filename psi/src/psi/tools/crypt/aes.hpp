@@ -4,6 +4,13 @@
  */
 
 #include "aes.h"
+#include "aes_bitsliced.h"
+#include "aes_ni.h"
+#include "aes_ttable.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <vector>
 
 #ifdef PSI_LOGGER
 #include "psi/logger/Logger.h"
@@ -31,14 +38,375 @@ inline void aes::doRoundKeyEncode(const aes::SubKey &key, aes::DataBlock16 &bloc
     aes::applySubKey(key, block);
 }
 
+// equivalent inverse cipher, round keys are expected with InvMixColumns already applied
 inline void aes::doRoundKeyDecode(const aes::SubKey &key, aes::DataBlock16 &block, bool isFinal)
 {
-    aes::invShiftRows(block);
     aes::subBytes(aes::m_iBox, block);
-    aes::applySubKey(key, block);
+    aes::invShiftRows(block);
     if (!isFinal) {
         aes::invMixColumns(block);
     }
+    aes::applySubKey(key, block);
+}
+
+inline void encryptBlockPortable(const aes::SubKeys<AesKey::MAX_ROUNDS + 1u> &subKeys,
+                                 uint8_t nr,
+                                 const uint8_t *in,
+                                 uint8_t *out)
+{
+    aes::DataBlock16 block;
+    aes::writeBlock(in, 16u, block);
+    aes::applySubKey(subKeys[0], block);
+    for (uint8_t round = 1; round < nr; ++round) {
+        aes::doRoundKeyEncode(subKeys[round], block);
+    }
+    aes::doRoundKeyEncode(subKeys[nr], block, true);
+    aes::readBlock(block, out, 16u);
+}
+
+// same shape as encryption, decSubKeys are in order of application
+inline void decryptBlockPortable(const aes::SubKeys<AesKey::MAX_ROUNDS + 1u> &decSubKeys,
+                                 uint8_t nr,
+                                 const uint8_t *in,
+                                 uint8_t *out)
+{
+    aes::DataBlock16 block;
+    aes::writeBlock(in, 16u, block);
+    aes::applySubKey(decSubKeys[0], block);
+    for (uint8_t round = 1; round < nr; ++round) {
+        aes::doRoundKeyDecode(decSubKeys[round], block);
+    }
+    aes::doRoundKeyDecode(decSubKeys[nr], block, true);
+    aes::readBlock(block, out, 16u);
+}
+
+aes::Backend aes::backend()
+{
+#ifdef PSI_CRYPT_CONSTANT_TIME
+    static const Backend selected = aes_ni::isSupported() ? Backend::AesNi : Backend::Bitsliced;
+#else
+    static const Backend selected = aes_ni::isSupported() ? Backend::AesNi : Backend::TTable;
+#endif
+    return selected;
+}
+
+// key stream is always produced in batches of blocks, so constant-time implementation is used without AES-NI
+aes::Backend aes::ctrBackend()
+{
+    static const Backend selected = aes_ni::isSupported() ? Backend::AesNi : Backend::Bitsliced;
+    return selected;
+}
+
+void aes::encryptBlock(const AesKey &key, const uint8_t *in, uint8_t *out)
+{
+    encryptBlocks(backend(), key, in, out, 1u);
+}
+
+void aes::decryptBlock(const AesKey &key, const uint8_t *in, uint8_t *out)
+{
+    decryptBlocks(backend(), key, in, out, 1u);
+}
+
+void aes::encryptBlocks(const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    encryptBlocks(backend(), key, in, out, blocks);
+}
+
+void aes::decryptBlocks(const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    decryptBlocks(backend(), key, in, out, blocks);
+}
+
+void aes::encryptBlocks(Backend backend, const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    switch (backend) {
+    case Backend::AesNi:
+        aes_ni::encryptBlocks(key.m_roundKeys[0].data(), key.m_rounds, in, out, blocks);
+        break;
+    case Backend::TTable:
+        aes_ttable::encryptBlocks(key.m_roundKeys[0].data(), key.m_rounds, in, out, blocks);
+        break;
+    case Backend::Bitsliced:
+        aes_bitsliced::encryptBlocks(key.m_roundKeys[0].data(), key.m_rounds, in, out, blocks);
+        break;
+    case Backend::Portable:
+        for (size_t n = 0; n < blocks; ++n) {
+            encryptBlockPortable(key.m_roundKeys, key.m_rounds, shift_ptr(in, n * 16u), shift_ptr(out, n * 16u));
+        }
+        break;
+    }
+}
+
+void aes::decryptBlocks(Backend backend, const AesKey &key, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    switch (backend) {
+    case Backend::AesNi:
+        aes_ni::decryptBlocks(key.m_decRoundKeys[0].data(), key.m_rounds, in, out, blocks);
+        break;
+    case Backend::TTable:
+        aes_ttable::decryptBlocks(key.m_decRoundKeys[0].data(), key.m_rounds, in, out, blocks);
+        break;
+    case Backend::Bitsliced:
+        aes_bitsliced::decryptBlocks(key.m_roundKeys[0].data(), key.m_rounds, in, out, blocks);
+        break;
+    case Backend::Portable:
+        for (size_t n = 0; n < blocks; ++n) {
+            decryptBlockPortable(key.m_decRoundKeys, key.m_rounds, shift_ptr(in, n * 16u), shift_ptr(out, n * 16u));
+        }
+        break;
+    }
+}
+
+void aes::ctr32Xor(const AesKey &key, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t len)
+{
+    ctr32Xor(ctrBackend(), key, counter, in, out, len);
+}
+
+// counter mode with 32-bit big-endian increment of last counter word (inc32 of NIST SP 800-38D)
+// counter is advanced by number of used blocks, in and out might point to the same memory
+void aes::ctr32Xor(Backend backend, const AesKey &key, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t len)
+{
+    switch (backend) {
+    case Backend::AesNi:
+        aes_ni::ctr32Xor(key.m_roundKeys[0].data(), key.m_rounds, counter, in, out, len);
+        break;
+    case Backend::Bitsliced:
+        aes_bitsliced::ctr32Xor(key.m_roundKeys[0].data(), key.m_rounds, counter, in, out, len);
+        break;
+    case Backend::Portable:
+    case Backend::TTable: {
+        constexpr size_t BATCH = 8u;
+        uint8_t keyStream[BATCH * 16u];
+        for (size_t offset = 0; offset < len;) {
+            const size_t blocks = std::min(BATCH, (len - offset + 15u) / 16u);
+            for (size_t n = 0; n < blocks; ++n) {
+                mem_copy(keyStream, n * 16u, counter, 0, 16u);
+                for (size_t i = 16u; i != 12u; --i) {
+                    if (++*shift_ptr(counter, i - 1) != 0) {
+                        break;
+                    }
+                }
+            }
+            encryptBlocks(backend, key, keyStream, keyStream, blocks);
+
+            const size_t bytes = std::min(blocks * 16u, len - offset);
+            for (size_t i = 0; i < bytes; ++i) {
+                *shift_ptr(out, offset + i) = *shift_ptr(in, offset + i) ^ keyStream[i];
+            }
+            offset += bytes;
+        }
+        break;
+    }
+    }
+}
+
+// adds number of blocks to 128-bit big-endian counter
+void aes::addCounter(uint8_t *counter, uint64_t blocks)
+{
+    uint64_t carry = blocks;
+    for (size_t i = 16u; i != 0 && carry != 0; --i) {
+        carry += *shift_ptr(counter, i - 1u);
+        *shift_ptr(counter, i - 1u) = uint8_t(carry);
+        carry >>= 8;
+    }
+}
+
+// counter mode of NIST SP 800-38A with increment of whole 128-bit counter
+// counter is advanced by number of used blocks, in and out might point to the same memory
+void aes::ctr128Xor(const AesKey &key, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t len)
+{
+    if (len < parallel::THRESHOLD) {
+        ctr128XorSegment(key, counter, in, out, len);
+        return;
+    }
+
+    const size_t segments = (len + PARALLEL_SEGMENT - 1u) / PARALLEL_SEGMENT;
+    parallel::forEach(segments, [&](size_t j) {
+        const size_t offset = j * PARALLEL_SEGMENT;
+        uint8_t segmentCounter[16u];
+        mem_copy(segmentCounter, 0, counter, 0, 16u);
+        addCounter(segmentCounter, offset / 16u);
+        ctr128XorSegment(key,
+                         segmentCounter,
+                         shift_ptr(in, offset),
+                         shift_ptr(out, offset),
+                         std::min(PARALLEL_SEGMENT, len - offset));
+    });
+    addCounter(counter, (len + 15u) / 16u);
+}
+
+void aes::ctr128XorSegment(const AesKey &key, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t len)
+{
+    for (size_t offset = 0; offset < len;) {
+        // ctr32Xor is used for every run of blocks which does not wrap lower 32 bits of counter
+        const uint64_t low = (uint64_t(*shift_ptr(counter, 12u)) << 24) | (uint64_t(*shift_ptr(counter, 13u)) << 16)
+            | (uint64_t(*shift_ptr(counter, 14u)) << 8) | uint64_t(*shift_ptr(counter, 15u));
+        const uint64_t runLen = ((uint64_t(1) << 32) - low) * 16u;
+        const size_t sz = runLen < len - offset ? size_t(runLen) : len - offset;
+
+        ctr32Xor(key, counter, shift_ptr(in, offset), shift_ptr(out, offset), sz);
+        offset += sz;
+
+        if (sz == runLen) {
+            addCounter(counter, uint64_t(1) << 32);
+        }
+    }
+}
+
+// C[i] = E(K, P[i] XOR C[i - 1]), C[-1] = IV
+void aes::cbcEncrypt(const AesKey &key, const uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    const Backend selected = backend();
+    uint8_t chain[16u];
+    mem_copy(chain, 0, iv, 0, 16u);
+    for (size_t n = 0; n < blocks; ++n) {
+        for (size_t i = 0; i < 16u; ++i) {
+            chain[i] ^= *shift_ptr(in, n * 16u + i);
+        }
+        encryptBlocks(selected, key, chain, chain, 1u);
+        mem_copy(out, n * 16u, chain, 0, 16u);
+    }
+}
+
+// P[i] = D(K, C[i]) XOR C[i - 1], blocks are independent, so they are decrypted in batches and by several threads
+// in and out might point to the same memory
+void aes::cbcDecrypt(const AesKey &key, const uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    const size_t len = blocks * 16u;
+    if (len < parallel::THRESHOLD) {
+        cbcDecryptSegment(key, iv, in, out, blocks);
+        return;
+    }
+
+    // chain blocks are taken before any segment is decrypted in place
+    const size_t segments = (len + PARALLEL_SEGMENT - 1u) / PARALLEL_SEGMENT;
+    std::vector<uint8_t> chains(segments * 16u);
+    mem_copy(chains.data(), 0, iv, 0, 16u);
+    for (size_t j = 1; j < segments; ++j) {
+        mem_copy(chains.data(), j * 16u, in, j * PARALLEL_SEGMENT - 16u, 16u);
+    }
+
+    parallel::forEach(segments, [&](size_t j) {
+        const size_t offset = j * PARALLEL_SEGMENT;
+        cbcDecryptSegment(key,
+                          shift_ptr(chains.data(), j * 16u),
+                          shift_ptr(in, offset),
+                          shift_ptr(out, offset),
+                          std::min(PARALLEL_SEGMENT, len - offset) / 16u);
+    });
+}
+
+// PKCS#7: 1..16 bytes of padding are always added, each one equals to length of padding
+// out must have space for padded data, in and out might point to the same memory
+void aes::cbcEncryptPkcs7(const AesKey &key, const uint8_t *iv, const uint8_t *in, size_t len, uint8_t *out)
+{
+    const size_t blocks = len / 16u;
+    const uint8_t padding = uint8_t(16u - len % 16u);
+
+    // tail is taken before in-place encryption overwrites it
+    uint8_t last[16u];
+    mem_copy(last, 0, in, blocks * 16u, 16u - padding);
+    mem_set(last, 16u - padding, padding, padding);
+
+    cbcEncrypt(key, iv, in, out, blocks);
+    cbcEncrypt(key, blocks ? shift_ptr(out, (blocks - 1u) * 16u) : iv, last, shift_ptr(out, blocks * 16u), 1u);
+    mem_wipe(last, sizeof(last));
+}
+
+// out must have space for len bytes, padding is removed by reporting shorter outLen
+bool aes::cbcDecryptPkcs7(const AesKey &key,
+                          const uint8_t *iv,
+                          const uint8_t *in,
+                          size_t len,
+                          uint8_t *out,
+                          size_t &outLen)
+{
+    if (len == 0 || len % 16u) {
+        return false;
+    }
+
+    cbcDecrypt(key, iv, in, out, len / 16u);
+
+    // whole padding is checked without early exit
+    const uint8_t padding = *shift_ptr(out, len - 1u);
+    uint8_t invalid = uint8_t(padding == 0) | uint8_t(padding > 16u);
+    for (size_t i = 1; i <= 16u; ++i) {
+        const uint8_t mask = uint8_t(i <= padding ? 0xff : 0x00);
+        invalid |= mask & (*shift_ptr(out, len - i) ^ padding);
+    }
+    if (invalid) {
+        mem_wipe(out, len);
+        LOG_ERROR_STATIC("aes: invalid padding");
+        return false;
+    }
+
+    outLen = len - padding;
+    return true;
+}
+
+void aes::cbcDecryptSegment(const AesKey &key, const uint8_t *chain, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    constexpr size_t BATCH = 8u;
+    const Backend selected = backend();
+    uint8_t prev[16u];
+    uint8_t cipher[BATCH * 16u];
+    mem_copy(prev, 0, chain, 0, 16u);
+
+    for (size_t n = 0; n < blocks; n += BATCH) {
+        const size_t count = std::min(BATCH, blocks - n);
+        mem_copy(cipher, 0, in, n * 16u, count * 16u);
+        decryptBlocks(selected, key, cipher, shift_ptr(out, n * 16u), count);
+
+        for (size_t i = 0; i < 16u; ++i) {
+            *shift_ptr(out, n * 16u + i) ^= prev[i];
+        }
+        for (size_t i = 16u; i < count * 16u; ++i) {
+            *shift_ptr(out, n * 16u + i) ^= cipher[i - 16u];
+        }
+        mem_copy(prev, 0, cipher, (count - 1u) * 16u, 16u);
+    }
+}
+
+void aes::expandKey(const uint8_t *key, size_t keyLen, AesKey &ctx)
+{
+    ctx.m_rounds = 0u;
+
+    const bool hasAesNi = aes_ni::isSupported();
+    uint8_t keyCopy[32u] = {};
+    if (keyLen == 16u) {
+        if (hasAesNi) {
+            aes_ni::expandKey128(key, ctx.m_roundKeys[0].data());
+        } else {
+            mem_copy(keyCopy, 0, key, 0, 16u);
+            aes::SubKeys<11u> subKeys;
+            generateSubKeys_impl<4u, 10u>(keyCopy, subKeys);
+            std::copy(subKeys.begin(), subKeys.end(), ctx.m_roundKeys.begin());
+            mem_wipe(reinterpret_cast<uint8_t *>(subKeys.data()), sizeof(subKeys));
+            mem_wipe(keyCopy, sizeof(keyCopy));
+        }
+        ctx.m_rounds = 10u;
+    } else if (keyLen == 32u) {
+        if (hasAesNi) {
+            aes_ni::expandKey256(key, ctx.m_roundKeys[0].data());
+        } else {
+            mem_copy(keyCopy, 0, key, 0, 32u);
+            aes::SubKeys<15u> subKeys;
+            generateSubKeys_impl<8u, 14u>(keyCopy, subKeys);
+            std::copy(subKeys.begin(), subKeys.end(), ctx.m_roundKeys.begin());
+            mem_wipe(reinterpret_cast<uint8_t *>(subKeys.data()), sizeof(subKeys));
+            mem_wipe(keyCopy, sizeof(keyCopy));
+        }
+        ctx.m_rounds = 14u;
+    } else {
+        return;
+    }
+
+    // keys of equivalent inverse cipher are shared by AES-NI and T-table backends
+    if (hasAesNi) {
+        aes_ni::invertKeys(ctx.m_roundKeys[0].data(), ctx.m_rounds, ctx.m_decRoundKeys[0].data());
+    } else {
+        aes_ttable::invertKeys(ctx.m_roundKeys[0].data(), ctx.m_rounds, ctx.m_decRoundKeys[0].data());
+    }
 }
 
 template <uint8_t Nk, uint8_t Nr>
@@ -54,40 +422,37 @@ ByteBuffer aes::encryptAes_impl(const uint8_t *in, size_t dataLen, const ByteBuf
         return {};
     }
 
+    return encryptAes_impl<Nk, Nr>(in, dataLen, AesKey(key));
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::encryptAes_impl(const ByteBuffer &inputData, const AesKey &key)
+{
+    return encryptAes_impl<Nk, Nr>(inputData.data(), inputData.size(), key);
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::encryptAes_impl(const uint8_t *in, size_t dataLen, const AesKey &key)
+{
+    if (key.rounds() != Nr) {
+        return {};
+    }
+
     const uint8_t extraBytes = dataLen % 16u;
     ByteBuffer result(extraBytes == 0 ? dataLen : (dataLen + 16u - extraBytes + 1));
 
-    aes::SubKeys<Nr + 1u> m_subKeys;
-    generateSubKeys_impl<Nk, Nr>(key.data(), m_subKeys);
-
     auto *out = result.data();
 
     const size_t cycles = dataLen / 16u;
 
     // main cycles
-    for (size_t cycleN = 0; cycleN < cycles; ++cycleN) {
-        DataBlock16 block;
-        writeBlock(shift_ptr(in, cycleN * 16u), 16u, block);
-        applySubKey(m_subKeys[0], block);
-        for (uint8_t round = 1; round < Nr; ++round) {
-            doRoundKeyEncode(m_subKeys[round], block);
-        }
-        doRoundKeyEncode(m_subKeys[Nr], block, true);
-        readBlock(block, shift_ptr(out, cycleN * 16u), 16u);
-    }
+    encryptBlocks(key, in, out, cycles);
     // additional cycle
     if (extraBytes) {
         uint8_t lastChunk[16u] = {'\0'};
         mem_copy(lastChunk, 0, in, cycles * 16u, extraBytes);
 
-        DataBlock16 block;
-        writeBlock(lastChunk, 16u, block);
-        applySubKey(m_subKeys[0], block);
-        for (uint8_t round = 1; round < Nr; ++round) {
-            doRoundKeyEncode(m_subKeys[round], block);
-        }
-        doRoundKeyEncode(m_subKeys[Nr], block, true);
-        readBlock(block, shift_ptr(out, cycles * 16u), 16u);
+        encryptBlock(key, lastChunk, shift_ptr(out, cycles * 16u));
         mem_set(out, (cycles + 1) * 16u, uint8_t(extraBytes), 1);
     }
 
@@ -107,45 +472,116 @@ ByteBuffer aes::decryptAes_impl(const uint8_t *in, size_t dataLen, const ByteBuf
         return {};
     }
 
+    return decryptAes_impl<Nk, Nr>(in, dataLen, AesKey(key));
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::decryptAes_impl(const ByteBuffer &inputData, const AesKey &key)
+{
+    return decryptAes_impl<Nk, Nr>(inputData.data(), inputData.size(), key);
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::decryptAes_impl(const uint8_t *in, size_t dataLen, const AesKey &key)
+{
+    if (key.rounds() != Nr) {
+        return {};
+    }
+
     // make data copy
     const uint8_t lenOffset = dataLen % 16u;
     const uint8_t extraBytes = lenOffset ? *shift_ptr(in, dataLen - 1) : 0;
     const size_t resultLen = lenOffset ? dataLen - 1 - 16u + extraBytes : dataLen;
     ByteBuffer result(resultLen);
 
-    aes::SubKeys<Nr + 1u> m_subKeys;
-    generateSubKeys_impl<Nk, Nr>(key.data(), m_subKeys);
-
     auto out = result.data();
 
     const size_t cycles = resultLen / 16u;
 
     // main cycles
-    for (size_t cycleN = 0; cycleN < cycles; ++cycleN) {
-        DataBlock16 block;
-        writeBlock(shift_ptr(in, cycleN * 16u), 16u, block);
-        applySubKey(m_subKeys[Nr], block);
-        for (uint8_t round = Nr - 1; round > 0; --round) {
-            doRoundKeyDecode(m_subKeys[round], block);
-        }
-        doRoundKeyDecode(m_subKeys[0], block, true);
-        readBlock(block, shift_ptr(out, cycleN * 16u), 16u);
-    }
+    decryptBlocks(key, in, out, cycles);
     // additional cycle
     if (extraBytes) {
         uint8_t lastChunk[16u] = {'\0'};
-        mem_copy(lastChunk, 0, in, dataLen - 1 - 16u, 16u);
+        decryptBlock(key, shift_ptr(in, dataLen - 1 - 16u), lastChunk);
+        mem_copy(out, cycles * 16u, lastChunk, 0, extraBytes);
+    }
 
-        DataBlock16 block;
-        writeBlock(lastChunk, 16u, block);
-        applySubKey(m_subKeys[Nr], block);
-        for (uint8_t round = Nr - 1; round > 0; --round) {
-            doRoundKeyDecode(m_subKeys[round], block);
-        }
-        doRoundKeyDecode(m_subKeys[0], block, true);
-        readBlock(block, shift_ptr(out, cycles * 16u), extraBytes);
+    return result;
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::encryptCbc_impl(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    if (key.size() != Nk * 4u) {
+        return {};
     }
 
+    return encryptCbc_impl<Nk, Nr>(data, AesKey(key), iv);
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::encryptCbc_impl(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv)
+{
+    if (key.rounds() != Nr || iv.size() != 16u) {
+        return {};
+    }
+
+    ByteBuffer result(data.size() + 16u - data.size() % 16u);
+    cbcEncryptPkcs7(key, iv.data(), data.data(), data.size(), result.data());
+    return result;
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::decryptCbc_impl(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    if (key.size() != Nk * 4u) {
+        return {};
+    }
+
+    return decryptCbc_impl<Nk, Nr>(data, AesKey(key), iv);
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::decryptCbc_impl(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv)
+{
+    if (key.rounds() != Nr || iv.size() != 16u) {
+        return {};
+    }
+
+    ByteBuffer plain(data.size());
+    size_t plainLen = 0;
+    if (!cbcDecryptPkcs7(key, iv.data(), data.data(), data.size(), plain.data(), plainLen)) {
+        return {};
+    }
+
+    ByteBuffer result(plainLen);
+    mem_copy(result.data(), 0, plain.data(), 0, plainLen);
+    return result;
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::cryptCtr_impl(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv)
+{
+    if (key.size() != Nk * 4u) {
+        return {};
+    }
+
+    return cryptCtr_impl<Nk, Nr>(data, AesKey(key), iv);
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes::cryptCtr_impl(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv)
+{
+    if (key.rounds() != Nr || iv.size() != 16u) {
+        return {};
+    }
+
+    uint8_t counter[16u];
+    mem_copy(counter, 0, iv.data(), 0, 16u);
+
+    ByteBuffer result(data.size());
+    ctr128Xor(key, counter, data.data(), result.data(), data.size());
     return result;
 }
 
@@ -193,30 +629,6 @@ inline uint8_t mul3(uint8_t a)
     return mul2(a) ^ a;
 }
 
-inline uint8_t mul9(uint8_t a)
-{
-    return mul2(mul2(mul2(a))) ^ a;
-}
-
-inline uint8_t mul11(uint8_t a)
-{
-    const auto b = mul2(a);
-    return mul2(mul2(b)) ^ b ^ a;
-}
-
-inline uint8_t mul13(uint8_t a)
-{
-    const auto c = mul2(mul2(a));
-    return mul2(c) ^ c ^ a;
-}
-
-inline uint8_t mul14(uint8_t a)
-{
-    const auto b = mul2(a);
-    const auto c = mul2(b);
-    return mul2(c) ^ c ^ b;
-}
-
 const std::array<uint8_t, 256u> aes::m_sBox = {
     //0   1     2     3     4     5     6     7     8     9     a     b     c     d     e     f
     0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9,
@@ -326,32 +738,23 @@ void aes::invMixColumns(aes::DataBlock16 &block)
 {
     for (uint8_t col = 0; col < 4; ++col) {
         /**
-        * InvMatrix GF2
-        *  9  = 0x09 = 2 * 2 * 2 + 1
-        *  11 = 0x0b = (2 * 2 + 1) * 2 + 1
-        *  13 = 0x0d = (2 + 1) * 2 * 2 + 1
-        *  14 = 0x0e = ((2 + 1) * 2 + 1) * 2
-        *  0x0e 0x0b 0x0d 0x09 // 14 11 13 9
-        *  0x09 0x0e 0x0b 0x0d // 9 14 11 13
-        *  0x0d 0x09 0x0e 0x0b // 13 9 14 11
-        *  0x0b 0x0d 0x09 0x0e // 11 13 9 14
+        * InvMatrix GF2 is factorized into Matrix GF2 and sparse matrix:
+        *  0x0e 0x0b 0x0d 0x09     0x02 0x03 0x01 0x01     0x05 0x00 0x04 0x00
+        *  0x09 0x0e 0x0b 0x0d  =  0x01 0x02 0x03 0x01  *  0x00 0x05 0x00 0x04
+        *  0x0d 0x09 0x0e 0x0b     0x01 0x01 0x02 0x03     0x04 0x00 0x05 0x00
+        *  0x0b 0x0d 0x09 0x0e     0x03 0x01 0x01 0x02     0x00 0x04 0x00 0x05
         **/
 
-        // 14 * a0 + 11 * a1 + 13 * a2 +  9 * a3
-        //  9 * a0 + 14 * a1 + 11 * a2 + 13 * a3
-        // 13 * a0 +  9 * a1 + 14 * a2 + 11 * a3
-        // 11 * a0 + 13 * a1 +  9 * a2 + 14 * a3
+        const auto u = mul2(mul2(block[0][col] ^ block[2][col]));
+        const auto v = mul2(mul2(block[1][col] ^ block[3][col]));
 
-        auto a0 = block[0][col];
-        auto a1 = block[1][col];
-        auto a2 = block[2][col];
-        auto a3 = block[3][col];
-
-        block[0][col] = mul14(a0) ^ mul11(a1) ^ mul13(a2) ^ mul9(a3);
-        block[1][col] = mul9(a0) ^ mul14(a1) ^ mul11(a2) ^ mul13(a3);
-        block[2][col] = mul13(a0) ^ mul9(a1) ^ mul14(a2) ^ mul11(a3);
-        block[3][col] = mul11(a0) ^ mul13(a1) ^ mul9(a2) ^ mul14(a3);
+        block[0][col] ^= u;
+        block[1][col] ^= v;
+        block[2][col] ^= u;
+        block[3][col] ^= v;
     }
+
+    mixColumns(block);
 }
 
 void aes::applySubKey(const SubKey &key, aes::DataBlock16 &block)
@@ -0,0 +1,498 @@
+/**
+ * @brief https://eprint.iacr.org/2009/191.pdf, https://eprint.iacr.org/2011/332.pdf (S-box circuit) and
+ * https://www.bearssl.org/constanttime.html (64-bit bitslice layout)
+ * 
+ */
+#include "aes_bitsliced.h"
+
+#include "psi/tools/Tools.h"
+
+#include <array>
+
+namespace psi::tools::crypt {
+
+namespace {
+
+// 4 blocks, word i holds bit i of every byte
+using Slice = std::array<uint64_t, 8u>;
+using SliceKeys = std::array<Slice, 15u>;
+
+constexpr size_t LANES = 8u;
+
+inline uint32_t load32le(const uint8_t *p, size_t offset)
+{
+    return uint32_t(*shift_ptr(p, offset)) | (uint32_t(*shift_ptr(p, offset + 1u)) << 8)
+        | (uint32_t(*shift_ptr(p, offset + 2u)) << 16) | (uint32_t(*shift_ptr(p, offset + 3u)) << 24);
+}
+
+inline void store32le(uint8_t *p, size_t offset, uint32_t w)
+{
+    *shift_ptr(p, offset) = uint8_t(w);
+    *shift_ptr(p, offset + 1u) = uint8_t(w >> 8);
+    *shift_ptr(p, offset + 2u) = uint8_t(w >> 16);
+    *shift_ptr(p, offset + 3u) = uint8_t(w >> 24);
+}
+
+inline void swapBits(uint64_t &x, uint64_t &y, uint64_t mask, uint8_t shift)
+{
+    const uint64_t a = x;
+    const uint64_t b = y;
+    x = (a & mask) | ((b & mask) << shift);
+    y = ((a & ~mask) >> shift) | (b & ~mask);
+}
+
+// converts between byte layout and bit layout, the transform is an involution
+inline void ortho(Slice &q)
+{
+    swapBits(q[0], q[1], 0x5555555555555555ull, 1);
+    swapBits(q[2], q[3], 0x5555555555555555ull, 1);
+    swapBits(q[4], q[5], 0x5555555555555555ull, 1);
+    swapBits(q[6], q[7], 0x5555555555555555ull, 1);
+
+    swapBits(q[0], q[2], 0x3333333333333333ull, 2);
+    swapBits(q[1], q[3], 0x3333333333333333ull, 2);
+    swapBits(q[4], q[6], 0x3333333333333333ull, 2);
+    swapBits(q[5], q[7], 0x3333333333333333ull, 2);
+
+    swapBits(q[0], q[4], 0x0f0f0f0f0f0f0f0full, 4);
+    swapBits(q[1], q[5], 0x0f0f0f0f0f0f0f0full, 4);
+    swapBits(q[2], q[6], 0x0f0f0f0f0f0f0f0full, 4);
+    swapBits(q[3], q[7], 0x0f0f0f0f0f0f0f0full, 4);
+}
+
+// spreads 4 little-endian columns of one block over two words: even bytes go to q0, odd bytes to q1
+inline void interleaveIn(const uint8_t *block, uint64_t &q0, uint64_t &q1)
+{
+    uint64_t x[4];
+    for (size_t i = 0; i < 4u; ++i) {
+        uint64_t v = load32le(block, i * 4u);
+        v |= v << 16;
+        v &= 0x0000ffff0000ffffull;
+        v |= v << 8;
+        v &= 0x00ff00ff00ff00ffull;
+        x[i] = v;
+    }
+    q0 = x[0] | (x[2] << 8);
+    q1 = x[1] | (x[3] << 8);
+}
+
+inline void interleaveOut(uint64_t q0, uint64_t q1, uint8_t *block)
+{
+    uint64_t x[4] = {q0 & 0x00ff00ff00ff00ffull,
+                     q1 & 0x00ff00ff00ff00ffull,
+                     (q0 >> 8) & 0x00ff00ff00ff00ffull,
+                     (q1 >> 8) & 0x00ff00ff00ff00ffull};
+    for (size_t i = 0; i < 4u; ++i) {
+        uint64_t v = x[i];
+        v |= v >> 8;
+        v &= 0x0000ffff0000ffffull;
+        store32le(block, i * 4u, uint32_t(v) | uint32_t(v >> 16));
+    }
+}
+
+// Boyar-Peralta circuit: 32 AND, 83 XOR, 4 XNOR
+inline void subBytes(Slice &q)
+{
+    const uint64_t x0 = q[7];
+    const uint64_t x1 = q[6];
+    const uint64_t x2 = q[5];
+    const uint64_t x3 = q[4];
+    const uint64_t x4 = q[3];
+    const uint64_t x5 = q[2];
+    const uint64_t x6 = q[1];
+    const uint64_t x7 = q[0];
+
+    // top linear transformation
+    const uint64_t y14 = x3 ^ x5;
+    const uint64_t y13 = x0 ^ x6;
+    const uint64_t y9 = x0 ^ x3;
+    const uint64_t y8 = x0 ^ x5;
+    const uint64_t t0 = x1 ^ x2;
+    const uint64_t y1 = t0 ^ x7;
+    const uint64_t y4 = y1 ^ x3;
+    const uint64_t y12 = y13 ^ y14;
+    const uint64_t y2 = y1 ^ x0;
+    const uint64_t y5 = y1 ^ x6;
+    const uint64_t y3 = y5 ^ y8;
+    const uint64_t t1 = x4 ^ y12;
+    const uint64_t y15 = t1 ^ x5;
+    const uint64_t y20 = t1 ^ x1;
+    const uint64_t y6 = y15 ^ x7;
+    const uint64_t y10 = y15 ^ t0;
+    const uint64_t y11 = y20 ^ y9;
+    const uint64_t y7 = x7 ^ y11;
+    const uint64_t y17 = y10 ^ y11;
+    const uint64_t y19 = y10 ^ y8;
+    const uint64_t y16 = t0 ^ y11;
+    const uint64_t y21 = y13 ^ y16;
+    const uint64_t y18 = x0 ^ y16;
+
+    // non-linear section
+    const uint64_t t2 = y12 & y15;
+    const uint64_t t3 = y3 & y6;
+    const uint64_t t4 = t3 ^ t2;
+    const uint64_t t5 = y4 & x7;
+    const uint64_t t6 = t5 ^ t2;
+    const uint64_t t7 = y13 & y16;
+    const uint64_t t8 = y5 & y1;
+    const uint64_t t9 = t8 ^ t7;
+    const uint64_t t10 = y2 & y7;
+    const uint64_t t11 = t10 ^ t7;
+    const uint64_t t12 = y9 & y11;
+    const uint64_t t13 = y14 & y17;
+    const uint64_t t14 = t13 ^ t12;
+    const uint64_t t15 = y8 & y10;
+    const uint64_t t16 = t15 ^ t12;
+    const uint64_t t17 = t4 ^ t14;
+    const uint64_t t18 = t6 ^ t16;
+    const uint64_t t19 = t9 ^ t14;
+    const uint64_t t20 = t11 ^ t16;
+    const uint64_t t21 = t17 ^ y20;
+    const uint64_t t22 = t18 ^ y19;
+    const uint64_t t23 = t19 ^ y21;
+    const uint64_t t24 = t20 ^ y18;
+
+    const uint64_t t25 = t21 ^ t22;
+    const uint64_t t26 = t21 & t23;
+    const uint64_t t27 = t24 ^ t26;
+    const uint64_t t28 = t25 & t27;
+    const uint64_t t29 = t28 ^ t22;
+    const uint64_t t30 = t23 ^ t24;
+    const uint64_t t31 = t22 ^ t26;
+    const uint64_t t32 = t31 & t30;
+    const uint64_t t33 = t32 ^ t24;
+    const uint64_t t34 = t23 ^ t33;
+    const uint64_t t35 = t27 ^ t33;
+    const uint64_t t36 = t24 & t35;
+    const uint64_t t37 = t36 ^ t34;
+    const uint64_t t38 = t27 ^ t36;
+    const uint64_t t39 = t29 & t38;
+    const uint64_t t40 = t25 ^ t39;
+
+    const uint64_t t41 = t40 ^ t37;
+    const uint64_t t42 = t29 ^ t33;
+    const uint64_t t43 = t29 ^ t40;
+    const uint64_t t44 = t33 ^ t37;
+    const uint64_t t45 = t42 ^ t41;
+    const uint64_t z0 = t44 & y15;
+    const uint64_t z1 = t37 & y6;
+    const uint64_t z2 = t33 & x7;
+    const uint64_t z3 = t43 & y16;
+    const uint64_t z4 = t40 & y1;
+    const uint64_t z5 = t29 & y7;
+    const uint64_t z6 = t42 & y11;
+    const uint64_t z7 = t45 & y17;
+    const uint64_t z8 = t41 & y10;
+    const uint64_t z9 = t44 & y12;
+    const uint64_t z10 = t37 & y3;
+    const uint64_t z11 = t33 & y4;
+    const uint64_t z12 = t43 & y13;
+    const uint64_t z13 = t40 & y5;
+    const uint64_t z14 = t29 & y2;
+    const uint64_t z15 = t42 & y9;
+    const uint64_t z16 = t45 & y14;
+    const uint64_t z17 = t41 & y8;
+
+    // bottom linear transformation
+    const uint64_t t46 = z15 ^ z16;
+    const uint64_t t47 = z10 ^ z11;
+    const uint64_t t48 = z5 ^ z13;
+    const uint64_t t49 = z9 ^ z10;
+    const uint64_t t50 = z2 ^ z12;
+    const uint64_t t51 = z2 ^ z5;
+    const uint64_t t52 = z7 ^ z8;
+    const uint64_t t53 = z0 ^ z3;
+    const uint64_t t54 = z6 ^ z7;
+    const uint64_t t55 = z16 ^ z17;
+    const uint64_t t56 = z12 ^ t48;
+    const uint64_t t57 = t50 ^ t53;
+    const uint64_t t58 = z4 ^ t46;
+    const uint64_t t59 = z3 ^ t54;
+    const uint64_t t60 = t46 ^ t57;
+    const uint64_t t61 = z14 ^ t57;
+    const uint64_t t62 = t52 ^ t58;
+    const uint64_t t63 = t49 ^ t58;
+    const uint64_t t64 = z4 ^ t59;
+    const uint64_t t65 = t61 ^ t62;
+    const uint64_t t66 = z1 ^ t63;
+    const uint64_t t67 = t64 ^ t65;
+
+    const uint64_t s3 = t53 ^ t66;
+    q[7] = t59 ^ t63;
+    q[6] = t64 ^ ~s3;
+    q[5] = t55 ^ ~t67;
+    q[4] = s3;
+    q[3] = t51 ^ t66;
+    q[2] = t47 ^ t65;
+    q[1] = t56 ^ ~t62;
+    q[0] = t48 ^ ~t60;
+}
+
+// inverse affine transformation, forward S-box, inverse affine transformation again
+inline void invAffine(Slice &q)
+{
+    const uint64_t q0 = ~q[0];
+    const uint64_t q1 = ~q[1];
+    const uint64_t q2 = q[2];
+    const uint64_t q3 = q[3];
+    const uint64_t q4 = q[4];
+    const uint64_t q5 = ~q[5];
+    const uint64_t q6 = ~q[6];
+    const uint64_t q7 = q[7];
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+inline void invSubBytes(Slice &q)
+{
+    invAffine(q);
+    subBytes(q);
+    invAffine(q);
+}
+
+inline void shiftRows(Slice &q)
+{
+    for (auto &x : q) {
+        x = (x & 0x000000000000ffffull) | ((x & 0x00000000fff00000ull) >> 4) | ((x & 0x00000000000f0000ull) << 12)
+            | ((x & 0x0000ff0000000000ull) >> 8) | ((x & 0x000000ff00000000ull) << 8)
+            | ((x & 0xf000000000000000ull) >> 12) | ((x & 0x0fff000000000000ull) << 4);
+    }
+}
+
+inline void invShiftRows(Slice &q)
+{
+    for (auto &x : q) {
+        x = (x & 0x000000000000ffffull) | ((x & 0x000000000fff0000ull) << 4) | ((x & 0x00000000f0000000ull) >> 12)
+            | ((x & 0x000000ff00000000ull) << 8) | ((x & 0x0000ff0000000000ull) >> 8)
+            | ((x & 0x000f000000000000ull) << 12) | ((x & 0xfff0000000000000ull) >> 4);
+    }
+}
+
+inline uint64_t rotr16(uint64_t x)
+{
+    return (x >> 16) | (x << 48);
+}
+
+inline uint64_t rotr32(uint64_t x)
+{
+    return (x >> 32) | (x << 32);
+}
+
+inline void mixColumns(Slice &q)
+{
+    const Slice x = q;
+    Slice r;
+    for (size_t i = 0; i < 8u; ++i) {
+        r[i] = rotr16(x[i]);
+    }
+
+    q[0] = x[7] ^ r[7] ^ r[0] ^ rotr32(x[0] ^ r[0]);
+    q[1] = x[0] ^ r[0] ^ x[7] ^ r[7] ^ r[1] ^ rotr32(x[1] ^ r[1]);
+    q[2] = x[1] ^ r[1] ^ r[2] ^ rotr32(x[2] ^ r[2]);
+    q[3] = x[2] ^ r[2] ^ x[7] ^ r[7] ^ r[3] ^ rotr32(x[3] ^ r[3]);
+    q[4] = x[3] ^ r[3] ^ x[7] ^ r[7] ^ r[4] ^ rotr32(x[4] ^ r[4]);
+    q[5] = x[4] ^ r[4] ^ r[5] ^ rotr32(x[5] ^ r[5]);
+    q[6] = x[5] ^ r[5] ^ r[6] ^ rotr32(x[6] ^ r[6]);
+    q[7] = x[6] ^ r[6] ^ r[7] ^ rotr32(x[7] ^ r[7]);
+}
+
+inline void invMixColumns(Slice &q)
+{
+    const Slice x = q;
+    Slice r;
+    for (size_t i = 0; i < 8u; ++i) {
+        r[i] = rotr16(x[i]);
+    }
+
+    q[0] = x[5] ^ x[6] ^ x[7] ^ r[0] ^ r[5] ^ r[7] ^ rotr32(x[0] ^ x[5] ^ x[6] ^ r[0] ^ r[5]);
+    q[1] = x[0] ^ x[5] ^ r[0] ^ r[1] ^ r[5] ^ r[6] ^ r[7] ^ rotr32(x[1] ^ x[5] ^ x[7] ^ r[1] ^ r[5] ^ r[6]);
+    q[2] = x[0] ^ x[1] ^ x[6] ^ r[1] ^ r[2] ^ r[6] ^ r[7] ^ rotr32(x[0] ^ x[2] ^ x[6] ^ r[2] ^ r[6] ^ r[7]);
+    q[3] = x[0] ^ x[1] ^ x[2] ^ x[5] ^ x[6] ^ r[0] ^ r[2] ^ r[3] ^ r[5]
+        ^ rotr32(x[0] ^ x[1] ^ x[3] ^ x[5] ^ x[6] ^ x[7] ^ r[0] ^ r[3] ^ r[5] ^ r[7]);
+    q[4] = x[1] ^ x[2] ^ x[3] ^ x[5] ^ r[1] ^ r[3] ^ r[4] ^ r[5] ^ r[6] ^ r[7]
+        ^ rotr32(x[1] ^ x[2] ^ x[4] ^ x[5] ^ x[7] ^ r[1] ^ r[4] ^ r[5] ^ r[6]);
+    q[5] = x[2] ^ x[3] ^ x[4] ^ x[6] ^ r[2] ^ r[4] ^ r[5] ^ r[6] ^ r[7]
+        ^ rotr32(x[2] ^ x[3] ^ x[5] ^ x[6] ^ r[2] ^ r[5] ^ r[6] ^ r[7]);
+    q[6] = x[3] ^ x[4] ^ x[5] ^ x[7] ^ r[3] ^ r[5] ^ r[6] ^ r[7] ^ rotr32(x[3] ^ x[4] ^ x[6] ^ x[7] ^ r[3] ^ r[6] ^ r[7]);
+    q[7] = x[4] ^ x[5] ^ x[6] ^ r[4] ^ r[6] ^ r[7] ^ rotr32(x[4] ^ x[5] ^ x[7] ^ r[4] ^ r[7]);
+}
+
+inline void addRoundKey(Slice &q, const Slice &key)
+{
+    for (size_t i = 0; i < 8u; ++i) {
+        q[i] ^= key[i];
+    }
+}
+
+// every round key is replicated into all 4 blocks of slice
+inline void sliceKeys(const uint8_t *roundKeys, uint8_t rounds, SliceKeys &keys)
+{
+    for (uint8_t r = 0; r <= rounds; ++r) {
+        Slice &q = keys[r];
+        interleaveIn(shift_ptr(roundKeys, r * 16u), q[0], q[4]);
+        q[1] = q[2] = q[3] = q[0];
+        q[5] = q[6] = q[7] = q[4];
+        ortho(q);
+    }
+}
+
+// blocks are loaded into two slices of 4 blocks, missing blocks are zeroes
+inline void load(const uint8_t *in, size_t blocks, Slice (&q)[2])
+{
+    uint8_t block[16u] = {};
+    for (size_t i = 0; i < LANES; ++i) {
+        Slice &s = q[i / 4u];
+        if (i < blocks) {
+            interleaveIn(shift_ptr(in, i * 16u), s[i % 4u], s[i % 4u + 4u]);
+        } else {
+            interleaveIn(block, s[i % 4u], s[i % 4u + 4u]);
+        }
+    }
+    ortho(q[0]);
+    ortho(q[1]);
+}
+
+inline void store(Slice (&q)[2], size_t blocks, uint8_t *out)
+{
+    ortho(q[0]);
+    ortho(q[1]);
+    for (size_t i = 0; i < blocks; ++i) {
+        const Slice &s = q[i / 4u];
+        interleaveOut(s[i % 4u], s[i % 4u + 4u], shift_ptr(out, i * 16u));
+    }
+}
+
+inline void encrypt(const SliceKeys &keys, uint8_t rounds, Slice (&q)[2])
+{
+    for (auto &s : q) {
+        addRoundKey(s, keys[0]);
+    }
+    for (uint8_t r = 1; r < rounds; ++r) {
+        for (auto &s : q) {
+            subBytes(s);
+            shiftRows(s);
+            mixColumns(s);
+            addRoundKey(s, keys[r]);
+        }
+    }
+    for (auto &s : q) {
+        subBytes(s);
+        shiftRows(s);
+        addRoundKey(s, keys[rounds]);
+    }
+}
+
+inline void decrypt(const SliceKeys &keys, uint8_t rounds, Slice (&q)[2])
+{
+    for (auto &s : q) {
+        addRoundKey(s, keys[rounds]);
+    }
+    for (uint8_t r = rounds - 1u; r > 0; --r) {
+        for (auto &s : q) {
+            invShiftRows(s);
+            invSubBytes(s);
+            addRoundKey(s, keys[r]);
+            invMixColumns(s);
+        }
+    }
+    for (auto &s : q) {
+        invShiftRows(s);
+        invSubBytes(s);
+        addRoundKey(s, keys[0]);
+    }
+}
+
+} // namespace
+
+void aes_bitsliced::encryptBlocks(const uint8_t *roundKeys,
+                                  uint8_t rounds,
+                                  const uint8_t *in,
+                                  uint8_t *out,
+                                  size_t blocks)
+{
+    SliceKeys keys;
+    sliceKeys(roundKeys, rounds, keys);
+
+    for (size_t n = 0; n < blocks; n += LANES) {
+        const size_t count = blocks - n < LANES ? blocks - n : LANES;
+        Slice q[2];
+        load(shift_ptr(in, n * 16u), count, q);
+        encrypt(keys, rounds, q);
+        store(q, count, shift_ptr(out, n * 16u));
+    }
+
+    mem_wipe(reinterpret_cast<uint8_t *>(keys.data()), sizeof(keys));
+}
+
+void aes_bitsliced::decryptBlocks(const uint8_t *roundKeys,
+                                  uint8_t rounds,
+                                  const uint8_t *in,
+                                  uint8_t *out,
+                                  size_t blocks)
+{
+    SliceKeys keys;
+    sliceKeys(roundKeys, rounds, keys);
+
+    for (size_t n = 0; n < blocks; n += LANES) {
+        const size_t count = blocks - n < LANES ? blocks - n : LANES;
+        Slice q[2];
+        load(shift_ptr(in, n * 16u), count, q);
+        decrypt(keys, rounds, q);
+        store(q, count, shift_ptr(out, n * 16u));
+    }
+
+    mem_wipe(reinterpret_cast<uint8_t *>(keys.data()), sizeof(keys));
+}
+
+void aes_bitsliced::ctr32Xor(const uint8_t *roundKeys,
+                             uint8_t rounds,
+                             uint8_t *counter,
+                             const uint8_t *in,
+                             uint8_t *out,
+                             size_t len)
+{
+    SliceKeys keys;
+    sliceKeys(roundKeys, rounds, keys);
+
+    uint8_t keyStream[LANES * 16u];
+    uint32_t ctr = (uint32_t(*shift_ptr(counter, 12u)) << 24) | (uint32_t(*shift_ptr(counter, 13u)) << 16)
+        | (uint32_t(*shift_ptr(counter, 14u)) << 8) | uint32_t(*shift_ptr(counter, 15u));
+
+    for (size_t offset = 0; offset < len;) {
+        const size_t count = (len - offset + 15u) / 16u < LANES ? (len - offset + 15u) / 16u : LANES;
+        for (size_t i = 0; i < count; ++i, ++ctr) {
+            mem_copy(keyStream, i * 16u, counter, 0, 12u);
+            keyStream[i * 16u + 12u] = uint8_t(ctr >> 24);
+            keyStream[i * 16u + 13u] = uint8_t(ctr >> 16);
+            keyStream[i * 16u + 14u] = uint8_t(ctr >> 8);
+            keyStream[i * 16u + 15u] = uint8_t(ctr);
+        }
+
+        Slice q[2];
+        load(keyStream, count, q);
+        encrypt(keys, rounds, q);
+        store(q, count, keyStream);
+
+        const size_t bytes = len - offset < count * 16u ? len - offset : count * 16u;
+        for (size_t i = 0; i < bytes; ++i) {
+            *shift_ptr(out, offset + i) = *shift_ptr(in, offset + i) ^ keyStream[i];
+        }
+        offset += bytes;
+    }
+
+    *shift_ptr(counter, 12u) = uint8_t(ctr >> 24);
+    *shift_ptr(counter, 13u) = uint8_t(ctr >> 16);
+    *shift_ptr(counter, 14u) = uint8_t(ctr >> 8);
+    *shift_ptr(counter, 15u) = uint8_t(ctr);
+
+    mem_wipe(keyStream, sizeof(keyStream));
+    mem_wipe(reinterpret_cast<uint8_t *>(keys.data()), sizeof(keys));
+}
+
+} // namespace psi::tools::crypt
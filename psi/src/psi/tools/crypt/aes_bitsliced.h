@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief Constant-time bitsliced software backend of aes.
+ * Blocks are processed 8 at a time in two sets of eight 64-bit words, S-box is evaluated as boolean circuit,
+ * so neither memory access pattern nor timing depends on key or data.
+ * Round keys are laid out exactly as produced by aes::generateSubKeys_impl, 16 bytes per round.
+ *
+ */
+class aes_bitsliced
+{
+public:
+    static void encryptBlocks(const uint8_t *roundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void decryptBlocks(const uint8_t *roundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void ctr32Xor(const uint8_t *roundKeys,
+                         uint8_t rounds,
+                         uint8_t *counter,
+                         const uint8_t *in,
+                         uint8_t *out,
+                         size_t len);
+};
+
+} // namespace psi::tools::crypt
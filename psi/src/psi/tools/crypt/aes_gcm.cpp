@@ -4,8 +4,12 @@
  */
 #include "aes_gcm.h"
 #include "aes.h"
+#include "ghash_clmul.h"
+#include "parallel.h"
 
+#include <algorithm>
 #include <array>
+#include <vector>
 
 #ifdef PSI_LOGGER
 #include "psi/logger/Logger.h"
@@ -48,9 +52,26 @@ void aes_gcm::xorBlocksInPlace(const uint8_t *src, DataBlock16 &dst)
     }
 }
 
+void aes_gcm::xorBytes(const uint8_t *a, const uint8_t *b, uint8_t *result, size_t len)
+{
+    size_t i = 0;
+    for (; i + 8u <= len; i += 8u) {
+        uint64_t x = 0;
+        uint64_t y = 0;
+        mem_copy(&x, 0, a, i, 8u);
+        mem_copy(&y, 0, b, i, 8u);
+        x ^= y;
+        mem_copy(result, i, &x, 0, 8u);
+    }
+    for (; i < len; ++i) {
+        *shift_ptr(result, i) = *shift_ptr(a, i) ^ *shift_ptr(b, i);
+    }
+}
+
 void aes_gcm::incr(DataBlock16 &counter)
 {
-    for (size_t i = 16; i != 0; --i) {
+    // only the rightmost 32 bits are incremented (inc32)
+    for (size_t i = 16; i != 12; --i) {
         if (++counter[i - 1] != 0) {
             break;
         }
@@ -96,6 +117,96 @@ void aes_gcm::gfMultBlock(const DataBlock16 &x, const DataBlock16 &y, DataBlock1
     z = p;
 }
 
+// Shoup's 4-bit method: table[i] = i * H, where bits of nibble i are taken in GCM (reflected) order
+void aes_gcm::makeTable(const DataBlock16 &h, GHashTable &table)
+{
+    uint64_t vh = 0;
+    uint64_t vl = 0;
+    for (size_t i = 0; i < 8u; ++i) {
+        vh = (vh << 8) | h[i];
+        vl = (vl << 8) | h[i + 8u];
+    }
+
+    table[0] = {0, 0};
+    table[8] = {vh, vl};
+    for (size_t i = 4; i > 0; i >>= 1) {
+        const uint64_t t = (vl & 1u) ? 0xe100000000000000ull : 0ull;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ t;
+        table[i] = {vh, vl};
+    }
+    for (size_t i = 2; i <= 8u; i <<= 1) {
+        for (size_t j = 1; j < i; ++j) {
+            table[i + j] = {table[i][0] ^ table[j][0], table[i][1] ^ table[j][1]};
+        }
+    }
+}
+
+// reduction of 4 bits shifted out of the low end, already positioned in the top 16 bits
+const std::array<uint64_t, 16u> aes_gcm::m_last4 = {0x0000,
+                                                   0x1c20,
+                                                   0x3840,
+                                                   0x2460,
+                                                   0x7080,
+                                                   0x6ca0,
+                                                   0x48c0,
+                                                   0x54e0,
+                                                   0xe100,
+                                                   0xfd20,
+                                                   0xd940,
+                                                   0xc560,
+                                                   0x9180,
+                                                   0x8da0,
+                                                   0xa9c0,
+                                                   0xb5e0};
+
+void aes_gcm::gfMultTable(const GHashTable &table, DataBlock16 &x)
+{
+    uint64_t zh = table[x[15] & 0x0f][0];
+    uint64_t zl = table[x[15] & 0x0f][1];
+
+    for (size_t i = 16; i != 0; --i) {
+        const uint8_t lo = x[i - 1] & 0x0f;
+        const uint8_t hi = x[i - 1] >> 4;
+
+        if (i != 16) {
+            const uint8_t rem = zl & 0x0f;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (m_last4[rem] << 48);
+            zh ^= table[lo][0];
+            zl ^= table[lo][1];
+        }
+
+        const uint8_t rem = zl & 0x0f;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (m_last4[rem] << 48);
+        zh ^= table[hi][0];
+        zl ^= table[hi][1];
+    }
+
+    for (size_t i = 0; i < 8u; ++i) {
+        x[i] = uint8_t(zh >> (56u - i * 8u));
+        x[i + 8u] = uint8_t(zl >> (56u - i * 8u));
+    }
+}
+
+void aes_gcm::prepareKey(AesKey &key)
+{
+    // H: E(K, 0^128);
+    DataBlock16 h = {};
+    aes::encryptBlock(key, h.data(), h.data());
+    makeTable(h, key.m_gHashTable);
+    if (ghash_clmul::isSupported()) {
+        ghash_clmul::prepareKey(h.data(), key.m_gHashPowers[0].data());
+    }
+}
+
+aes_gcm::GHashBackend aes_gcm::ghashBackend()
+{
+    static const GHashBackend selected = ghash_clmul::isSupported() ? GHashBackend::Pclmul : GHashBackend::Table;
+    return selected;
+}
+
 // GHASH(H,A,C) = X[m+n+1]
 // X[i] = 0                                 // for i = 0
 // (X[i-1] XOR A[i]) mul H                  // for i = 1, ..., m - 1
@@ -103,109 +214,237 @@ void aes_gcm::gfMultBlock(const DataBlock16 &x, const DataBlock16 &y, DataBlock1
 // (X[i-1] XOR C[i]) mul H                  // for i = m + 1, ..., m + n - 1
 // (X[m+n-1] XOR (C*[m] || 0^128-u)) mul H  // for i = m + n
 // (X[m+n] XOR (len(A) || len(C))) mul H    // for i = m + n + 1
-void aes_gcm::ghashBlock(const DataBlock16 &h, const uint8_t *data, size_t dataLen, DataBlock16 &result)
+void aes_gcm::ghashBlock(const AesKey &key, const uint8_t *data, size_t dataLen, DataBlock16 &result)
 {
-    DataBlock16 temp = result;
+    ghashBlock(ghashBackend(), key, data, dataLen, result);
+}
 
+void aes_gcm::ghashBlock(GHashBackend backend,
+                         const AesKey &key,
+                         const uint8_t *data,
+                         size_t dataLen,
+                         DataBlock16 &result)
+{
     const size_t m = dataLen / 16u;
-    for (size_t i = 0; i < m; ++i) {
-        xorBlocksInPlace(shift_ptr(data, i * 16u), temp);
-        gfMultBlock(temp, h, temp);
+    switch (backend) {
+    case GHashBackend::Pclmul:
+        ghash_clmul::update(key.m_gHashPowers[0].data(), result.data(), data, m);
+        break;
+    case GHashBackend::Table:
+        for (size_t i = 0; i < m; ++i) {
+            xorBlocksInPlace(shift_ptr(data, i * 16u), result);
+            gfMultTable(key.m_gHashTable, result);
+        }
+        break;
     }
 
     if (auto extra = dataLen % 16u) {
         DataBlock16 tempExtra = {};
         mem_copy(tempExtra.data(), 0, data, m * 16u, extra);
-
-        xorBlocksInPlace(tempExtra.data(), temp);
-        gfMultBlock(temp, h, temp);
+        ghashBlock(backend, key, tempExtra.data(), 16u, result);
     }
-
-    result = temp;
 }
 
-void aes_gcm::ghash(const DataBlock16 &h, const uint8_t *acc, size_t accLen, const uint8_t *cipher, size_t cipherLen, DataBlock16 &result)
+void aes_gcm::ghash(const AesKey &key,
+                    const uint8_t *acc,
+                    size_t accLen,
+                    const uint8_t *cipher,
+                    size_t cipherLen,
+                    DataBlock16 &result)
 {
-    // std::memset(result.data(), 0, 16);
-
     DataBlock16 hashBlock = {};
 
-    ghashBlock(h, acc, accLen, hashBlock);
-    ghashBlock(h, cipher, cipherLen, hashBlock);
+    ghashBlock(key, acc, accLen, hashBlock);
+    ghashBlock(key, cipher, cipherLen, hashBlock);
 
     DataBlock16 lengthBlock = {};
+    encodeLengths(accLen, cipherLen, lengthBlock);
+    ghashBlock(key, lengthBlock.data(), 16u, hashBlock);
+    result = hashBlock;
+}
+
+// len(A) || len(C), both in bits as 64-bit big-endian values
+void aes_gcm::encodeLengths(uint64_t accLen, uint64_t cipherLen, DataBlock16 &block)
+{
     accLen *= 8u;
-    lengthBlock[4] = uint8_t(accLen >> 24);
-    lengthBlock[5] = uint8_t(accLen >> 16);
-    lengthBlock[6] = uint8_t(accLen >> 8);
-    lengthBlock[7] = uint8_t(accLen);
     cipherLen *= 8u;
-    lengthBlock[12] = uint8_t(cipherLen >> 24);
-    lengthBlock[13] = uint8_t(cipherLen >> 16);
-    lengthBlock[14] = uint8_t(cipherLen >> 8);
-    lengthBlock[15] = uint8_t(cipherLen);
-    xorBlocks(hashBlock, lengthBlock, hashBlock);
-    gfMultBlock(hashBlock, h, result);
+    for (size_t i = 0; i < 8u; ++i) {
+        block[i] = uint8_t(accLen >> (56u - i * 8u));
+        block[i + 8u] = uint8_t(cipherLen >> (56u - i * 8u));
+    }
 }
 
-ByteBuffer aes_gcm::encrypt(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv, Tag &tag, const ByteBuffer &acc)
+// Y[0]: IV || 0^31 1;          // if len(IV) = 96 bits
+// Y[0]: GHASH(H,{},IV);        // otherwise
+void aes_gcm::initCounter(const AesKey &key, const uint8_t *iv, size_t ivLen, DataBlock16 &counter)
 {
-    ByteBuffer out(data.size());
-
-    // H: E(K, 0^128);
-    DataBlock16 h = {};
-    aes::encryptAes_impl<4, 10>(DataBlock16().data(), 16u, key).read(h);
-
-    // Y[0]: IV || 0^31;            // if len(IV) = 96 bits
-    // Y[0]: GHASH(H,{},IV);        // otherwise
-    DataBlock16 counter = {};
-    if (iv.length() == 12u) {
-        iv.readBytes(counter.data(), 12u);
+    counter = {};
+    if (ivLen == 12u) {
+        mem_copy(counter.data(), 0, iv, 0, 12u);
         counter[15] = 0x01;
     } else {
-        ghash(h, DataBlock16().data(), 0, iv.length() ? iv.data() : DataBlock16().data(), iv.length(), counter);
+        ghash(key, DataBlock16().data(), 0, ivLen ? iv : DataBlock16().data(), ivLen, counter);
     }
+}
 
-    DataBlock16 y0_encrypted = {};
-    aes::encryptAes_impl<4, 10>(counter.data(), 16u, key).read(y0_encrypted);
+ByteBuffer aes_gcm::encrypt(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv, Tag &tag, const ByteBuffer &acc)
+{
+    return encrypt(data, AesKey(key), iv, tag, acc);
+}
 
-    // Y[i]: incr(Y[i-1])           // for i = 1, ..., n - 1
-    // C[i]: P[i] XOR E(K, Y[i])    // for i = 1, ..., n - 1
-    const size_t n = data.length() / 16u;
-    for (size_t i = 0; i < n; ++i) {
-        incr(counter);
-        // printBlockHex(counter, "y[i]: ");
+// data is processed in chunks small enough to stay in L1 cache between GHASH and CTR passes,
+// so every chunk is read from memory only once; cipher text is hashed before in-place decryption overwrites it
+void aes_gcm::cryptAndHashSegment(const AesKey &key,
+                                  DataBlock16 &counter,
+                                  const uint8_t *in,
+                                  size_t len,
+                                  uint8_t *out,
+                                  bool isDecrypt,
+                                  DataBlock16 &hashBlock)
+{
+    for (size_t offset = 0; offset < len; offset += FUSED_CHUNK) {
+        const size_t sz = std::min(FUSED_CHUNK, len - offset);
+        if (isDecrypt) {
+            ghashBlock(key, shift_ptr(in, offset), sz, hashBlock);
+            aes::ctr32Xor(key, counter.data(), shift_ptr(in, offset), shift_ptr(out, offset), sz);
+        } else {
+            aes::ctr32Xor(key, counter.data(), shift_ptr(in, offset), shift_ptr(out, offset), sz);
+            ghashBlock(key, shift_ptr(out, offset), sz, hashBlock);
+        }
+    }
+}
+
+// X * H^n, where n is number of blocks in segment
+void aes_gcm::hashKeyPower(const AesKey &key, size_t n, DataBlock16 &result)
+{
+    // table[8] keeps H itself
+    DataBlock16 base = {};
+    for (size_t i = 0; i < 8u; ++i) {
+        base[i] = uint8_t(key.m_gHashTable[8][0] >> (56u - i * 8u));
+        base[i + 8u] = uint8_t(key.m_gHashTable[8][1] >> (56u - i * 8u));
+    }
 
-        DataBlock16 cipherBlock = {};
-        DataBlock16 dataBlock = {};
-        data.read(dataBlock);
-        aes::encryptAes_impl<4, 10>(counter.data(), 16, key).read(cipherBlock);
-        xorBlocks(dataBlock, cipherBlock, cipherBlock);
+    // 1 in GCM bit order
+    result = {};
+    result[0] = 0x80;
+    for (; n != 0; n >>= 1) {
+        if (n & 1u) {
+            gfMultBlock(result, base, result);
+        }
+        gfMultBlock(base, base, base);
+    }
+}
 
-        out.write(cipherBlock);
+// segments are independent: each one starts from its own counter and zero hash state S[j], then
+// GHASH = (...((X[A] * H^n[0] XOR S[0]) * H^n[1] XOR S[1])...) gives exactly the sequential result
+void aes_gcm::cryptAndHashParallel(const AesKey &key,
+                                   const DataBlock16 &counter,
+                                   const uint8_t *in,
+                                   size_t len,
+                                   uint8_t *out,
+                                   bool isDecrypt,
+                                   DataBlock16 &hashBlock)
+{
+    const size_t segments = (len + PARALLEL_SEGMENT - 1u) / PARALLEL_SEGMENT;
+    std::vector<DataBlock16> hashes(segments);
+
+    parallel::forEach(segments, [&](size_t j) {
+        const size_t offset = j * PARALLEL_SEGMENT;
+        DataBlock16 segmentCounter = counter;
+        addCounter(segmentCounter, uint32_t(offset / 16u));
+        hashes[j] = {};
+        cryptAndHashSegment(key,
+                            segmentCounter,
+                            shift_ptr(in, offset),
+                            std::min(PARALLEL_SEGMENT, len - offset),
+                            shift_ptr(out, offset),
+                            isDecrypt,
+                            hashes[j]);
+    });
+
+    DataBlock16 fullPower = {};
+    hashKeyPower(key, PARALLEL_SEGMENT / 16u, fullPower);
+    DataBlock16 lastPower = {};
+    hashKeyPower(key, (len - (segments - 1u) * PARALLEL_SEGMENT + 15u) / 16u, lastPower);
+
+    for (size_t j = 0; j < segments; ++j) {
+        gfMultBlock(hashBlock, j + 1u == segments ? lastPower : fullPower, hashBlock);
+        xorBlocks(hashBlock, hashes[j], hashBlock);
     }
+}
 
-    if (auto extra = data.length() % 16u) {
-        incr(counter);
+void aes_gcm::addCounter(DataBlock16 &counter, uint32_t blocks)
+{
+    uint32_t value = uint32_t(counter[12] << 24) | uint32_t(counter[13] << 16) | uint32_t(counter[14] << 8) | counter[15];
+    value += blocks;
+    counter[12] = uint8_t(value >> 24);
+    counter[13] = uint8_t(value >> 16);
+    counter[14] = uint8_t(value >> 8);
+    counter[15] = uint8_t(value);
+}
 
-        DataBlock16 cipherBlock = {};
-        DataBlock16 dataBlock = {};
-        data.readBytes(dataBlock.data(), extra);
-        aes::encryptAes_impl<4, 10>(counter.data(), 16, key).read(cipherBlock);
-        xorBlocks(dataBlock, cipherBlock, cipherBlock);
+void aes_gcm::cryptAndHash(const AesKey &key,
+                           const uint8_t *iv,
+                           size_t ivLen,
+                           const uint8_t *acc,
+                           size_t accLen,
+                           const uint8_t *in,
+                           size_t len,
+                           uint8_t *out,
+                           bool isDecrypt,
+                           Tag &tag)
+{
+    DataBlock16 counter = {};
+    initCounter(key, iv, ivLen, counter);
 
-        out.writeArray(cipherBlock.data(), extra);
-    }
+    DataBlock16 y0_encrypted = {};
+    aes::encryptBlock(key, counter.data(), y0_encrypted.data());
 
+    DataBlock16 hashBlock = {};
+    ghashBlock(key, accLen ? acc : DataBlock16().data(), accLen, hashBlock);
+
+    // Y[i]: incr(Y[i-1])           // for i = 1, ..., n
+    // C[i]: P[i] XOR E(K, Y[i])    // for i = 1, ..., n - 1
     // C*[n]: P*[n] XOR MSB[u](E(K, Y[n]))      // u - number of bits in final block
+    incr(counter);
+    if (len >= parallel::THRESHOLD) {
+        cryptAndHashParallel(key, counter, in, len, out, isDecrypt, hashBlock);
+    } else {
+        cryptAndHashSegment(key, counter, in, len, out, isDecrypt, hashBlock);
+    }
+
     // T: MSB[t](GHASH(H,A,C) XOR E(K, Y[0]))
-    ghash(h,
-          acc.length() ? acc.data() : DataBlock16().data(),
-          acc.length(),
-          out.length() ? out.data() : DataBlock16().data(),
-          out.length(),
-          tag);
-    xorBlocks(tag, y0_encrypted, tag);
+    DataBlock16 lengthBlock = {};
+    encodeLengths(accLen, len, lengthBlock);
+    ghashBlock(key, lengthBlock.data(), 16u, hashBlock);
+    xorBlocks(hashBlock, y0_encrypted, tag);
+}
+
+bool aes_gcm::encrypt(const uint8_t *data,
+                      size_t dataLen,
+                      const AesKey &key,
+                      const uint8_t *iv,
+                      size_t ivLen,
+                      const uint8_t *acc,
+                      size_t accLen,
+                      uint8_t *out,
+                      Tag &tag)
+{
+    if (!key.isValid() || dataLen > MAX_DATA_LENGTH) {
+        return false;
+    }
+
+    cryptAndHash(key, iv, ivLen, acc, accLen, data, dataLen, out, false, tag);
+    return true;
+}
+
+ByteBuffer aes_gcm::encrypt(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv, Tag &tag, const ByteBuffer &acc)
+{
+    ByteBuffer out(data.size());
+    if (!encrypt(data.data(), data.length(), key, iv.data(), iv.length(), acc.data(), acc.length(), out.data(), tag)) {
+        return {};
+    }
+    out.skipWrite(data.length());
 
     return out;
 }
@@ -222,75 +461,272 @@ ByteBuffer aes_gcm::decrypt(const ByteBuffer &data,
                             const ByteBuffer &tag,
                             const ByteBuffer &acc)
 {
-    // H: E(K, 0^128);
-    DataBlock16 h = {};
-    aes::encryptAes_impl<4, 10>(DataBlock16().data(), 16u, key).read(h);
+    return decrypt(data, AesKey(key), iv, tag, acc);
+}
 
-    // Y[0]: IV || 0^31;            // if len(IV) = 96 bits
-    // Y[0]: GHASH(H,{},IV);        // otherwise
-    DataBlock16 counter = {};
-    if (iv.length() == 12u) {
-        iv.readBytes(counter.data(), 12u);
-        counter[15] = 0x01;
-    } else {
-        ghash(h, DataBlock16().data(), 0, iv.length() ? iv.data() : DataBlock16().data(), iv.length(), counter);
+bool aes_gcm::decrypt(const uint8_t *data,
+                      size_t dataLen,
+                      const AesKey &key,
+                      const uint8_t *iv,
+                      size_t ivLen,
+                      const uint8_t *acc,
+                      size_t accLen,
+                      const uint8_t *tag,
+                      size_t tagLen,
+                      uint8_t *out)
+{
+    Tag deTag = {};
+    if (!key.isValid() || tagLen != deTag.size() || dataLen > MAX_DATA_LENGTH) {
+        return false;
     }
 
-    DataBlock16 y0_encrypted = {};
-    aes::encryptAes_impl<4, 10>(counter.data(), 16u, key).read(y0_encrypted);
+    cryptAndHash(key, iv, ivLen, acc, accLen, data, dataLen, out, true, deTag);
+    if (!mem_equal_ct(deTag.data(), tag, deTag.size())) {
+        mem_wipe(out, dataLen);
+        return false;
+    }
 
-    // C*[n]: P*[n] XOR MSB[u](E(K, Y[n]))      // u - number of bits in final block
-    // T: MSB[t](GHASH(H,A,C) XOR E(K, Y[0]))
-    DataBlock16 deTag = {};
-    ghash(h,
-          acc.length() ? acc.data() : DataBlock16().data(),
-          acc.length(),
-          data.length() ? data.data() : DataBlock16().data(),
-          data.length(),
-          deTag);
-    xorBlocks(deTag, y0_encrypted, deTag);
-    const uint8_t* ptr = deTag.data();
-    ByteBuffer deTagBuffer(ptr, 16);
-    if (tag.size() && deTagBuffer.asHexString() != tag.asHexString()) {
-        LOG_ERROR_STATIC("deTag: " << deTagBuffer.asHexString());
-        LOG_ERROR_STATIC("tag: " << tag.asHexString());
+    return true;
+}
+
+ByteBuffer aes_gcm::decrypt(const ByteBuffer &data,
+                            const AesKey &key,
+                            const ByteBuffer &iv,
+                            const ByteBuffer &tag,
+                            const ByteBuffer &acc)
+{
+    if (!key.isValid() || data.size() > MAX_DATA_LENGTH) {
         return {};
     }
 
     ByteBuffer out(data.size());
-    // Y[i]: incr(Y[i-1])           // for i = 1, ..., n - 1
-    // C[i]: P[i] XOR E(K, Y[i])    // for i = 1, ..., n - 1
-    const size_t n = data.length() / 16u;
-    for (size_t i = 0; i < n; ++i) {
-        incr(counter);
+    if (!decrypt(data.data(),
+                 data.length(),
+                 key,
+                 iv.data(),
+                 iv.length(),
+                 acc.data(),
+                 acc.length(),
+                 tag.data(),
+                 tag.size(),
+                 out.data())) {
+        LOG_ERROR_STATIC("aes_gcm: tag mismatch");
+        return {};
+    }
+    out.skipWrite(data.length());
+
+    return out;
+}
+
+ByteBuffer aes_gcm::decrypt(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &tag)
+{
+    return decrypt(data, key, {}, tag);
+}
+
+// key stream of record: E(K, Y[0]) followed by E(K, Y[i]) for every data block
+bool aes_gcm::finishRecord(const AesKey &key, GcmRecord &record, const uint8_t *keyStream, bool isDecrypt)
+{
+    const size_t len = record.in.size();
+
+    DataBlock16 hashBlock = {};
+    ghashBlock(key, record.aad.size() ? record.aad.data() : DataBlock16().data(), record.aad.size(), hashBlock);
+    if (isDecrypt) {
+        ghashBlock(key, record.in.data(), len, hashBlock);
+    }
+    xorBytes(record.in.data(), shift_ptr(keyStream, 16u), record.out.data(), len);
+    if (!isDecrypt) {
+        ghashBlock(key, record.out.data(), len, hashBlock);
+    }
 
-        DataBlock16 cipherBlock = {};
-        DataBlock16 dataBlock = {};
-        data.read(dataBlock);
-        aes::encryptAes_impl<4, 10>(counter.data(), 16, key).read(cipherBlock);
-        xorBlocks(dataBlock, cipherBlock, cipherBlock);
+    DataBlock16 lengthBlock = {};
+    encodeLengths(record.aad.size(), len, lengthBlock);
+    ghashBlock(key, lengthBlock.data(), 16u, hashBlock);
+    xorBlocksInPlace(keyStream, hashBlock);
 
-        out.write(cipherBlock);
+    if (!isDecrypt) {
+        mem_copy(record.tag.data(), 0, hashBlock.data(), 0, 16u);
+        return true;
     }
 
-    if (auto extra = data.length() % 16u) {
-        incr(counter);
+    if (!mem_equal_ct(hashBlock.data(), record.tag.data(), 16u)) {
+        mem_wipe(record.out.data(), len);
+        return false;
+    }
+    return true;
+}
 
-        DataBlock16 cipherBlock = {};
-        DataBlock16 dataBlock = {};
-        data.readBytes(dataBlock.data(), extra);
-        aes::encryptAes_impl<4, 10>(counter.data(), 16, key).read(cipherBlock);
-        xorBlocks(dataBlock, cipherBlock, cipherBlock);
+// counter blocks of consecutive records are collected into one buffer and encrypted by a single call,
+// so hardware backend keeps all its lanes busy even for records of a few blocks
+size_t aes_gcm::cryptBatch(const AesKey &key, std::span<GcmRecord> records, bool isDecrypt)
+{
+    alignas(16) uint8_t keyStream[BATCH_BLOCKS * 16u];
+    std::array<size_t, BATCH_BLOCKS> offsets = {};
+
+    size_t succeeded = 0;
+    for (size_t i = 0; i < records.size();) {
+        size_t used = 0;
+        size_t count = 0;
+        for (; i + count < records.size(); ++count) {
+            GcmRecord &record = records[i + count];
+            record.ok = false;
+
+            const bool isValid = key.isValid() && record.out.size() >= record.in.size()
+                && (isDecrypt ? record.tag.size() == 16u : record.tag.size() >= 16u);
+            const size_t blocks = isValid ? 1u + (record.in.size() + 15u) / 16u : 0u;
+            if (blocks > BATCH_BLOCKS || used + blocks > BATCH_BLOCKS) {
+                break;
+            }
+
+            offsets[count] = used;
+            if (blocks == 0u) {
+                continue;
+            }
+
+            DataBlock16 counter = {};
+            initCounter(key, record.iv.data(), record.iv.size(), counter);
+            for (size_t n = 0; n < blocks; ++n) {
+                mem_copy(keyStream, (used + n) * 16u, counter.data(), 0, 16u);
+                incr(counter);
+            }
+            used += blocks;
+        }
 
-        out.writeArray(cipherBlock.data(), extra);
+        if (count == 0u) {
+            // record does not fit into batch buffer
+            GcmRecord &record = records[i++];
+            if (isDecrypt) {
+                record.ok = decrypt(record.in.data(),
+                                    record.in.size(),
+                                    key,
+                                    record.iv.data(),
+                                    record.iv.size(),
+                                    record.aad.data(),
+                                    record.aad.size(),
+                                    record.tag.data(),
+                                    record.tag.size(),
+                                    record.out.data());
+            } else {
+                Tag tag = {};
+                record.ok = encrypt(record.in.data(),
+                                    record.in.size(),
+                                    key,
+                                    record.iv.data(),
+                                    record.iv.size(),
+                                    record.aad.data(),
+                                    record.aad.size(),
+                                    record.out.data(),
+                                    tag);
+                mem_copy(record.tag.data(), 0, tag.data(), 0, 16u);
+            }
+            succeeded += record.ok;
+            continue;
+        }
+
+        aes::encryptBlocks(aes::ctrBackend(), key, keyStream, keyStream, used);
+
+        for (size_t n = 0; n < count; ++n) {
+            GcmRecord &record = records[i + n];
+            const size_t next = n + 1u < count ? offsets[n + 1u] : used;
+            if (next != offsets[n]) {
+                record.ok = finishRecord(key, record, shift_ptr(keyStream, offsets[n] * 16u), isDecrypt);
+                succeeded += record.ok;
+            }
+        }
+        i += count;
     }
 
-    return out;
+    mem_wipe(keyStream, sizeof(keyStream));
+    return succeeded;
 }
 
-ByteBuffer aes_gcm::decrypt(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &tag)
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes_gcm::encrypt_impl(const ByteBuffer &data, const ByteBuffer &key, const ByteBuffer &iv, Tag &tag, const ByteBuffer &acc)
 {
-    return decrypt(data, key, {}, tag);
+    if (key.size() != Nk * 4u) {
+        return {};
+    }
+
+    return encrypt(data, AesKey(key), iv, tag, acc);
 }
 
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes_gcm::encrypt_impl(const ByteBuffer &data, const AesKey &key, const ByteBuffer &iv, Tag &tag, const ByteBuffer &acc)
+{
+    if (key.rounds() != Nr) {
+        return {};
+    }
+
+    return encrypt(data, key, iv, tag, acc);
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes_gcm::decrypt_impl(const ByteBuffer &data,
+                                 const ByteBuffer &key,
+                                 const ByteBuffer &iv,
+                                 const ByteBuffer &tag,
+                                 const ByteBuffer &acc)
+{
+    if (key.size() != Nk * 4u) {
+        return {};
+    }
+
+    return decrypt(data, AesKey(key), iv, tag, acc);
+}
+
+template <uint8_t Nk, uint8_t Nr>
+ByteBuffer aes_gcm::decrypt_impl(const ByteBuffer &data,
+                                 const AesKey &key,
+                                 const ByteBuffer &iv,
+                                 const ByteBuffer &tag,
+                                 const ByteBuffer &acc)
+{
+    if (key.rounds() != Nr) {
+        return {};
+    }
+
+    return decrypt(data, key, iv, tag, acc);
+}
+
+template ByteBuffer aes_gcm::encrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  Tag &,
+                                                  const ByteBuffer &);
+template ByteBuffer aes_gcm::encrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                  const AesKey &,
+                                                  const ByteBuffer &,
+                                                  Tag &,
+                                                  const ByteBuffer &);
+template ByteBuffer aes_gcm::decrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &);
+template ByteBuffer aes_gcm::decrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                  const AesKey &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &);
+
+template ByteBuffer aes_gcm::encrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  Tag &,
+                                                  const ByteBuffer &);
+template ByteBuffer aes_gcm::encrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                  const AesKey &,
+                                                  const ByteBuffer &,
+                                                  Tag &,
+                                                  const ByteBuffer &);
+template ByteBuffer aes_gcm::decrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &);
+template ByteBuffer aes_gcm::decrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                  const AesKey &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &,
+                                                  const ByteBuffer &);
+
 } // namespace psi::tools::crypt
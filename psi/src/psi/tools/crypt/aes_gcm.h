@@ -1,6 +1,8 @@
 #pragma once
 
+#include "psi/tools/AesKey.h"
 #include "psi/tools/ByteBuffer.h"
+#include "psi/tools/GcmBatch.h"
 
 #include <array>
 
@@ -11,12 +13,39 @@ class aes_gcm
 public:
     using DataBlock16 = std::array<uint8_t, 16>;
     using Tag = DataBlock16;
+    using GHashTable = AesKey::GHashTable;
+
+    // SP 800-38D limit of payload processed with one IV, (2^32 - 2) blocks
+    static constexpr uint64_t MAX_DATA_LENGTH = (0xffffffffull - 1u) * 16u;
+
+    enum class GHashBackend : uint8_t
+    {
+        Table,
+        Pclmul
+    };
 
     static void gfMultBlock(const DataBlock16 &x, const DataBlock16 &y, DataBlock16 &z);
-    static void ghashBlock(const DataBlock16 &h, const uint8_t *data, size_t dataLen, DataBlock16 &result);
-    static void ghash(const DataBlock16 &h, const uint8_t *acc, size_t accLen, const uint8_t *cipher, size_t cipherLen, DataBlock16 &result);
+    static void makeTable(const DataBlock16 &h, GHashTable &table);
+    static void gfMultTable(const GHashTable &table, DataBlock16 &x);
+    static void prepareKey(AesKey &key);
+    static GHashBackend ghashBackend();
+    static void ghashBlock(const AesKey &key, const uint8_t *data, size_t dataLen, DataBlock16 &result);
+    static void ghashBlock(GHashBackend backend,
+                           const AesKey &key,
+                           const uint8_t *data,
+                           size_t dataLen,
+                           DataBlock16 &result);
+    static void ghash(const AesKey &key,
+                      const uint8_t *acc,
+                      size_t accLen,
+                      const uint8_t *cipher,
+                      size_t cipherLen,
+                      DataBlock16 &result);
+    static void encodeLengths(uint64_t accLen, uint64_t cipherLen, DataBlock16 &block);
+    static void initCounter(const AesKey &key, const uint8_t *iv, size_t ivLen, DataBlock16 &counter);
     static void xorBlocks(const DataBlock16 &a, const DataBlock16 &b, DataBlock16 &result);
     static void xorBlocksInPlace(const uint8_t *src, DataBlock16 &dst);
+    static void xorBytes(const uint8_t *a, const uint8_t *b, uint8_t *result, size_t len);
     static void gfMult(const uint8_t x, const uint8_t y, uint8_t &z);
     static void incr(DataBlock16 &counter);
     static ByteBuffer encrypt(const ByteBuffer &data,
@@ -31,9 +60,146 @@ public:
                               const ByteBuffer &tag,
                               const ByteBuffer &acc = {});
     static ByteBuffer decrypt(const ByteBuffer &encryptedData, const ByteBuffer &key, const ByteBuffer &tag);
+    static ByteBuffer encrypt(const ByteBuffer &data,
+                              const AesKey &key,
+                              const ByteBuffer &iv,
+                              Tag &tag,
+                              const ByteBuffer &acc = {});
+    static ByteBuffer decrypt(const ByteBuffer &encryptedData,
+                              const AesKey &key,
+                              const ByteBuffer &iv,
+                              const ByteBuffer &tag,
+                              const ByteBuffer &acc = {});
+    static bool encrypt(const uint8_t *data,
+                        size_t dataLen,
+                        const AesKey &key,
+                        const uint8_t *iv,
+                        size_t ivLen,
+                        const uint8_t *acc,
+                        size_t accLen,
+                        uint8_t *out,
+                        Tag &tag);
+    static bool decrypt(const uint8_t *encryptedData,
+                        size_t dataLen,
+                        const AesKey &key,
+                        const uint8_t *iv,
+                        size_t ivLen,
+                        const uint8_t *acc,
+                        size_t accLen,
+                        const uint8_t *tag,
+                        size_t tagLen,
+                        uint8_t *out);
+
+    static size_t cryptBatch(const AesKey &key, std::span<GcmRecord> records, bool isDecrypt);
+
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer encrypt_impl(const ByteBuffer &data,
+                                   const ByteBuffer &key,
+                                   const ByteBuffer &iv,
+                                   Tag &tag,
+                                   const ByteBuffer &acc = {});
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer encrypt_impl(const ByteBuffer &data,
+                                   const AesKey &key,
+                                   const ByteBuffer &iv,
+                                   Tag &tag,
+                                   const ByteBuffer &acc = {});
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer decrypt_impl(const ByteBuffer &encryptedData,
+                                   const ByteBuffer &key,
+                                   const ByteBuffer &iv,
+                                   const ByteBuffer &tag,
+                                   const ByteBuffer &acc = {});
+    template <uint8_t Nk, uint8_t Nr>
+    static ByteBuffer decrypt_impl(const ByteBuffer &encryptedData,
+                                   const AesKey &key,
+                                   const ByteBuffer &iv,
+                                   const ByteBuffer &tag,
+                                   const ByteBuffer &acc = {});
 
 private:
+    static void cryptAndHash(const AesKey &key,
+                             const uint8_t *iv,
+                             size_t ivLen,
+                             const uint8_t *acc,
+                             size_t accLen,
+                             const uint8_t *in,
+                             size_t len,
+                             uint8_t *out,
+                             bool isDecrypt,
+                             Tag &tag);
+
+    static void cryptAndHashSegment(const AesKey &key,
+                                    DataBlock16 &counter,
+                                    const uint8_t *in,
+                                    size_t len,
+                                    uint8_t *out,
+                                    bool isDecrypt,
+                                    DataBlock16 &hashBlock);
+    static void cryptAndHashParallel(const AesKey &key,
+                                     const DataBlock16 &counter,
+                                     const uint8_t *in,
+                                     size_t len,
+                                     uint8_t *out,
+                                     bool isDecrypt,
+                                     DataBlock16 &hashBlock);
+    static void hashKeyPower(const AesKey &key, size_t n, DataBlock16 &result);
+    static void addCounter(DataBlock16 &counter, uint32_t blocks);
+
+    static bool finishRecord(const AesKey &key,
+                             GcmRecord &record,
+                             const uint8_t *keyStream,
+                             bool isDecrypt);
+
+    static constexpr size_t FUSED_CHUNK = 16u * 64u;
+    // number of counter blocks of batch records encrypted by one call
+    static constexpr size_t BATCH_BLOCKS = 64u;
+    // messages from parallel::THRESHOLD are split into segments processed by separate threads
+    static constexpr size_t PARALLEL_SEGMENT = 1024u * 1024u;
     static const uint8_t R_POLY;
+    static const std::array<uint64_t, 16u> m_last4;
 };
 
+extern template ByteBuffer aes_gcm::encrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         Tag &,
+                                                         const ByteBuffer &);
+extern template ByteBuffer aes_gcm::encrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                         const AesKey &,
+                                                         const ByteBuffer &,
+                                                         Tag &,
+                                                         const ByteBuffer &);
+extern template ByteBuffer aes_gcm::decrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &);
+extern template ByteBuffer aes_gcm::decrypt_impl<4u, 10u>(const ByteBuffer &,
+                                                         const AesKey &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &);
+
+extern template ByteBuffer aes_gcm::encrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         Tag &,
+                                                         const ByteBuffer &);
+extern template ByteBuffer aes_gcm::encrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                         const AesKey &,
+                                                         const ByteBuffer &,
+                                                         Tag &,
+                                                         const ByteBuffer &);
+extern template ByteBuffer aes_gcm::decrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &);
+extern template ByteBuffer aes_gcm::decrypt_impl<8u, 14u>(const ByteBuffer &,
+                                                         const AesKey &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &,
+                                                         const ByteBuffer &);
+
 } // namespace psi::tools::crypt
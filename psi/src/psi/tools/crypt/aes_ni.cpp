@@ -0,0 +1,260 @@
+/**
+ * @brief https://www.intel.com/content/dam/doc/white-paper/advanced-encryption-standard-new-instructions-set-paper.pdf
+ * 
+ */
+#include "aes_ni.h"
+#include "cpu.h"
+
+#include "psi/tools/Tools.h"
+
+#ifdef PSI_CRYPT_X86
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+namespace psi::tools::crypt {
+
+bool aes_ni::isSupported()
+{
+    return cpu::hasAesNi() && cpu::hasSsse3();
+}
+
+#ifdef PSI_CRYPT_X86
+
+namespace {
+
+constexpr size_t LANES = 8u;
+
+inline __m128i load(const uint8_t *p, size_t offset)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(shift_ptr(p, offset)));
+}
+
+inline void store(uint8_t *p, size_t offset, __m128i v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(shift_ptr(p, offset)), v);
+}
+
+PSI_CRYPT_TARGET("aes,sse2")
+inline __m128i expandAssist128(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+PSI_CRYPT_TARGET("aes,sse2")
+inline __m128i expandAssist256(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, 0xaa);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+} // namespace
+
+// AESKEYGENASSIST requires an immediate round constant, therefore rounds are unrolled
+PSI_CRYPT_TARGET("aes,sse2")
+void aes_ni::expandKey128(const uint8_t *key, uint8_t *roundKeys)
+{
+    __m128i k = load(key, 0);
+    store(roundKeys, 0, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x01));
+    store(roundKeys, 16u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x02));
+    store(roundKeys, 32u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x04));
+    store(roundKeys, 48u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x08));
+    store(roundKeys, 64u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x10));
+    store(roundKeys, 80u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x20));
+    store(roundKeys, 96u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x40));
+    store(roundKeys, 112u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x80));
+    store(roundKeys, 128u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x1b));
+    store(roundKeys, 144u, k);
+    k = expandAssist128(k, _mm_aeskeygenassist_si128(k, 0x36));
+    store(roundKeys, 160u, k);
+}
+
+PSI_CRYPT_TARGET("aes,sse2")
+void aes_ni::expandKey256(const uint8_t *key, uint8_t *roundKeys)
+{
+    __m128i k1 = load(key, 0);
+    __m128i k2 = load(key, 16u);
+    store(roundKeys, 0, k1);
+    store(roundKeys, 16u, k2);
+
+    // even round keys: RotWord + SubWord + Rcon of the previous odd key
+    // odd round keys: SubWord of the previous even key
+#define PSI_AES_NI_EXPAND_256(rcon, idx)                                                                               \
+    k1 = expandAssist128(k1, _mm_aeskeygenassist_si128(k2, rcon));                                                     \
+    store(roundKeys, (idx) * 16u, k1);                                                                                 \
+    k2 = expandAssist256(k2, _mm_aeskeygenassist_si128(k1, 0x00));                                                     \
+    store(roundKeys, ((idx) + 1u) * 16u, k2);
+
+    PSI_AES_NI_EXPAND_256(0x01, 2u)
+    PSI_AES_NI_EXPAND_256(0x02, 4u)
+    PSI_AES_NI_EXPAND_256(0x04, 6u)
+    PSI_AES_NI_EXPAND_256(0x08, 8u)
+    PSI_AES_NI_EXPAND_256(0x10, 10u)
+    PSI_AES_NI_EXPAND_256(0x20, 12u)
+#undef PSI_AES_NI_EXPAND_256
+
+    k1 = expandAssist128(k1, _mm_aeskeygenassist_si128(k2, 0x40));
+    store(roundKeys, 14u * 16u, k1);
+}
+
+PSI_CRYPT_TARGET("aes,sse2")
+void aes_ni::invertKeys(const uint8_t *roundKeys, uint8_t rounds, uint8_t *decRoundKeys)
+{
+    store(decRoundKeys, 0, load(roundKeys, rounds * 16u));
+    for (uint8_t i = 1; i < rounds; ++i) {
+        store(decRoundKeys, i * 16u, _mm_aesimc_si128(load(roundKeys, (rounds - i) * 16u)));
+    }
+    store(decRoundKeys, rounds * 16u, load(roundKeys, 0));
+}
+
+PSI_CRYPT_TARGET("aes,sse2")
+void aes_ni::encryptBlocks(const uint8_t *roundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    const __m128i k0 = load(roundKeys, 0);
+    const __m128i kLast = load(roundKeys, rounds * 16u);
+
+    size_t n = 0;
+    // independent blocks are interleaved to hide AESENC latency
+    for (; n + LANES <= blocks; n += LANES) {
+        __m128i b[LANES];
+        for (size_t i = 0; i < LANES; ++i) {
+            b[i] = _mm_xor_si128(load(in, (n + i) * 16u), k0);
+        }
+        for (uint8_t r = 1; r < rounds; ++r) {
+            const __m128i k = load(roundKeys, r * 16u);
+            for (size_t i = 0; i < LANES; ++i) {
+                b[i] = _mm_aesenc_si128(b[i], k);
+            }
+        }
+        for (size_t i = 0; i < LANES; ++i) {
+            store(out, (n + i) * 16u, _mm_aesenclast_si128(b[i], kLast));
+        }
+    }
+
+    for (; n < blocks; ++n) {
+        __m128i b = _mm_xor_si128(load(in, n * 16u), k0);
+        for (uint8_t r = 1; r < rounds; ++r) {
+            b = _mm_aesenc_si128(b, load(roundKeys, r * 16u));
+        }
+        store(out, n * 16u, _mm_aesenclast_si128(b, kLast));
+    }
+}
+
+PSI_CRYPT_TARGET("aes,sse2")
+void aes_ni::decryptBlocks(const uint8_t *decRoundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    const __m128i k0 = load(decRoundKeys, 0);
+    const __m128i kLast = load(decRoundKeys, rounds * 16u);
+
+    size_t n = 0;
+    for (; n + LANES <= blocks; n += LANES) {
+        __m128i b[LANES];
+        for (size_t i = 0; i < LANES; ++i) {
+            b[i] = _mm_xor_si128(load(in, (n + i) * 16u), k0);
+        }
+        for (uint8_t r = 1; r < rounds; ++r) {
+            const __m128i k = load(decRoundKeys, r * 16u);
+            for (size_t i = 0; i < LANES; ++i) {
+                b[i] = _mm_aesdec_si128(b[i], k);
+            }
+        }
+        for (size_t i = 0; i < LANES; ++i) {
+            store(out, (n + i) * 16u, _mm_aesdeclast_si128(b[i], kLast));
+        }
+    }
+
+    for (; n < blocks; ++n) {
+        __m128i b = _mm_xor_si128(load(in, n * 16u), k0);
+        for (uint8_t r = 1; r < rounds; ++r) {
+            b = _mm_aesdec_si128(b, load(decRoundKeys, r * 16u));
+        }
+        store(out, n * 16u, _mm_aesdeclast_si128(b, kLast));
+    }
+}
+
+PSI_CRYPT_TARGET("aes,ssse3")
+void aes_ni::ctr32Xor(const uint8_t *roundKeys,
+                      uint8_t rounds,
+                      uint8_t *counter,
+                      const uint8_t *in,
+                      uint8_t *out,
+                      size_t len)
+{
+    // counter is kept byte-reversed, so its last 32-bit big-endian word becomes lane 0 and inc32 is a single add
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+    const __m128i k0 = load(roundKeys, 0);
+    const __m128i kLast = load(roundKeys, rounds * 16u);
+
+    __m128i ctr = _mm_shuffle_epi8(load(counter, 0), bswap);
+
+    size_t offset = 0;
+    for (; offset + LANES * 16u <= len; offset += LANES * 16u) {
+        __m128i b[LANES];
+        for (size_t i = 0; i < LANES; ++i) {
+            b[i] = _mm_xor_si128(_mm_shuffle_epi8(ctr, bswap), k0);
+            ctr = _mm_add_epi32(ctr, one);
+        }
+        for (uint8_t r = 1; r < rounds; ++r) {
+            const __m128i k = load(roundKeys, r * 16u);
+            for (size_t i = 0; i < LANES; ++i) {
+                b[i] = _mm_aesenc_si128(b[i], k);
+            }
+        }
+        for (size_t i = 0; i < LANES; ++i) {
+            b[i] = _mm_aesenclast_si128(b[i], kLast);
+            store(out, offset + i * 16u, _mm_xor_si128(b[i], load(in, offset + i * 16u)));
+        }
+    }
+
+    for (; offset < len; offset += 16u) {
+        __m128i b = _mm_xor_si128(_mm_shuffle_epi8(ctr, bswap), k0);
+        ctr = _mm_add_epi32(ctr, one);
+        for (uint8_t r = 1; r < rounds; ++r) {
+            b = _mm_aesenc_si128(b, load(roundKeys, r * 16u));
+        }
+        b = _mm_aesenclast_si128(b, kLast);
+
+        if (offset + 16u <= len) {
+            store(out, offset, _mm_xor_si128(b, load(in, offset)));
+        } else {
+            uint8_t keyStream[16u];
+            store(keyStream, 0, b);
+            for (size_t i = 0; offset + i < len; ++i) {
+                *shift_ptr(out, offset + i) = *shift_ptr(in, offset + i) ^ keyStream[i];
+            }
+        }
+    }
+
+    store(counter, 0, _mm_shuffle_epi8(ctr, bswap));
+}
+
+#else
+
+void aes_ni::expandKey128(const uint8_t *, uint8_t *) {}
+void aes_ni::expandKey256(const uint8_t *, uint8_t *) {}
+void aes_ni::invertKeys(const uint8_t *, uint8_t, uint8_t *) {}
+void aes_ni::encryptBlocks(const uint8_t *, uint8_t, const uint8_t *, uint8_t *, size_t) {}
+void aes_ni::decryptBlocks(const uint8_t *, uint8_t, const uint8_t *, uint8_t *, size_t) {}
+void aes_ni::ctr32Xor(const uint8_t *, uint8_t, uint8_t *, const uint8_t *, uint8_t *, size_t) {}
+
+#endif
+
+} // namespace psi::tools::crypt
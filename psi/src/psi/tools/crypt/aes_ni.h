@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief AES-NI (AESENC/AESDEC/AESKEYGENASSIST) backend of aes.
+ * Round keys are laid out exactly as produced by aes::generateSubKeys_impl, 16 bytes per round.
+ * Functions must not be called if isSupported() returns false.
+ *
+ */
+class aes_ni
+{
+public:
+    static bool isSupported();
+
+    static void expandKey128(const uint8_t *key, uint8_t *roundKeys);
+    static void expandKey256(const uint8_t *key, uint8_t *roundKeys);
+    static void invertKeys(const uint8_t *roundKeys, uint8_t rounds, uint8_t *decRoundKeys);
+
+    static void encryptBlocks(const uint8_t *roundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void decryptBlocks(const uint8_t *decRoundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void ctr32Xor(const uint8_t *roundKeys,
+                         uint8_t rounds,
+                         uint8_t *counter,
+                         const uint8_t *in,
+                         uint8_t *out,
+                         size_t len);
+};
+
+} // namespace psi::tools::crypt
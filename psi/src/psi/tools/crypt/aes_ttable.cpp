@@ -0,0 +1,266 @@
+/**
+ * @brief https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.197.pdf, section 5.3.5 and
+ * https://csrc.nist.gov/csrc/media/projects/cryptographic-standards-and-guidelines/documents/aes-development/rijndael-ammended.pdf, section 5.2.1
+ * 
+ */
+#include "aes_ttable.h"
+
+#include "psi/tools/Tools.h"
+
+#include <array>
+
+namespace psi::tools::crypt {
+
+namespace {
+
+using Table = std::array<uint32_t, 256u>;
+
+constexpr uint8_t xtime(uint8_t x)
+{
+    return uint8_t((x << 1) ^ ((x & 0x80) ? 0x1b : 0x00));
+}
+
+constexpr uint8_t gfMult(uint8_t a, uint8_t b)
+{
+    uint8_t p = 0;
+    for (; b != 0; b >>= 1) {
+        if (b & 1u) {
+            p ^= a;
+        }
+        a = xtime(a);
+    }
+    return p;
+}
+
+constexpr uint8_t rotl8(uint8_t x, uint8_t n)
+{
+    return uint8_t((x << n) | (x >> (8u - n)));
+}
+
+// multiplicative inverse x^254 followed by affine transformation
+constexpr std::array<uint8_t, 256u> makeSBox()
+{
+    std::array<uint8_t, 256u> box = {};
+    for (size_t x = 0; x < 256u; ++x) {
+        uint8_t inv = 1;
+        uint8_t base = uint8_t(x);
+        for (uint8_t e = 254; e != 0; e >>= 1) {
+            if (e & 1u) {
+                inv = gfMult(inv, base);
+            }
+            base = gfMult(base, base);
+        }
+        if (x == 0) {
+            inv = 0;
+        }
+        box[x] = inv ^ rotl8(inv, 1) ^ rotl8(inv, 2) ^ rotl8(inv, 3) ^ rotl8(inv, 4) ^ 0x63;
+    }
+    return box;
+}
+
+constexpr std::array<uint8_t, 256u> makeISBox(const std::array<uint8_t, 256u> &box)
+{
+    std::array<uint8_t, 256u> ibox = {};
+    for (size_t x = 0; x < 256u; ++x) {
+        ibox[box[x]] = uint8_t(x);
+    }
+    return ibox;
+}
+
+constexpr uint32_t word(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3)
+{
+    return (uint32_t(b0) << 24) | (uint32_t(b1) << 16) | (uint32_t(b2) << 8) | uint32_t(b3);
+}
+
+constexpr uint32_t rotr32(uint32_t x, uint8_t n)
+{
+    return (x >> n) | (x << (32u - n));
+}
+
+// Te0[x] = [2 1 1 3] * S[x], Te1..Te3 are rotated by one byte each
+constexpr std::array<Table, 4u> makeTe(const std::array<uint8_t, 256u> &box)
+{
+    std::array<Table, 4u> te = {};
+    for (size_t x = 0; x < 256u; ++x) {
+        const uint8_t s = box[x];
+        const uint32_t w = word(gfMult(s, 2), s, s, gfMult(s, 3));
+        te[0][x] = w;
+        te[1][x] = rotr32(w, 8);
+        te[2][x] = rotr32(w, 16);
+        te[3][x] = rotr32(w, 24);
+    }
+    return te;
+}
+
+// Td0[x] = [14 9 13 11] * IS[x], Td1..Td3 are rotated by one byte each
+constexpr std::array<Table, 4u> makeTd(const std::array<uint8_t, 256u> &ibox)
+{
+    std::array<Table, 4u> td = {};
+    for (size_t x = 0; x < 256u; ++x) {
+        const uint8_t s = ibox[x];
+        const uint32_t w = word(gfMult(s, 14), gfMult(s, 9), gfMult(s, 13), gfMult(s, 11));
+        td[0][x] = w;
+        td[1][x] = rotr32(w, 8);
+        td[2][x] = rotr32(w, 16);
+        td[3][x] = rotr32(w, 24);
+    }
+    return td;
+}
+
+constexpr std::array<uint8_t, 256u> S_BOX = makeSBox();
+constexpr std::array<uint8_t, 256u> IS_BOX = makeISBox(S_BOX);
+constexpr std::array<Table, 4u> TE = makeTe(S_BOX);
+constexpr std::array<Table, 4u> TD = makeTd(IS_BOX);
+
+static_assert(S_BOX[0x00] == 0x63 && S_BOX[0x53] == 0xed && IS_BOX[0x63] == 0x00, "invalid S-box");
+
+inline uint32_t load32(const uint8_t *p, size_t offset)
+{
+    return word(*shift_ptr(p, offset),
+                *shift_ptr(p, offset + 1u),
+                *shift_ptr(p, offset + 2u),
+                *shift_ptr(p, offset + 3u));
+}
+
+inline void store32(uint8_t *p, size_t offset, uint32_t w)
+{
+    *shift_ptr(p, offset) = uint8_t(w >> 24);
+    *shift_ptr(p, offset + 1u) = uint8_t(w >> 16);
+    *shift_ptr(p, offset + 2u) = uint8_t(w >> 8);
+    *shift_ptr(p, offset + 3u) = uint8_t(w);
+}
+
+inline uint8_t byte(uint32_t w, uint8_t n)
+{
+    return uint8_t(w >> (24u - n * 8u));
+}
+
+// up to 15 round keys of 4 columns
+using KeyWords = std::array<uint32_t, 60u>;
+
+inline void loadKeys(const uint8_t *roundKeys, uint8_t rounds, KeyWords &words)
+{
+    for (size_t i = 0; i < (rounds + 1u) * 4u; ++i) {
+        words[i] = load32(roundKeys, i * 4u);
+    }
+}
+
+} // namespace
+
+// equivalent inverse cipher keys: reversed order, InvMixColumns applied to all keys except first and last
+void aes_ttable::invertKeys(const uint8_t *roundKeys, uint8_t rounds, uint8_t *decRoundKeys)
+{
+    mem_copy(decRoundKeys, 0, roundKeys, rounds * 16u, 16u);
+    for (uint8_t r = 1; r < rounds; ++r) {
+        for (size_t c = 0; c < 4u; ++c) {
+            const uint32_t w = load32(roundKeys, (rounds - r) * 16u + c * 4u);
+            store32(decRoundKeys,
+                    r * 16u + c * 4u,
+                    TD[0][S_BOX[byte(w, 0)]] ^ TD[1][S_BOX[byte(w, 1)]] ^ TD[2][S_BOX[byte(w, 2)]]
+                        ^ TD[3][S_BOX[byte(w, 3)]]);
+        }
+    }
+    mem_copy(decRoundKeys, rounds * 16u, roundKeys, 0, 16u);
+}
+
+void aes_ttable::encryptBlocks(const uint8_t *roundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    KeyWords rk;
+    loadKeys(roundKeys, rounds, rk);
+
+    for (size_t n = 0; n < blocks; ++n) {
+        const size_t offset = n * 16u;
+        uint32_t s0 = load32(in, offset) ^ rk[0];
+        uint32_t s1 = load32(in, offset + 4u) ^ rk[1];
+        uint32_t s2 = load32(in, offset + 8u) ^ rk[2];
+        uint32_t s3 = load32(in, offset + 12u) ^ rk[3];
+
+        for (uint8_t r = 1; r < rounds; ++r) {
+            const size_t k = r * 4u;
+            const uint32_t t0 = TE[0][byte(s0, 0)] ^ TE[1][byte(s1, 1)] ^ TE[2][byte(s2, 2)] ^ TE[3][byte(s3, 3)]
+                ^ rk[k];
+            const uint32_t t1 = TE[0][byte(s1, 0)] ^ TE[1][byte(s2, 1)] ^ TE[2][byte(s3, 2)] ^ TE[3][byte(s0, 3)]
+                ^ rk[k + 1u];
+            const uint32_t t2 = TE[0][byte(s2, 0)] ^ TE[1][byte(s3, 1)] ^ TE[2][byte(s0, 2)] ^ TE[3][byte(s1, 3)]
+                ^ rk[k + 2u];
+            const uint32_t t3 = TE[0][byte(s3, 0)] ^ TE[1][byte(s0, 1)] ^ TE[2][byte(s1, 2)] ^ TE[3][byte(s2, 3)]
+                ^ rk[k + 3u];
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        // final round has no MixColumns
+        const size_t k = rounds * 4u;
+        store32(out,
+                offset,
+                word(S_BOX[byte(s0, 0)], S_BOX[byte(s1, 1)], S_BOX[byte(s2, 2)], S_BOX[byte(s3, 3)]) ^ rk[k]);
+        store32(out,
+                offset + 4u,
+                word(S_BOX[byte(s1, 0)], S_BOX[byte(s2, 1)], S_BOX[byte(s3, 2)], S_BOX[byte(s0, 3)])
+                    ^ rk[k + 1u]);
+        store32(out,
+                offset + 8u,
+                word(S_BOX[byte(s2, 0)], S_BOX[byte(s3, 1)], S_BOX[byte(s0, 2)], S_BOX[byte(s1, 3)])
+                    ^ rk[k + 2u]);
+        store32(out,
+                offset + 12u,
+                word(S_BOX[byte(s3, 0)], S_BOX[byte(s0, 1)], S_BOX[byte(s1, 2)], S_BOX[byte(s2, 3)])
+                    ^ rk[k + 3u]);
+    }
+}
+
+void aes_ttable::decryptBlocks(const uint8_t *decRoundKeys,
+                               uint8_t rounds,
+                               const uint8_t *in,
+                               uint8_t *out,
+                               size_t blocks)
+{
+    KeyWords rk;
+    loadKeys(decRoundKeys, rounds, rk);
+
+    for (size_t n = 0; n < blocks; ++n) {
+        const size_t offset = n * 16u;
+        uint32_t s0 = load32(in, offset) ^ rk[0];
+        uint32_t s1 = load32(in, offset + 4u) ^ rk[1];
+        uint32_t s2 = load32(in, offset + 8u) ^ rk[2];
+        uint32_t s3 = load32(in, offset + 12u) ^ rk[3];
+
+        for (uint8_t r = 1; r < rounds; ++r) {
+            const size_t k = r * 4u;
+            const uint32_t t0 = TD[0][byte(s0, 0)] ^ TD[1][byte(s3, 1)] ^ TD[2][byte(s2, 2)] ^ TD[3][byte(s1, 3)]
+                ^ rk[k];
+            const uint32_t t1 = TD[0][byte(s1, 0)] ^ TD[1][byte(s0, 1)] ^ TD[2][byte(s3, 2)] ^ TD[3][byte(s2, 3)]
+                ^ rk[k + 1u];
+            const uint32_t t2 = TD[0][byte(s2, 0)] ^ TD[1][byte(s1, 1)] ^ TD[2][byte(s0, 2)] ^ TD[3][byte(s3, 3)]
+                ^ rk[k + 2u];
+            const uint32_t t3 = TD[0][byte(s3, 0)] ^ TD[1][byte(s2, 1)] ^ TD[2][byte(s1, 2)] ^ TD[3][byte(s0, 3)]
+                ^ rk[k + 3u];
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        // final round has no InvMixColumns
+        const size_t k = rounds * 4u;
+        store32(out,
+                offset,
+                word(IS_BOX[byte(s0, 0)], IS_BOX[byte(s3, 1)], IS_BOX[byte(s2, 2)], IS_BOX[byte(s1, 3)]) ^ rk[k]);
+        store32(out,
+                offset + 4u,
+                word(IS_BOX[byte(s1, 0)], IS_BOX[byte(s0, 1)], IS_BOX[byte(s3, 2)], IS_BOX[byte(s2, 3)])
+                    ^ rk[k + 1u]);
+        store32(out,
+                offset + 8u,
+                word(IS_BOX[byte(s2, 0)], IS_BOX[byte(s1, 1)], IS_BOX[byte(s0, 2)], IS_BOX[byte(s3, 3)])
+                    ^ rk[k + 2u]);
+        store32(out,
+                offset + 12u,
+                word(IS_BOX[byte(s3, 0)], IS_BOX[byte(s2, 1)], IS_BOX[byte(s1, 2)], IS_BOX[byte(s0, 3)])
+                    ^ rk[k + 3u]);
+    }
+}
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief Word-oriented software backend of aes based on 32-bit lookup tables (Te0..Te3, Td0..Td3).
+ * Each round works on four big-endian columns, tables are generated at compile time.
+ * Round keys are laid out exactly as produced by aes::generateSubKeys_impl, 16 bytes per round.
+ *
+ */
+class aes_ttable
+{
+public:
+    static void invertKeys(const uint8_t *roundKeys, uint8_t rounds, uint8_t *decRoundKeys);
+
+    static void encryptBlocks(const uint8_t *roundKeys, uint8_t rounds, const uint8_t *in, uint8_t *out, size_t blocks);
+    static void decryptBlocks(const uint8_t *decRoundKeys,
+                              uint8_t rounds,
+                              const uint8_t *in,
+                              uint8_t *out,
+                              size_t blocks);
+};
+
+} // namespace psi::tools::crypt
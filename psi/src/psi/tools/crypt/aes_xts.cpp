@@ -0,0 +1,127 @@
+/**
+ * @brief https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication800-38e.pdf
+ * 
+ */
+#include "aes_xts.h"
+#include "aes.h"
+#include "parallel.h"
+
+#include "psi/tools/Tools.h"
+
+#include <algorithm>
+
+namespace psi::tools::crypt {
+
+// multiplication by primitive element of GF(2^128), tweak is little-endian
+void aes_xts::multiplyAlpha(DataBlock16 &tweak)
+{
+    uint8_t carry = 0;
+    for (auto &b : tweak) {
+        const uint8_t next = b >> 7;
+        b = uint8_t(b << 1) | carry;
+        carry = next;
+    }
+    tweak[0] ^= uint8_t(0x87 & (0u - carry));
+}
+
+// C = E(K1, P XOR T) XOR T for every block, tweak is advanced by number of blocks
+void aes_xts::cryptBlocks(const AesKey &dataKey, DataBlock16 &tweak, uint8_t *data, size_t blocks, bool isDecrypt)
+{
+    uint8_t tweaks[BATCH_BLOCKS * 16u];
+    for (size_t n = 0; n < blocks; n += BATCH_BLOCKS) {
+        const size_t count = std::min(BATCH_BLOCKS, blocks - n);
+        uint8_t *chunk = shift_ptr(data, n * 16u);
+        for (size_t i = 0; i < count; ++i) {
+            mem_copy(tweaks, i * 16u, tweak.data(), 0, 16u);
+            multiplyAlpha(tweak);
+        }
+
+        for (size_t i = 0; i < count * 16u; ++i) {
+            *shift_ptr(chunk, i) ^= tweaks[i];
+        }
+        if (isDecrypt) {
+            aes::decryptBlocks(dataKey, chunk, chunk, count);
+        } else {
+            aes::encryptBlocks(dataKey, chunk, chunk, count);
+        }
+        for (size_t i = 0; i < count * 16u; ++i) {
+            *shift_ptr(chunk, i) ^= tweaks[i];
+        }
+    }
+}
+
+void aes_xts::cryptBlock(const AesKey &dataKey, const DataBlock16 &tweak, uint8_t *data, bool isDecrypt)
+{
+    DataBlock16 copy = tweak;
+    cryptBlocks(dataKey, copy, data, 1u, isDecrypt);
+}
+
+void aes_xts::cryptSector(const AesKey &dataKey,
+                          const AesKey &tweakKey,
+                          uint64_t sector,
+                          uint8_t *data,
+                          size_t len,
+                          bool isDecrypt)
+{
+    // T = E(K2, i), i is 128-bit little-endian sector number
+    DataBlock16 tweak = {};
+    for (size_t i = 0; i < 8u; ++i) {
+        tweak[i] = uint8_t(sector >> (i * 8u));
+    }
+    aes::encryptBlock(tweakKey, tweak.data(), tweak.data());
+
+    const size_t blocks = len / 16u;
+    const size_t tail = len % 16u;
+    if (tail == 0) {
+        cryptBlocks(dataKey, tweak, data, blocks, isDecrypt);
+        return;
+    }
+
+    // ciphertext stealing: last full block and partial block are swapped
+    cryptBlocks(dataKey, tweak, data, blocks - 1u, isDecrypt);
+
+    uint8_t *last = shift_ptr(data, (blocks - 1u) * 16u);
+    uint8_t *partial = shift_ptr(last, 16u);
+    DataBlock16 lastTweak = tweak;
+    multiplyAlpha(lastTweak);
+
+    // decryption uses tweaks of last two blocks in reverse order
+    cryptBlock(dataKey, isDecrypt ? lastTweak : tweak, last, isDecrypt);
+
+    uint8_t stolen[16u];
+    mem_copy(stolen, 0, last, 0, 16u);
+    mem_copy(stolen, 0, partial, 0, tail);
+    mem_copy(partial, 0, last, 0, tail);
+
+    cryptBlock(dataKey, isDecrypt ? tweak : lastTweak, stolen, isDecrypt);
+    mem_copy(last, 0, stolen, 0, 16u);
+}
+
+void aes_xts::cryptSectors(const AesKey &dataKey,
+                           const AesKey &tweakKey,
+                           uint64_t firstSector,
+                           uint8_t *data,
+                           size_t len,
+                           size_t sectorSize,
+                           bool isDecrypt)
+{
+    const size_t sectors = len / sectorSize;
+    if (len < parallel::THRESHOLD) {
+        for (size_t i = 0; i < sectors; ++i) {
+            cryptSector(dataKey, tweakKey, firstSector + i, shift_ptr(data, i * sectorSize), sectorSize, isDecrypt);
+        }
+        return;
+    }
+
+    // sectors are independent, every thread takes its own group of them
+    const size_t groupSectors = std::max<size_t>(1u, PARALLEL_SEGMENT / sectorSize);
+    const size_t groups = (sectors + groupSectors - 1u) / groupSectors;
+    parallel::forEach(groups, [&](size_t j) {
+        const size_t end = std::min(sectors, (j + 1u) * groupSectors);
+        for (size_t i = j * groupSectors; i < end; ++i) {
+            cryptSector(dataKey, tweakKey, firstSector + i, shift_ptr(data, i * sectorSize), sectorSize, isDecrypt);
+        }
+    });
+}
+
+} // namespace psi::tools::crypt
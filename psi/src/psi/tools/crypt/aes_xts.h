@@ -0,0 +1,44 @@
+#pragma once
+
+#include "psi/tools/AesKey.h"
+
+#include <array>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief XTS-AES mode of IEEE 1619 / NIST SP 800-38E.
+ * Sector number is used as tweak, last partial block of sector is processed with ciphertext stealing.
+ * Data is processed in place.
+ *
+ */
+class aes_xts
+{
+public:
+    using DataBlock16 = std::array<uint8_t, 16u>;
+
+    static void multiplyAlpha(DataBlock16 &tweak);
+    static void cryptSector(const AesKey &dataKey,
+                            const AesKey &tweakKey,
+                            uint64_t sector,
+                            uint8_t *data,
+                            size_t len,
+                            bool isDecrypt);
+    static void cryptSectors(const AesKey &dataKey,
+                             const AesKey &tweakKey,
+                             uint64_t firstSector,
+                             uint8_t *data,
+                             size_t len,
+                             size_t sectorSize,
+                             bool isDecrypt);
+
+private:
+    static void cryptBlocks(const AesKey &dataKey, DataBlock16 &tweak, uint8_t *data, size_t blocks, bool isDecrypt);
+    static void cryptBlock(const AesKey &dataKey, const DataBlock16 &tweak, uint8_t *data, bool isDecrypt);
+
+    static constexpr size_t BATCH_BLOCKS = 8u;
+    // requests from parallel::THRESHOLD are split into groups of sectors processed by separate threads
+    static constexpr size_t PARALLEL_SEGMENT = 1024u * 1024u;
+};
+
+} // namespace psi::tools::crypt
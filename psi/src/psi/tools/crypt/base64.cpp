@@ -2,6 +2,8 @@
 
 #include "base64.h"
 
+#include <algorithm>
+
 #ifdef PSI_LOGGER
 #include "psi/logger/Logger.h"
 #else
@@ -28,92 +30,100 @@ const uint8_t base64::m_base64Pad = '=';
 
 ByteBuffer base64::encryptBase64(const ByteBuffer &in)
 {
-    const size_t outSize = ((in.size() / 3) + (in.size() % 3 > 0)) * 4;
-    ByteBuffer out(outSize);
-
-    auto generate_fail = [&]() { out.resize(0u); };
-
-    uint8_t temp1, temp2, temp3;
-    uint32_t temp;
-    for (size_t idx = 0; idx < in.size() / 3; ++idx) {
-        if (!in.read(temp1) || !in.read(temp2) || !in.read(temp3)) {
-            generate_fail();
-            return out;
-        }
-        temp = uint32_t(temp1 << 16u) | uint32_t(temp2 << 8u) | uint32_t(temp3);
+    ByteBuffer out(encodedSize(in.size()));
+    encode(in.data(), in.size(), out.data());
+    out.skipWrite(out.size());
+    return out;
+}
 
-        if (!out.write(m_base64Table[(temp & 0x00fc0000) >> 18]) || !out.write(m_base64Table[(temp & 0x0003f000) >> 12])
-            || !out.write(m_base64Table[(temp & 0x00000fc0) >> 6]) || !out.write(m_base64Table[(temp & 0x0000003f)])) {
-            generate_fail();
-            return out;
-        }
+ByteBuffer base64::decryptBase64(const ByteBuffer &in)
+{
+    const size_t outSize = decodedSize(in.data(), in.size());
+    if (outSize == 0) {
+        LOG_ERROR_STATIC("Incorrect incoming buffer length: " << in.size() << " for data:" << in.asString());
+        return ByteBuffer(0u);
     }
 
-    switch (in.size() % 3) {
-    case 1:
-        if (!in.read(temp1)) {
-            generate_fail();
-            return out;
-        }
-        temp = uint32_t(temp1 << 16);
-
-        if (!out.write(m_base64Table[(temp & 0x00FC0000) >> 18]) || !out.write(m_base64Table[(temp & 0x0003F000) >> 12])
-            || !out.write(m_base64Pad) || !out.write(m_base64Pad)) {
-            generate_fail();
-            return out;
-        }
-        break;
-    case 2:
-        if (!in.read(temp1) || !in.read(temp2)) {
-            generate_fail();
-            return out;
-        }
-        temp = uint32_t(temp1 << 16) | uint32_t(temp2 << 8);
-
-        if (!out.write(m_base64Table[(temp & 0x00FC0000) >> 18]) || !out.write(m_base64Table[(temp & 0x0003F000) >> 12])
-            || !out.write(m_base64Table[(temp & 0x00000FC0) >> 6]) || !out.write(m_base64Pad)) {
-            generate_fail();
-            return out;
-        }
-        break;
+    ByteBuffer out(outSize);
+    if (!decode(in.data(), in.size(), out.data())) {
+        out.resize(0u);
+        return out;
     }
-
+    out.skipWrite(outSize);
     return out;
 }
 
-ByteBuffer base64::decryptBase64(const ByteBuffer &in)
+size_t base64::encodedSize(size_t dataLen)
 {
-    ByteBuffer out(0u);
+    return ((dataLen / 3) + (dataLen % 3 > 0)) * 4;
+}
 
-    const size_t inputLen = in.size();
-    if (inputLen % 4 || in.size() == 0) {
-        LOG_ERROR_STATIC("Incorrect incoming buffer length: " << inputLen << " for data:" << in.asString());
-        return out;
+size_t base64::decodedSize(const uint8_t *data, size_t dataLen)
+{
+    if (dataLen % 4 || dataLen == 0) {
+        return 0;
     }
 
     size_t padding = 0;
-    if (m_base64Pad == in.at(inputLen - 1)) {
+    if (m_base64Pad == *shift_ptr(data, dataLen - 1)) {
         ++padding;
+        if (m_base64Pad == *shift_ptr(data, dataLen - 2)) {
+            ++padding;
+        }
     }
-    if (m_base64Pad == in.at(inputLen - 2)) {
-        ++padding;
+
+    return ((dataLen / 4) * 3) - padding;
+}
+
+void base64::encode(const uint8_t *in, size_t dataLen, uint8_t *out)
+{
+    uint32_t temp;
+    for (size_t idx = 0; idx < dataLen / 3; ++idx) {
+        temp = uint32_t(*shift_ptr(in, idx * 3) << 16u) | uint32_t(*shift_ptr(in, idx * 3 + 1) << 8u)
+            | uint32_t(*shift_ptr(in, idx * 3 + 2));
+
+        *shift_ptr(out, idx * 4) = m_base64Table[(temp & 0x00fc0000) >> 18];
+        *shift_ptr(out, idx * 4 + 1) = m_base64Table[(temp & 0x0003f000) >> 12];
+        *shift_ptr(out, idx * 4 + 2) = m_base64Table[(temp & 0x00000fc0) >> 6];
+        *shift_ptr(out, idx * 4 + 3) = m_base64Table[(temp & 0x0000003f)];
     }
 
-    const size_t outSize = ((inputLen / 4) * 3) - padding;
-    out.resize(outSize);
+    const size_t tail = dataLen - dataLen % 3;
+    uint8_t *last = shift_ptr(out, (dataLen / 3) * 4);
+    switch (dataLen % 3) {
+    case 1:
+        temp = uint32_t(*shift_ptr(in, tail) << 16);
+
+        last[0] = m_base64Table[(temp & 0x00FC0000) >> 18];
+        last[1] = m_base64Table[(temp & 0x0003F000) >> 12];
+        last[2] = m_base64Pad;
+        last[3] = m_base64Pad;
+        break;
+    case 2:
+        temp = uint32_t(*shift_ptr(in, tail) << 16) | uint32_t(*shift_ptr(in, tail + 1) << 8);
 
-    auto generate_fail = [&]() { out.resize(0u); };
+        last[0] = m_base64Table[(temp & 0x00FC0000) >> 18];
+        last[1] = m_base64Table[(temp & 0x0003F000) >> 12];
+        last[2] = m_base64Table[(temp & 0x00000FC0) >> 6];
+        last[3] = m_base64Pad;
+        break;
+    }
+}
 
-    uint8_t tempByte;
-    uint32_t temp = 0;
-    size_t idx = 0;
+// every group of 4 characters is read before its 3 bytes are written, so decoding in place is safe
+bool base64::decode(const uint8_t *in, size_t inputLen, uint8_t *out)
+{
+    const size_t outSize = decodedSize(in, inputLen);
+    if (outSize == 0) {
+        return false;
+    }
 
-    while (idx != inputLen) {
-        for (uint8_t q = 0; q < 4; ++q) {
-            if (!in.read(tempByte)) {
-                generate_fail();
-                return out;
-            }
+    const size_t padding = (inputLen / 4) * 3 - outSize;
+    size_t outIdx = 0;
+    for (size_t idx = 0; idx != inputLen; idx += 4) {
+        uint32_t temp = 0;
+        for (size_t q = 0; q < 4; ++q) {
+            const uint8_t tempByte = *shift_ptr(in, idx + q);
 
             temp <<= 6;
 
@@ -128,39 +138,26 @@ ByteBuffer base64::decryptBase64(const ByteBuffer &in)
             } else if (tempByte == 0x2F) {
                 temp |= 0x3F;
             } else if (tempByte == m_base64Pad) {
-                switch (inputLen - idx) {
-                case 1:
-                    if (!out.write(uint8_t((temp >> 16) & 0x000000FF)) || !out.write(uint8_t((temp >> 8) & 0x000000FF))) {
-                        generate_fail();
-                    }
-                    return out;
-                case 2:
-                    if (!out.write(uint8_t((temp >> 10) & 0x000000FF))) {
-                        generate_fail();
-                    }
-                    return out;
-                default:
+                // padding is allowed only as counted trailing characters
+                if (idx + q < inputLen - padding) {
                     LOG_ERROR_STATIC("Invalid padding in Base64!");
-                    generate_fail();
-                    return out;
+                    return false;
                 }
             } else {
                 LOG_ERROR_STATIC("Non-valid character in Base64!");
-                generate_fail();
-                return out;
+                return false;
             }
-
-            ++idx;
         }
 
-        if (!out.write(uint8_t((temp >> 16) & 0x000000FF)) || !out.write(uint8_t((temp >> 8) & 0x000000FF))
-            || !out.write(uint8_t((temp) & 0x000000FF))) {
-            generate_fail();
-            return out;
-        }
+        const uint8_t bytes[3] = {uint8_t((temp >> 16) & 0x000000FF),
+                                  uint8_t((temp >> 8) & 0x000000FF),
+                                  uint8_t((temp) & 0x000000FF)};
+        const size_t sz = std::min<size_t>(3u, outSize - outIdx);
+        mem_copy(out, outIdx, bytes, 0, sz);
+        outIdx += sz;
     }
 
-    return out;
+    return true;
 }
 
 } // namespace psi::tools::crypt
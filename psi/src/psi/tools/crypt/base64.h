@@ -27,6 +27,43 @@ public:
      * @return ByteBuffer decoded buffer
      */
     static ByteBuffer decryptBase64(const ByteBuffer &data);
+
+    /**
+     * @brief Return size of Base64 encoding of data with provided length.
+     *
+     * @param dataLen length of input data
+     * @return size_t length of encoded data including padding
+     */
+    static size_t encodedSize(size_t dataLen);
+
+    /**
+     * @brief Return size of data decoded from provided Base64 buffer.
+     *
+     * @param data pointer to encoded data
+     * @param dataLen length of encoded data
+     * @return size_t length of decoded data, 0 if length of encoded data is invalid
+     */
+    static size_t decodedSize(const uint8_t *data, size_t dataLen);
+
+    /**
+     * @brief Encodes data to Base64 into caller provided buffer.
+     *
+     * @param data pointer to input data
+     * @param dataLen length of input data
+     * @param out output buffer of encodedSize(dataLen) bytes
+     */
+    static void encode(const uint8_t *data, size_t dataLen, uint8_t *out);
+
+    /**
+     * @brief Decodes Base64 data into caller provided buffer. Output might point to the same memory as input.
+     *
+     * @param data pointer to encoded data
+     * @param dataLen length of encoded data
+     * @param out output buffer of decodedSize(data, dataLen) bytes
+     * @return true if data is valid Base64
+     * @return false otherwise
+     */
+    static bool decode(const uint8_t *data, size_t dataLen, uint8_t *out);
 };
 
 } // namespace psi::tools::crypt
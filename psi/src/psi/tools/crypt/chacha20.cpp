@@ -0,0 +1,170 @@
+/**
+ * @brief https://www.rfc-editor.org/rfc/rfc8439
+ * 
+ */
+#include "chacha20.h"
+#include "chacha20_simd.h"
+
+#include "psi/tools/Tools.h"
+
+#include <algorithm>
+
+namespace psi::tools::crypt {
+
+namespace {
+
+constexpr uint32_t SIGMA[4u] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+constexpr size_t LANES = 4u;
+
+inline uint32_t rotl(uint32_t v, uint32_t n)
+{
+    return (v << n) | (v >> (32u - n));
+}
+
+inline uint32_t load32(const uint8_t *p, size_t offset)
+{
+    return uint32_t(*shift_ptr(p, offset)) | (uint32_t(*shift_ptr(p, offset + 1u)) << 8)
+        | (uint32_t(*shift_ptr(p, offset + 2u)) << 16) | (uint32_t(*shift_ptr(p, offset + 3u)) << 24);
+}
+
+inline void store32(uint8_t *p, size_t offset, uint32_t v)
+{
+    *shift_ptr(p, offset) = uint8_t(v);
+    *shift_ptr(p, offset + 1u) = uint8_t(v >> 8);
+    *shift_ptr(p, offset + 2u) = uint8_t(v >> 16);
+    *shift_ptr(p, offset + 3u) = uint8_t(v >> 24);
+}
+
+// every operation is applied to the same word of 4 blocks
+inline void quarterRound(uint32_t (&x)[16u][LANES], size_t a, size_t b, size_t c, size_t d)
+{
+    for (size_t l = 0; l < LANES; ++l) {
+        x[a][l] += x[b][l];
+        x[d][l] = rotl(x[d][l] ^ x[a][l], 16u);
+        x[c][l] += x[d][l];
+        x[b][l] = rotl(x[b][l] ^ x[c][l], 12u);
+        x[a][l] += x[b][l];
+        x[d][l] = rotl(x[d][l] ^ x[a][l], 8u);
+        x[c][l] += x[d][l];
+        x[b][l] = rotl(x[b][l] ^ x[c][l], 7u);
+    }
+}
+
+} // namespace
+
+chacha20::Backend chacha20::backend()
+{
+    static const Backend selected = [] {
+        if (chacha20_simd::isAvx2Supported()) {
+            return Backend::Avx2;
+        }
+        return chacha20_simd::isSse2Supported() ? Backend::Sse2 : Backend::Portable;
+    }();
+    return selected;
+}
+
+void chacha20::keystream(const uint8_t *key, const uint8_t *nonce, uint32_t counter, uint8_t *out, size_t len)
+{
+    xorStream(backend(), key, nonce, counter, nullptr, out, len);
+}
+
+// in and out might point to the same memory
+void chacha20::xorStream(const uint8_t *key,
+                         const uint8_t *nonce,
+                         uint32_t counter,
+                         const uint8_t *in,
+                         uint8_t *out,
+                         size_t len)
+{
+    xorStream(backend(), key, nonce, counter, in, out, len);
+}
+
+// keystream is written as is if in is null
+void chacha20::xorStream(Backend backend,
+                         const uint8_t *key,
+                         const uint8_t *nonce,
+                         uint32_t counter,
+                         const uint8_t *in,
+                         uint8_t *out,
+                         size_t len)
+{
+    uint32_t state[16u];
+    initState(key, nonce, counter, state);
+
+    auto *kernel = &chacha20::blocks4;
+    size_t blocks = LANES;
+    if (backend == Backend::Avx2) {
+        kernel = &chacha20_simd::blocks8Avx2;
+        blocks = 8u;
+    } else if (backend == Backend::Sse2) {
+        kernel = &chacha20_simd::blocks4Sse2;
+    }
+
+    const size_t chunk = blocks * BLOCK_SIZE;
+    uint8_t stream[8u * BLOCK_SIZE];
+    for (size_t offset = 0; offset < len; offset += chunk) {
+        const size_t sz = std::min(chunk, len - offset);
+        if (sz == chunk) {
+            kernel(state, in ? shift_ptr(in, offset) : nullptr, shift_ptr(out, offset));
+        } else {
+            kernel(state, nullptr, stream);
+            for (size_t i = 0; i < sz; ++i) {
+                *shift_ptr(out, offset + i) = in ? uint8_t(*shift_ptr(in, offset + i) ^ stream[i]) : stream[i];
+            }
+            mem_wipe(stream, chunk);
+        }
+        state[12] += uint32_t(blocks);
+    }
+
+    mem_wipe(reinterpret_cast<uint8_t *>(state), sizeof(state));
+}
+
+// constants | key | counter | nonce, all words are little-endian
+void chacha20::initState(const uint8_t *key, const uint8_t *nonce, uint32_t counter, uint32_t (&state)[16u])
+{
+    for (size_t i = 0; i < 4u; ++i) {
+        state[i] = SIGMA[i];
+    }
+    for (size_t i = 0; i < 8u; ++i) {
+        state[4u + i] = load32(key, i * 4u);
+    }
+    state[12] = counter;
+    for (size_t i = 0; i < 3u; ++i) {
+        state[13u + i] = load32(nonce, i * 4u);
+    }
+}
+
+// blocks with counters state[12] .. state[12] + 3
+void chacha20::blocks4(const uint32_t *state, const uint8_t *in, uint8_t *out)
+{
+    uint32_t x[16u][LANES];
+    for (size_t i = 0; i < 16u; ++i) {
+        for (size_t l = 0; l < LANES; ++l) {
+            x[i][l] = state[i];
+        }
+    }
+    for (size_t l = 0; l < LANES; ++l) {
+        x[12][l] += uint32_t(l);
+    }
+
+    for (size_t round = 0; round < 10u; ++round) {
+        quarterRound(x, 0, 4, 8, 12);
+        quarterRound(x, 1, 5, 9, 13);
+        quarterRound(x, 2, 6, 10, 14);
+        quarterRound(x, 3, 7, 11, 15);
+        quarterRound(x, 0, 5, 10, 15);
+        quarterRound(x, 1, 6, 11, 12);
+        quarterRound(x, 2, 7, 8, 13);
+        quarterRound(x, 3, 4, 9, 14);
+    }
+
+    for (size_t l = 0; l < LANES; ++l) {
+        for (size_t i = 0; i < 16u; ++i) {
+            const size_t offset = l * BLOCK_SIZE + i * 4u;
+            const uint32_t word = x[i][l] + state[i] + (i == 12u ? uint32_t(l) : 0u);
+            store32(out, offset, in ? word ^ load32(in, offset) : word);
+        }
+    }
+}
+
+} // namespace psi::tools::crypt
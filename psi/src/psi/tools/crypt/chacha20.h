@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief ChaCha20 stream cipher of RFC 8439 with 256-bit key, 96-bit nonce and 32-bit block counter.
+ * Several consecutive blocks are computed side by side: 8 by AVX2 kernel, 4 by SSE2 kernel or by portable code
+ * which compilers vectorize themselves.
+ *
+ */
+class chacha20
+{
+public:
+    using Key = std::array<uint8_t, 32u>;
+    using Nonce = std::array<uint8_t, 12u>;
+
+    enum class Backend
+    {
+        Portable,
+        Sse2,
+        Avx2,
+    };
+
+    static constexpr size_t BLOCK_SIZE = 64u;
+
+    static Backend backend();
+    static void keystream(const uint8_t *key, const uint8_t *nonce, uint32_t counter, uint8_t *out, size_t len);
+    static void xorStream(const uint8_t *key,
+                          const uint8_t *nonce,
+                          uint32_t counter,
+                          const uint8_t *in,
+                          uint8_t *out,
+                          size_t len);
+    static void xorStream(Backend backend,
+                          const uint8_t *key,
+                          const uint8_t *nonce,
+                          uint32_t counter,
+                          const uint8_t *in,
+                          uint8_t *out,
+                          size_t len);
+
+private:
+    static void initState(const uint8_t *key, const uint8_t *nonce, uint32_t counter, uint32_t (&state)[16u]);
+    static void blocks4(const uint32_t *state, const uint8_t *in, uint8_t *out);
+};
+
+} // namespace psi::tools::crypt
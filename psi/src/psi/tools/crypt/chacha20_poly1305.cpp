@@ -0,0 +1,136 @@
+/**
+ * @brief https://www.rfc-editor.org/rfc/rfc8439
+ * 
+ */
+#include "chacha20_poly1305.h"
+#include "chacha20.h"
+#include "poly1305.h"
+
+#include "psi/tools/Tools.h"
+
+#ifdef PSI_LOGGER
+#include "psi/logger/Logger.h"
+#else
+#include <iostream>
+#include <sstream>
+#define LOG_TRACE_STATIC(x)                                                                                            \
+    do {                                                                                                               \
+        std::ostringstream os;                                                                                         \
+        os << x;                                                                                                       \
+        std::cout << os.str() << std::endl;                                                                            \
+    } while (0)
+#define LOG_ERROR_STATIC(x) LOG_TRACE_STATIC(x)
+#endif
+
+namespace psi::tools::crypt {
+
+// one-time Poly1305 key is the first half of keystream block 0, data is encrypted starting from block 1
+// MAC input: AAD | pad16 | ciphertext | pad16 | le64(len(AAD)) | le64(len(ciphertext))
+void chacha20_poly1305::computeTag(const uint8_t *key,
+                                   const uint8_t *nonce,
+                                   const uint8_t *acc,
+                                   size_t accLen,
+                                   const uint8_t *cipher,
+                                   size_t len,
+                                   uint8_t *tag)
+{
+    uint8_t macKey[chacha20::BLOCK_SIZE];
+    chacha20::keystream(key, nonce, 0u, macKey, sizeof(macKey));
+
+    poly1305 mac(macKey);
+    mem_wipe(macKey, sizeof(macKey));
+
+    mac.update(acc, accLen);
+    mac.pad();
+    mac.update(cipher, len);
+    mac.pad();
+
+    uint8_t lengths[16u];
+    for (size_t i = 0; i < 8u; ++i) {
+        lengths[i] = uint8_t(uint64_t(accLen) >> (i * 8u));
+        lengths[8u + i] = uint8_t(uint64_t(len) >> (i * 8u));
+    }
+    mac.update(lengths, sizeof(lengths));
+    mac.finish(tag);
+}
+
+// in and out might point to the same memory
+bool chacha20_poly1305::encrypt(const uint8_t *key,
+                                const uint8_t *nonce,
+                                const uint8_t *acc,
+                                size_t accLen,
+                                const uint8_t *data,
+                                size_t dataLen,
+                                uint8_t *out,
+                                uint8_t *tag)
+{
+    if (dataLen > MAX_DATA_LENGTH) {
+        return false;
+    }
+
+    chacha20::xorStream(key, nonce, 1u, data, out, dataLen);
+    computeTag(key, nonce, acc, accLen, out, dataLen, tag);
+    return true;
+}
+
+// tag is verified before anything is decrypted, so out is untouched on mismatch
+bool chacha20_poly1305::decrypt(const uint8_t *key,
+                                const uint8_t *nonce,
+                                const uint8_t *acc,
+                                size_t accLen,
+                                const uint8_t *encryptedData,
+                                size_t dataLen,
+                                const uint8_t *tag,
+                                uint8_t *out)
+{
+    if (dataLen > MAX_DATA_LENGTH) {
+        return false;
+    }
+
+    Tag expected = {};
+    computeTag(key, nonce, acc, accLen, encryptedData, dataLen, expected.data());
+    if (!mem_equal_ct(expected.data(), tag, TAG_SIZE)) {
+        return false;
+    }
+
+    chacha20::xorStream(key, nonce, 1u, encryptedData, out, dataLen);
+    return true;
+}
+
+ByteBuffer chacha20_poly1305::encrypt(const ByteBuffer &data,
+                                      const ByteBuffer &key,
+                                      const ByteBuffer &nonce,
+                                      Tag &tag,
+                                      const ByteBuffer &acc)
+{
+    if (key.size() != KEY_SIZE || nonce.size() != NONCE_SIZE || data.size() > MAX_DATA_LENGTH) {
+        return {};
+    }
+
+    ByteBuffer out(data.size());
+    encrypt(key.data(), nonce.data(), acc.data(), acc.size(), data.data(), data.size(), out.data(), tag.data());
+    out.skipWrite(data.size());
+    return out;
+}
+
+ByteBuffer chacha20_poly1305::decrypt(const ByteBuffer &data,
+                                      const ByteBuffer &key,
+                                      const ByteBuffer &nonce,
+                                      const ByteBuffer &tag,
+                                      const ByteBuffer &acc)
+{
+    if (key.size() != KEY_SIZE || nonce.size() != NONCE_SIZE || tag.size() != TAG_SIZE
+        || data.size() > MAX_DATA_LENGTH) {
+        return {};
+    }
+
+    ByteBuffer out(data.size());
+    if (!decrypt(key.data(), nonce.data(), acc.data(), acc.size(), data.data(), data.size(), tag.data(), out.data())) {
+        LOG_ERROR_STATIC("chacha20_poly1305: tag mismatch");
+        return {};
+    }
+    out.skipWrite(data.size());
+    return out;
+}
+
+} // namespace psi::tools::crypt
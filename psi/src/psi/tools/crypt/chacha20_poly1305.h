@@ -0,0 +1,63 @@
+#pragma once
+
+#include "psi/tools/ByteBuffer.h"
+
+#include <array>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief ChaCha20-Poly1305 AEAD of RFC 8439 with 256-bit key, 96-bit nonce and 128-bit tag.
+ * Does not depend on AES instructions and has no secret dependent memory accesses.
+ *
+ */
+class chacha20_poly1305
+{
+public:
+    using Tag = std::array<uint8_t, 16u>;
+
+    static constexpr size_t KEY_SIZE = 32u;
+    static constexpr size_t NONCE_SIZE = 12u;
+    static constexpr size_t TAG_SIZE = 16u;
+    // RFC 8439 limit of payload processed with one nonce, (2^32 - 1) blocks as block 0 is taken by Poly1305 key
+    static constexpr uint64_t MAX_DATA_LENGTH = 0xffffffffull * 64u;
+
+    static bool encrypt(const uint8_t *key,
+                        const uint8_t *nonce,
+                        const uint8_t *acc,
+                        size_t accLen,
+                        const uint8_t *data,
+                        size_t dataLen,
+                        uint8_t *out,
+                        uint8_t *tag);
+    static bool decrypt(const uint8_t *key,
+                        const uint8_t *nonce,
+                        const uint8_t *acc,
+                        size_t accLen,
+                        const uint8_t *encryptedData,
+                        size_t dataLen,
+                        const uint8_t *tag,
+                        uint8_t *out);
+
+    static ByteBuffer encrypt(const ByteBuffer &data,
+                              const ByteBuffer &key,
+                              const ByteBuffer &nonce,
+                              Tag &tag,
+                              const ByteBuffer &acc = {});
+    static ByteBuffer decrypt(const ByteBuffer &encryptedData,
+                              const ByteBuffer &key,
+                              const ByteBuffer &nonce,
+                              const ByteBuffer &tag,
+                              const ByteBuffer &acc = {});
+
+private:
+    static void computeTag(const uint8_t *key,
+                           const uint8_t *nonce,
+                           const uint8_t *acc,
+                           size_t accLen,
+                           const uint8_t *cipher,
+                           size_t len,
+                           uint8_t *tag);
+};
+
+} // namespace psi::tools::crypt
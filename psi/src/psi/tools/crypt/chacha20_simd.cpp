@@ -0,0 +1,189 @@
+#include "chacha20_simd.h"
+#include "cpu.h"
+
+#include "psi/tools/Tools.h"
+
+#ifdef PSI_CRYPT_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+namespace psi::tools::crypt {
+
+bool chacha20_simd::isSse2Supported()
+{
+    return cpu::hasSse2();
+}
+
+bool chacha20_simd::isAvx2Supported()
+{
+    return cpu::hasAvx2();
+}
+
+#ifdef PSI_CRYPT_X86
+
+namespace {
+
+// words of 4 blocks are kept in 4 lanes of one register
+template <int N>
+PSI_CRYPT_TARGET("sse2")
+inline __m128i rotl128(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi32(v, N), _mm_srli_epi32(v, 32 - N));
+}
+
+PSI_CRYPT_TARGET("sse2")
+inline void quarterRound128(__m128i &a, __m128i &b, __m128i &c, __m128i &d)
+{
+    a = _mm_add_epi32(a, b);
+    d = rotl128<16>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d);
+    b = rotl128<12>(_mm_xor_si128(b, c));
+    a = _mm_add_epi32(a, b);
+    d = rotl128<8>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d);
+    b = rotl128<7>(_mm_xor_si128(b, c));
+}
+
+PSI_CRYPT_TARGET("sse2")
+inline void store128(const uint8_t *in, uint8_t *out, size_t offset, __m128i v)
+{
+    if (in) {
+        v = _mm_xor_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(shift_ptr(in, offset))));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(shift_ptr(out, offset)), v);
+}
+
+template <int N>
+PSI_CRYPT_TARGET("avx2")
+inline __m256i rotl256(__m256i v)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(v, N), _mm256_srli_epi32(v, 32 - N));
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline void quarterRound256(__m256i &a, __m256i &b, __m256i &c, __m256i &d, __m256i rot16, __m256i rot8)
+{
+    // rotations by whole bytes are single shuffles
+    a = _mm256_add_epi32(a, b);
+    d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);
+    c = _mm256_add_epi32(c, d);
+    b = rotl256<12>(_mm256_xor_si256(b, c));
+    a = _mm256_add_epi32(a, b);
+    d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot8);
+    c = _mm256_add_epi32(c, d);
+    b = rotl256<7>(_mm256_xor_si256(b, c));
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline void store256(const uint8_t *in, uint8_t *out, size_t offset, __m128i v)
+{
+    if (in) {
+        v = _mm_xor_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(shift_ptr(in, offset))));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(shift_ptr(out, offset)), v);
+}
+
+} // namespace
+
+PSI_CRYPT_TARGET("sse2")
+void chacha20_simd::blocks4Sse2(const uint32_t *state, const uint8_t *in, uint8_t *out)
+{
+    __m128i x[16u];
+    __m128i orig[16u];
+    for (size_t i = 0; i < 16u; ++i) {
+        orig[i] = _mm_set1_epi32(int(state[i]));
+    }
+    orig[12] = _mm_add_epi32(orig[12], _mm_set_epi32(3, 2, 1, 0));
+    for (size_t i = 0; i < 16u; ++i) {
+        x[i] = orig[i];
+    }
+
+    for (size_t round = 0; round < 10u; ++round) {
+        quarterRound128(x[0], x[4], x[8], x[12]);
+        quarterRound128(x[1], x[5], x[9], x[13]);
+        quarterRound128(x[2], x[6], x[10], x[14]);
+        quarterRound128(x[3], x[7], x[11], x[15]);
+        quarterRound128(x[0], x[5], x[10], x[15]);
+        quarterRound128(x[1], x[6], x[11], x[12]);
+        quarterRound128(x[2], x[7], x[8], x[13]);
+        quarterRound128(x[3], x[4], x[9], x[14]);
+    }
+
+    // transpose every group of 4 words, so each register keeps 16 bytes of one block
+    for (size_t g = 0; g < 4u; ++g) {
+        const __m128i a = _mm_add_epi32(x[g * 4u], orig[g * 4u]);
+        const __m128i b = _mm_add_epi32(x[g * 4u + 1u], orig[g * 4u + 1u]);
+        const __m128i c = _mm_add_epi32(x[g * 4u + 2u], orig[g * 4u + 2u]);
+        const __m128i d = _mm_add_epi32(x[g * 4u + 3u], orig[g * 4u + 3u]);
+        const __m128i t0 = _mm_unpacklo_epi32(a, b);
+        const __m128i t1 = _mm_unpacklo_epi32(c, d);
+        const __m128i t2 = _mm_unpackhi_epi32(a, b);
+        const __m128i t3 = _mm_unpackhi_epi32(c, d);
+        store128(in, out, g * 16u, _mm_unpacklo_epi64(t0, t1));
+        store128(in, out, 64u + g * 16u, _mm_unpackhi_epi64(t0, t1));
+        store128(in, out, 128u + g * 16u, _mm_unpacklo_epi64(t2, t3));
+        store128(in, out, 192u + g * 16u, _mm_unpackhi_epi64(t2, t3));
+    }
+}
+
+PSI_CRYPT_TARGET("avx2")
+void chacha20_simd::blocks8Avx2(const uint32_t *state, const uint8_t *in, uint8_t *out)
+{
+    const __m256i rot16 = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                          13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8 = _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                                         14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+
+    __m256i x[16u];
+    __m256i orig[16u];
+    for (size_t i = 0; i < 16u; ++i) {
+        orig[i] = _mm256_set1_epi32(int(state[i]));
+    }
+    // lanes of lower half keep blocks 0..3, lanes of upper half keep blocks 4..7
+    orig[12] = _mm256_add_epi32(orig[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    for (size_t i = 0; i < 16u; ++i) {
+        x[i] = orig[i];
+    }
+
+    for (size_t round = 0; round < 10u; ++round) {
+        quarterRound256(x[0], x[4], x[8], x[12], rot16, rot8);
+        quarterRound256(x[1], x[5], x[9], x[13], rot16, rot8);
+        quarterRound256(x[2], x[6], x[10], x[14], rot16, rot8);
+        quarterRound256(x[3], x[7], x[11], x[15], rot16, rot8);
+        quarterRound256(x[0], x[5], x[10], x[15], rot16, rot8);
+        quarterRound256(x[1], x[6], x[11], x[12], rot16, rot8);
+        quarterRound256(x[2], x[7], x[8], x[13], rot16, rot8);
+        quarterRound256(x[3], x[4], x[9], x[14], rot16, rot8);
+    }
+
+    // transpose is done within 128-bit halves, so every half register keeps 16 bytes of one block
+    for (size_t g = 0; g < 4u; ++g) {
+        const __m256i a = _mm256_add_epi32(x[g * 4u], orig[g * 4u]);
+        const __m256i b = _mm256_add_epi32(x[g * 4u + 1u], orig[g * 4u + 1u]);
+        const __m256i c = _mm256_add_epi32(x[g * 4u + 2u], orig[g * 4u + 2u]);
+        const __m256i d = _mm256_add_epi32(x[g * 4u + 3u], orig[g * 4u + 3u]);
+        const __m256i t0 = _mm256_unpacklo_epi32(a, b);
+        const __m256i t1 = _mm256_unpacklo_epi32(c, d);
+        const __m256i t2 = _mm256_unpackhi_epi32(a, b);
+        const __m256i t3 = _mm256_unpackhi_epi32(c, d);
+        const __m256i r[4u] = {_mm256_unpacklo_epi64(t0, t1),
+                               _mm256_unpackhi_epi64(t0, t1),
+                               _mm256_unpacklo_epi64(t2, t3),
+                               _mm256_unpackhi_epi64(t2, t3)};
+        for (size_t l = 0; l < 4u; ++l) {
+            store256(in, out, l * 64u + g * 16u, _mm256_castsi256_si128(r[l]));
+            store256(in, out, (l + 4u) * 64u + g * 16u, _mm256_extracti128_si256(r[l], 1));
+        }
+    }
+}
+
+#else
+
+void chacha20_simd::blocks4Sse2(const uint32_t *, const uint8_t *, uint8_t *) {}
+
+void chacha20_simd::blocks8Avx2(const uint32_t *, const uint8_t *, uint8_t *) {}
+
+#endif
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief SSE2 (4 blocks) and AVX2 (8 blocks) kernels of chacha20.
+ * Every call produces keystream of consecutive blocks starting from counter of state, XORed with input if it is
+ * provided. Functions must not be called if corresponding isSupported() returns false.
+ *
+ */
+class chacha20_simd
+{
+public:
+    static bool isSse2Supported();
+    static bool isAvx2Supported();
+
+    static void blocks4Sse2(const uint32_t *state, const uint8_t *in, uint8_t *out);
+    static void blocks8Avx2(const uint32_t *state, const uint8_t *in, uint8_t *out);
+};
+
+} // namespace psi::tools::crypt
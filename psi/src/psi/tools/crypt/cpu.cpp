@@ -0,0 +1,177 @@
+#include "cpu.h"
+
+#ifdef PSI_CRYPT_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef PSI_CRYPT_ARM64
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+namespace {
+
+struct Features {
+    bool aesNi = false;
+    bool ssse3 = false;
+    bool pclmul = false;
+    bool sse2 = false;
+    bool avx2 = false;
+    bool bmi2 = false;
+    bool sse41 = false;
+    bool shaNi = false;
+    bool armSha2 = false;
+    bool avx512f = false;
+};
+
+#ifdef PSI_CRYPT_X86
+void cpuid(uint32_t leaf, uint32_t subLeaf, uint32_t regs[4])
+{
+#ifdef _MSC_VER
+    int r[4] = {};
+    __cpuidex(r, int(leaf), int(subLeaf));
+    for (uint8_t i = 0; i < 4u; ++i) {
+        regs[i] = uint32_t(r[i]);
+    }
+#else
+    __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0 tells which register states are saved by operating system
+uint64_t readXcr0()
+{
+#ifdef _MSC_VER
+    const uint64_t xcr0 = _xgetbv(0);
+#else
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    const uint64_t xcr0 = (uint64_t(edx) << 32) | eax;
+#endif
+    return xcr0;
+}
+#endif
+
+Features detect()
+{
+    Features f;
+#ifdef PSI_CRYPT_X86
+    uint32_t regs[4] = {};
+    cpuid(0, 0, regs);
+    const uint32_t maxLeaf = regs[0];
+    if (maxLeaf < 1u) {
+        return f;
+    }
+
+    cpuid(1, 0, regs);
+    const bool sse2 = regs[3] & (1u << 26);
+    f.aesNi = sse2 && (regs[2] & (1u << 25));
+    f.ssse3 = sse2 && (regs[2] & (1u << 9));
+    f.pclmul = sse2 && (regs[2] & (1u << 1));
+    f.sse2 = sse2;
+    f.sse41 = sse2 && (regs[2] & (1u << 19));
+
+    if (maxLeaf >= 7u) {
+        uint32_t ext[4] = {};
+        cpuid(7, 0, ext);
+        f.shaNi = sse2 && (ext[1] & (1u << 29));
+        f.bmi2 = ext[1] & (1u << 8);
+    }
+
+    // XMM and YMM state for AVX, additionally opmask and ZMM state for AVX-512
+    const bool osxsave = regs[2] & (1u << 27);
+    const uint64_t xcr0 = osxsave ? readXcr0() : 0u;
+    const bool avx = (regs[2] & (1u << 28)) && (xcr0 & 0x6u) == 0x6u;
+    if (avx && maxLeaf >= 7u) {
+        cpuid(7, 0, regs);
+        f.avx2 = regs[1] & (1u << 5);
+        f.avx512f = f.avx2 && (regs[1] & (1u << 16)) && (xcr0 & 0xe6u) == 0xe6u;
+    }
+#elif defined(PSI_CRYPT_ARM64)
+#if defined(_WIN32)
+    f.armSha2 = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE);
+#elif defined(__APPLE__)
+    // every Apple arm64 CPU implements ARMv8 crypto extension
+    f.armSha2 = true;
+#elif defined(__linux__)
+    // HWCAP_SHA2 of arm64 Linux
+    f.armSha2 = getauxval(AT_HWCAP) & (1u << 6);
+#endif
+#endif
+    return f;
+}
+
+const Features &features()
+{
+    static const Features f = detect();
+    return f;
+}
+
+} // namespace
+
+bool cpu::hasAesNi()
+{
+    return features().aesNi;
+}
+
+bool cpu::hasSsse3()
+{
+    return features().ssse3;
+}
+
+bool cpu::hasPclmul()
+{
+    return features().pclmul;
+}
+
+bool cpu::hasSse2()
+{
+    return features().sse2;
+}
+
+bool cpu::hasAvx2()
+{
+    return features().avx2;
+}
+
+bool cpu::hasBmi2()
+{
+    return features().bmi2;
+}
+
+bool cpu::hasAvx512f()
+{
+    return features().avx512f;
+}
+
+bool cpu::hasSse41()
+{
+    return features().sse41;
+}
+
+bool cpu::hasShaNi()
+{
+    return features().shaNi;
+}
+
+bool cpu::hasArmSha2()
+{
+    return features().armSha2;
+}
+
+} // namespace psi::tools::crypt
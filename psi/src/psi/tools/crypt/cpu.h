@@ -0,0 +1,39 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PSI_CRYPT_X86 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define PSI_CRYPT_ARM64 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PSI_CRYPT_TARGET(x) __attribute__((target(x)))
+#else
+#define PSI_CRYPT_TARGET(x)
+#endif
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief Runtime detection of CPU extensions used by hardware accelerated crypt backends.
+ * CPU is queried once, subsequent calls return cached value.
+ *
+ */
+class cpu
+{
+public:
+    static bool hasAesNi();
+    static bool hasSsse3();
+    static bool hasPclmul();
+    static bool hasSse2();
+    static bool hasAvx2();
+    static bool hasBmi2();
+    static bool hasAvx512f();
+    static bool hasSse41();
+    static bool hasShaNi();
+    static bool hasArmSha2();
+};
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,214 @@
+#include "csprng.h"
+#include "chacha20.h"
+
+#include "psi/tools/Tools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <bcrypt.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "bcrypt")
+#endif
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/random.h>
+#endif
+#endif
+
+#ifdef PSI_LOGGER
+#include "psi/logger/Logger.h"
+#else
+#include <iostream>
+#include <sstream>
+#define LOG_TRACE_STATIC(x)                                                                                            \
+    do {                                                                                                               \
+        std::ostringstream os;                                                                                         \
+        os << x;                                                                                                       \
+        std::cout << os.str() << std::endl;                                                                            \
+    } while (0)
+#define LOG_ERROR_STATIC(x) LOG_TRACE_STATIC(x)
+#endif
+
+namespace psi::tools::crypt {
+
+namespace {
+
+struct State {
+    chacha20::Key key = {};
+    std::array<uint8_t, csprng::BUFFER_SIZE> buffer = {};
+    // unused bytes are kept at the end of buffer
+    size_t available = 0;
+    uint64_t sinceReseed = 0;
+    uint32_t forkGeneration = 0;
+    bool isSeeded = false;
+
+    ~State()
+    {
+        mem_wipe(key.data(), key.size());
+        mem_wipe(buffer.data(), buffer.size());
+    }
+};
+
+thread_local State t_state;
+
+// incremented in child process, so states copied by fork() are reseeded before use
+std::atomic<uint32_t> g_forkGeneration = 0;
+
+const chacha20::Nonce ZERO_NONCE = {};
+
+void registerForkHandler()
+{
+#ifndef _WIN32
+    static std::once_flag flag;
+    std::call_once(flag, [] { pthread_atfork(nullptr, nullptr, [] { ++g_forkGeneration; }); });
+#endif
+}
+
+#if defined(__linux__)
+bool readUrandom(uint8_t *out, size_t len)
+{
+    const int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    size_t offset = 0;
+    while (offset < len) {
+        const ssize_t n = read(fd, shift_ptr(out, offset), len - offset);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        offset += size_t(n);
+    }
+    close(fd);
+    return offset == len;
+}
+#endif
+
+bool reseed(State &state)
+{
+    registerForkHandler();
+
+    // seed is mixed into current key, so previous state still contributes if it was seeded
+    chacha20::Key seed = {};
+    if (!csprng::systemRandom(seed.data(), seed.size())) {
+        return false;
+    }
+    for (size_t i = 0; i < seed.size(); ++i) {
+        state.key[i] ^= seed[i];
+    }
+    mem_wipe(seed.data(), seed.size());
+    mem_wipe(state.buffer.data(), state.buffer.size());
+
+    state.available = 0;
+    state.sinceReseed = 0;
+    state.forkGeneration = g_forkGeneration.load(std::memory_order_relaxed);
+    state.isSeeded = true;
+    return true;
+}
+
+void refill(State &state)
+{
+    chacha20::keystream(state.key.data(), ZERO_NONCE.data(), 0u, state.buffer.data(), state.buffer.size());
+    mem_copy(state.key.data(), 0, state.buffer.data(), 0, state.key.size());
+    mem_wipe(state.buffer.data(), state.key.size());
+    state.available = state.buffer.size() - state.key.size();
+}
+
+// served bytes are wiped from buffer, so they cannot be recovered from later state
+void take(State &state, uint8_t *out, size_t len)
+{
+    for (size_t offset = 0; offset < len;) {
+        if (state.available == 0) {
+            refill(state);
+        }
+        const size_t sz = std::min(len - offset, state.available);
+        const size_t pos = state.buffer.size() - state.available;
+        mem_copy(out, offset, state.buffer.data(), pos, sz);
+        mem_wipe(shift_ptr(state.buffer.data(), pos), sz);
+        state.available -= sz;
+        offset += sz;
+    }
+}
+
+} // namespace
+
+bool csprng::fill(uint8_t *out, size_t len)
+{
+    State &state = t_state;
+    if (!state.isSeeded || state.sinceReseed >= RESEED_INTERVAL
+        || state.forkGeneration != g_forkGeneration.load(std::memory_order_relaxed)) {
+        if (!reseed(state)) {
+            mem_wipe(out, len);
+            LOG_ERROR_STATIC("csprng: system random source is not available");
+            return false;
+        }
+    }
+    state.sinceReseed += len;
+
+    if (len < DIRECT_THRESHOLD) {
+        take(state, out, len);
+        return true;
+    }
+
+    // every chunk of bulk request is keystream of one-time key taken from generator
+    chacha20::Key oneTimeKey = {};
+    for (size_t offset = 0; offset < len; offset += DIRECT_CHUNK) {
+        take(state, oneTimeKey.data(), oneTimeKey.size());
+        chacha20::keystream(
+            oneTimeKey.data(), ZERO_NONCE.data(), 0u, shift_ptr(out, offset), std::min(DIRECT_CHUNK, len - offset));
+    }
+    mem_wipe(oneTimeKey.data(), oneTimeKey.size());
+    return true;
+}
+
+bool csprng::systemRandom(uint8_t *out, size_t len)
+{
+#if defined(_WIN32)
+    for (size_t offset = 0; offset < len;) {
+        const ULONG sz = ULONG(std::min<size_t>(len - offset, 1u << 30));
+        if (!BCRYPT_SUCCESS(BCryptGenRandom(nullptr, shift_ptr(out, offset), sz, BCRYPT_USE_SYSTEM_PREFERRED_RNG))) {
+            return false;
+        }
+        offset += sz;
+    }
+    return true;
+#elif defined(__linux__)
+    for (size_t offset = 0; offset < len;) {
+        const ssize_t n = getrandom(shift_ptr(out, offset), len - offset, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // kernels before 3.17
+            return errno == ENOSYS && readUrandom(shift_ptr(out, offset), len - offset);
+        }
+        offset += size_t(n);
+    }
+    return true;
+#else
+    // getentropy() returns at most 256 bytes per call
+    for (size_t offset = 0; offset < len; offset += 256u) {
+        if (getentropy(shift_ptr(out, offset), std::min<size_t>(len - offset, 256u)) != 0) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief Cryptographically secure random generator.
+ * Every thread keeps its own ChaCha20 keystream buffer seeded from operating system, so regular requests take
+ * neither lock nor system call. Generator is rekeyed from its own keystream on every refill (fast key erasure),
+ * reseeded from operating system periodically and after fork().
+ *
+ */
+class csprng
+{
+public:
+    static bool fill(uint8_t *out, size_t len);
+    static bool systemRandom(uint8_t *out, size_t len);
+
+    // keystream generated per refill, first 32 bytes become next key
+    static constexpr size_t BUFFER_SIZE = 1024u;
+    // requests from this size are served by separate keystream written directly to output
+    static constexpr size_t DIRECT_THRESHOLD = 256u;
+    static constexpr size_t DIRECT_CHUNK = 64u * 1024u * 1024u;
+    static constexpr uint64_t RESEED_INTERVAL = 1024u * 1024u;
+};
+
+} // namespace psi::tools::crypt
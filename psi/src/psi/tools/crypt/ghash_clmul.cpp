@@ -0,0 +1,140 @@
+/**
+ * @brief https://www.intel.com/content/dam/develop/external/us/en/documents/clmul-wp-rev-2-02-2014-04-20.pdf
+ * 
+ */
+#include "ghash_clmul.h"
+#include "cpu.h"
+
+#include "psi/tools/Tools.h"
+
+#ifdef PSI_CRYPT_X86
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+namespace psi::tools::crypt {
+
+bool ghash_clmul::isSupported()
+{
+    return cpu::hasPclmul() && cpu::hasSsse3();
+}
+
+#ifdef PSI_CRYPT_X86
+
+namespace {
+
+inline __m128i load(const uint8_t *p, size_t offset)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(shift_ptr(p, offset)));
+}
+
+inline void store(uint8_t *p, size_t offset, __m128i v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(shift_ptr(p, offset)), v);
+}
+
+PSI_CRYPT_TARGET("ssse3")
+inline __m128i bswap(__m128i v)
+{
+    return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+// 256-bit carry-less product of a and b accumulated into {lo, hi}, without reduction
+PSI_CRYPT_TARGET("pclmul,sse2")
+inline void clmulAcc(__m128i a, __m128i b, __m128i &lo, __m128i &hi)
+{
+    const __m128i p00 = _mm_clmulepi64_si128(a, b, 0x00);
+    const __m128i p11 = _mm_clmulepi64_si128(a, b, 0x11);
+    const __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    lo = _mm_xor_si128(lo, _mm_xor_si128(p00, _mm_slli_si128(mid, 8)));
+    hi = _mm_xor_si128(hi, _mm_xor_si128(p11, _mm_srli_si128(mid, 8)));
+}
+
+// operands are bit-reflected, so product is shifted left by 1 bit and then reduced modulo x^128 + x^7 + x^2 + x + 1
+PSI_CRYPT_TARGET("sse2")
+inline __m128i reduce(__m128i lo, __m128i hi)
+{
+    __m128i t7 = _mm_srli_epi32(lo, 31);
+    __m128i t8 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    lo = _mm_or_si128(lo, t7);
+    hi = _mm_or_si128(hi, t8);
+    hi = _mm_or_si128(hi, t9);
+
+    t7 = _mm_slli_epi32(lo, 31);
+    t8 = _mm_slli_epi32(lo, 30);
+    t9 = _mm_slli_epi32(lo, 25);
+    t7 = _mm_xor_si128(t7, _mm_xor_si128(t8, t9));
+    t8 = _mm_srli_si128(t7, 4);
+    t7 = _mm_slli_si128(t7, 12);
+    lo = _mm_xor_si128(lo, t7);
+
+    __m128i t2 = _mm_srli_epi32(lo, 1);
+    t2 = _mm_xor_si128(t2, _mm_srli_epi32(lo, 2));
+    t2 = _mm_xor_si128(t2, _mm_srli_epi32(lo, 7));
+    t2 = _mm_xor_si128(t2, t8);
+    lo = _mm_xor_si128(lo, t2);
+    return _mm_xor_si128(hi, lo);
+}
+
+PSI_CRYPT_TARGET("pclmul,sse2")
+inline __m128i gfMult(__m128i a, __m128i b)
+{
+    __m128i lo = _mm_setzero_si128();
+    __m128i hi = _mm_setzero_si128();
+    clmulAcc(a, b, lo, hi);
+    return reduce(lo, hi);
+}
+
+} // namespace
+
+PSI_CRYPT_TARGET("pclmul,ssse3")
+void ghash_clmul::prepareKey(const uint8_t *h, uint8_t *hPowers)
+{
+    const __m128i h1 = bswap(load(h, 0));
+    __m128i hk = h1;
+    store(hPowers, 0, hk);
+    for (size_t i = 1; i < POWERS; ++i) {
+        hk = gfMult(hk, h1);
+        store(hPowers, i * 16u, hk);
+    }
+}
+
+// X[i] = (X[i-1] XOR C[i]) * H is unrolled 8 times into sum of C[i+j] * H^(8-j), reduced once
+PSI_CRYPT_TARGET("pclmul,ssse3")
+void ghash_clmul::update(const uint8_t *hPowers, uint8_t *state, const uint8_t *data, size_t blocks)
+{
+    __m128i x = bswap(load(state, 0));
+
+    size_t offset = 0;
+    for (; blocks >= POWERS; blocks -= POWERS, offset += POWERS * 16u) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        clmulAcc(_mm_xor_si128(x, bswap(load(data, offset))), load(hPowers, (POWERS - 1u) * 16u), lo, hi);
+        for (size_t j = 1; j < POWERS; ++j) {
+            clmulAcc(bswap(load(data, offset + j * 16u)), load(hPowers, (POWERS - 1u - j) * 16u), lo, hi);
+        }
+        x = reduce(lo, hi);
+    }
+
+    const __m128i h1 = load(hPowers, 0);
+    for (; blocks != 0; --blocks, offset += 16u) {
+        x = gfMult(_mm_xor_si128(x, bswap(load(data, offset))), h1);
+    }
+
+    store(state, 0, bswap(x));
+}
+
+#else
+
+void ghash_clmul::prepareKey(const uint8_t *, uint8_t *) {}
+void ghash_clmul::update(const uint8_t *, uint8_t *, const uint8_t *, size_t) {}
+
+#endif
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief PCLMULQDQ (carry-less multiplication) backend of GHASH.
+ * Powers of H are kept byte-reflected, 16 bytes per power, H^1 first.
+ * Functions must not be called if isSupported() returns false.
+ *
+ */
+class ghash_clmul
+{
+public:
+    static constexpr size_t POWERS = 8u;
+
+    static bool isSupported();
+
+    static void prepareKey(const uint8_t *h, uint8_t *hPowers);
+    static void update(const uint8_t *hPowers, uint8_t *state, const uint8_t *data, size_t blocks);
+};
+
+} // namespace psi::tools::crypt
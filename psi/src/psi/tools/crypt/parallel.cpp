@@ -0,0 +1,45 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace psi::tools::crypt {
+
+size_t parallel::concurrency()
+{
+    static const size_t n = std::max(1u, std::thread::hardware_concurrency());
+    return n;
+}
+
+void parallel::forEach(size_t tasks, const std::function<void(size_t)> &task)
+{
+    const size_t workers = std::min(concurrency(), tasks);
+    if (workers <= 1u) {
+        for (size_t i = 0; i < tasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next = 0;
+    auto worker = [&]() {
+        for (size_t i = next++; i < tasks; i = next++) {
+            task(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1u);
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <functional>
+
+#include <stddef.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief Runs independent parts of crypt operations on all available cores.
+ * Worker threads are started per call, so it is intended for jobs of at least several megabytes.
+ *
+ */
+class parallel
+{
+public:
+    // jobs from this size are split into parts processed by separate threads, start of threads does not pay off below
+    static constexpr size_t THRESHOLD = 4u * 1024u * 1024u;
+
+    static size_t concurrency();
+
+    /**
+     * @brief Invoke task for every index in [0, tasks) and wait for completion.
+     * Caller thread takes part in processing, nothing is started if there is single task or single core.
+     *
+     */
+    static void forEach(size_t tasks, const std::function<void(size_t)> &task);
+};
+
+} // namespace psi::tools::crypt
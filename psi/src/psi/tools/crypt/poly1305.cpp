@@ -0,0 +1,294 @@
+/**
+ * @brief https://www.rfc-editor.org/rfc/rfc8439
+ * 
+ */
+#include "poly1305.h"
+
+#include "psi/tools/Tools.h"
+
+#include <algorithm>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace psi::tools::crypt {
+
+namespace {
+
+constexpr uint64_t MASK44 = 0xfffffffffffull;
+constexpr uint64_t MASK42 = 0x3ffffffffffull;
+
+inline uint64_t load64(const uint8_t *p, size_t offset)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < 8u; ++i) {
+        v |= uint64_t(*shift_ptr(p, offset + i)) << (i * 8u);
+    }
+    return v;
+}
+
+inline void store64(uint8_t *p, size_t offset, uint64_t v)
+{
+    for (size_t i = 0; i < 8u; ++i) {
+        *shift_ptr(p, offset + i) = uint8_t(v >> (i * 8u));
+    }
+}
+
+#if defined(__SIZEOF_INT128__)
+struct U128 {
+    unsigned __int128 v = 0;
+
+    void add(const U128 &o)
+    {
+        v += o.v;
+    }
+
+    void add(uint64_t o)
+    {
+        v += o;
+    }
+
+    uint64_t low() const
+    {
+        return uint64_t(v);
+    }
+
+    uint64_t shr(uint32_t n) const
+    {
+        return uint64_t(v >> n);
+    }
+};
+
+inline U128 mul(uint64_t a, uint64_t b)
+{
+    return U128 {static_cast<unsigned __int128>(a) * b};
+}
+#else
+struct U128 {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    void add(const U128 &o)
+    {
+        lo += o.lo;
+        hi += o.hi + (lo < o.lo);
+    }
+
+    void add(uint64_t o)
+    {
+        lo += o;
+        hi += (lo < o);
+    }
+
+    uint64_t low() const
+    {
+        return lo;
+    }
+
+    // n is in (0, 64)
+    uint64_t shr(uint32_t n) const
+    {
+        return (lo >> n) | (hi << (64u - n));
+    }
+};
+
+inline U128 mul(uint64_t a, uint64_t b)
+{
+    U128 r;
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    r.lo = _umul128(a, b, &r.hi);
+#else
+    const uint64_t aLo = uint32_t(a);
+    const uint64_t aHi = a >> 32;
+    const uint64_t bLo = uint32_t(b);
+    const uint64_t bHi = b >> 32;
+    const uint64_t ll = aLo * bLo;
+    const uint64_t lh = aLo * bHi;
+    const uint64_t hl = aHi * bLo;
+    const uint64_t hh = aHi * bHi;
+    const uint64_t mid = (ll >> 32) + uint32_t(lh) + uint32_t(hl);
+    r.lo = (mid << 32) | uint32_t(ll);
+    r.hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+    return r;
+}
+#endif
+
+} // namespace
+
+// r is clamped, s is kept for final addition
+poly1305::poly1305(const uint8_t *key)
+{
+    const uint64_t t0 = load64(key, 0);
+    const uint64_t t1 = load64(key, 8u);
+    m_r[0] = t0 & 0xffc0fffffffull;
+    m_r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffull;
+    m_r[2] = (t1 >> 24) & 0x00ffffffc0full;
+    m_pad[0] = load64(key, 16u);
+    m_pad[1] = load64(key, 24u);
+}
+
+poly1305::~poly1305()
+{
+    mem_wipe(reinterpret_cast<uint8_t *>(m_r), sizeof(m_r));
+    mem_wipe(reinterpret_cast<uint8_t *>(m_h), sizeof(m_h));
+    mem_wipe(reinterpret_cast<uint8_t *>(m_pad), sizeof(m_pad));
+    mem_wipe(m_buffer, sizeof(m_buffer));
+}
+
+// h = (h + m) * r mod 2^130 - 5, hibit sets bit 128 of every full block
+void poly1305::blocks(const uint8_t *data, size_t count, uint64_t hibit)
+{
+    const uint64_t r0 = m_r[0];
+    const uint64_t r1 = m_r[1];
+    const uint64_t r2 = m_r[2];
+    // 2^132 = 4 * 2^130 = 20 mod p for limbs above 2^130
+    const uint64_t s1 = r1 * 20u;
+    const uint64_t s2 = r2 * 20u;
+    uint64_t h0 = m_h[0];
+    uint64_t h1 = m_h[1];
+    uint64_t h2 = m_h[2];
+
+    for (size_t n = 0; n < count; ++n) {
+        const uint64_t t0 = load64(data, n * BLOCK_SIZE);
+        const uint64_t t1 = load64(data, n * BLOCK_SIZE + 8u);
+        h0 += t0 & MASK44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & MASK44;
+        h2 += ((t1 >> 24) & MASK42) | hibit;
+
+        U128 d0 = mul(h0, r0);
+        d0.add(mul(h1, s2));
+        d0.add(mul(h2, s1));
+        U128 d1 = mul(h0, r1);
+        d1.add(mul(h1, r0));
+        d1.add(mul(h2, s2));
+        U128 d2 = mul(h0, r2);
+        d2.add(mul(h1, r1));
+        d2.add(mul(h2, r0));
+
+        uint64_t c = d0.shr(44);
+        h0 = d0.low() & MASK44;
+        d1.add(c);
+        c = d1.shr(44);
+        h1 = d1.low() & MASK44;
+        d2.add(c);
+        c = d2.shr(42);
+        h2 = d2.low() & MASK42;
+        h0 += c * 5u;
+        c = h0 >> 44;
+        h0 &= MASK44;
+        h1 += c;
+    }
+
+    m_h[0] = h0;
+    m_h[1] = h1;
+    m_h[2] = h2;
+}
+
+void poly1305::update(const uint8_t *data, size_t len)
+{
+    size_t offset = 0;
+    if (m_buffered) {
+        const size_t sz = std::min(len, BLOCK_SIZE - m_buffered);
+        mem_copy(m_buffer, m_buffered, data, 0, sz);
+        m_buffered += sz;
+        offset = sz;
+        if (m_buffered < BLOCK_SIZE) {
+            return;
+        }
+        blocks(m_buffer, 1u, uint64_t(1) << 40);
+        m_buffered = 0;
+    }
+
+    const size_t full = (len - offset) / BLOCK_SIZE;
+    blocks(shift_ptr(data, offset), full, uint64_t(1) << 40);
+    offset += full * BLOCK_SIZE;
+
+    if (offset < len) {
+        mem_copy(m_buffer, 0, data, offset, len - offset);
+        m_buffered = len - offset;
+    }
+}
+
+void poly1305::pad()
+{
+    if (m_buffered) {
+        mem_set(m_buffer, m_buffered, uint8_t(0), BLOCK_SIZE - m_buffered);
+        blocks(m_buffer, 1u, uint64_t(1) << 40);
+        m_buffered = 0;
+    }
+}
+
+void poly1305::finish(uint8_t *tag)
+{
+    // last partial block gets 0x01 right after message and no bit 128
+    if (m_buffered) {
+        m_buffer[m_buffered] = 1u;
+        mem_set(m_buffer, m_buffered + 1u, uint8_t(0), BLOCK_SIZE - m_buffered - 1u);
+        blocks(m_buffer, 1u, 0u);
+        m_buffered = 0;
+    }
+
+    uint64_t h0 = m_h[0];
+    uint64_t h1 = m_h[1];
+    uint64_t h2 = m_h[2];
+
+    // full carry
+    uint64_t c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= MASK42;
+    h0 += c * 5u;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += c;
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= MASK42;
+    h0 += c * 5u;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += c;
+
+    // g = h - p = h + 5 - 2^130, selected without branches if it does not underflow
+    uint64_t g0 = h0 + 5u;
+    c = g0 >> 44;
+    g0 &= MASK44;
+    uint64_t g1 = h1 + c;
+    c = g1 >> 44;
+    g1 &= MASK44;
+    uint64_t g2 = h2 + c - (uint64_t(1) << 42);
+
+    const uint64_t mask = (g2 >> 63) - 1u;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+
+    // h + s mod 2^128
+    const uint64_t t0 = m_pad[0];
+    const uint64_t t1 = m_pad[1];
+    h0 += t0 & MASK44;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & MASK44) + c;
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += ((t1 >> 24) & MASK42) + c;
+    h2 &= MASK42;
+
+    store64(tag, 0, h0 | (h1 << 44));
+    store64(tag, 8u, (h1 >> 20) | (h2 << 24));
+}
+
+void poly1305::compute(const uint8_t *key, const uint8_t *data, size_t len, uint8_t *tag)
+{
+    poly1305 mac(key);
+    mac.update(data, len);
+    mac.finish(tag);
+}
+
+} // namespace psi::tools::crypt
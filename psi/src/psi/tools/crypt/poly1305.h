@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief Poly1305 one-time authenticator of RFC 8439.
+ * Accumulator is kept in three 44/44/42-bit limbs of 64-bit words, products are accumulated in 128 bits.
+ * Key must never be reused for another message.
+ *
+ */
+class poly1305
+{
+public:
+    using Tag = std::array<uint8_t, 16u>;
+
+    static constexpr size_t KEY_SIZE = 32u;
+    static constexpr size_t BLOCK_SIZE = 16u;
+
+    explicit poly1305(const uint8_t *key);
+    ~poly1305();
+
+    poly1305(const poly1305 &) = delete;
+    poly1305 &operator=(const poly1305 &) = delete;
+
+    void update(const uint8_t *data, size_t len);
+    // message is zero padded to multiple of 16 bytes, as required by AEAD construction
+    void pad();
+    void finish(uint8_t *tag);
+
+    static void compute(const uint8_t *key, const uint8_t *data, size_t len, uint8_t *tag);
+
+private:
+    void blocks(const uint8_t *data, size_t blocks, uint64_t hibit);
+
+    uint64_t m_r[3u] = {};
+    uint64_t m_h[3u] = {};
+    uint64_t m_pad[2u] = {};
+    uint8_t m_buffer[BLOCK_SIZE] = {};
+    size_t m_buffered = 0;
+};
+
+} // namespace psi::tools::crypt
@@ -3,31 +3,76 @@
  * https://datatracker.ietf.org/doc/html/rfc4231#page-4
  * 
  */
-#include "sha.h"
+#include "sha.hpp"
+#include "sha_hw.h"
+#include "sha_mb.h"
+#include "sha512_avx2.h"
+
+#include "psi/tools/Hkdf.h"
+
+#include <algorithm>
 
 namespace psi::tools::crypt {
 
-const uint32_t sha::K[64] = {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
-                             0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
-                             0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
-                             0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-                             0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
-                             0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
-                             0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
-                             0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-                             0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
-                             0xc67178f2};
+namespace {
+
+template <typename Hash>
+ByteBuffer hkdfExpandBuffer(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
+{
+    ByteBuffer okm(len);
+    const Hkdf<Hash> hkdf(std::span<const uint8_t>(prk.data(), prk.size()));
+    if (!hkdf.expand(std::span<const uint8_t>(info.data(), info.size()), std::span<uint8_t>(okm.data(), len))) {
+        return {};
+    }
+    okm.skipWrite(len);
+    return okm;
+}
+
+} // namespace
+
+alignas(16) const uint32_t sha::K[64] = {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+                                         0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+                                         0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+                                         0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                                         0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+                                         0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+                                         0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+                                         0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                                         0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+                                         0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+                                         0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
 const uint32_t sha::H[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
-const uint8_t sha::INN_PAD[64] = {0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36,
-                                  0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36,
-                                  0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36,
-                                  0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36,
-                                  0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36};
-const uint8_t sha::OUT_PAD[64] = {0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
-                                  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
-                                  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
-                                  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
-                                  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c};
+alignas(32) const uint64_t sha::K512[80] = {0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+                                            0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+                                            0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+                                            0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+                                            0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+                                            0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+                                            0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+                                            0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+                                            0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+                                            0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+                                            0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+                                            0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+                                            0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+                                            0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+                                            0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+                                            0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+                                            0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+                                            0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+                                            0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+                                            0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+                                            0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+                                            0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+                                            0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+                                            0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+                                            0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+                                            0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+                                            0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+const uint64_t sha::H512[8] = {0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+                               0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+const uint64_t sha::H384[8] = {0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+                               0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4};
 
 ByteBuffer sha::padMessage(const ByteBuffer &data)
 {
@@ -62,11 +107,9 @@ void sha::prepareMessageSchedule(const uint8_t *block, uint32_t *w)
 
 uint32_t sha::rightRotate(uint32_t v, uint8_t n)
 {
-    n %= 32u;
-    if (n == 0) {
-        return v;
-    }
-    return (v << (32u - n)) | (v >> n);
+    // branch free form is recognized by compilers as single rotate instruction
+    n &= 31u;
+    return (v >> n) | (v << ((32u - n) & 31u));
 }
 
 void sha::hashInit(uint32_t h[8u])
@@ -74,106 +117,471 @@ void sha::hashInit(uint32_t h[8u])
     mem_copy(&h[0], 0, &H[0], 0, sizeof(H));
 }
 
-ByteBuffer sha::encode256(const ByteBuffer &data)
+sha::Backend sha::backend()
 {
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
-    auto paddedData = padMessage(data);
+    static const Backend selected = [] {
+        if (sha_hw::isShaNiSupported()) {
+            return Backend::ShaNi;
+        }
+        return sha_hw::isArmv8Supported() ? Backend::Armv8 : Backend::Portable;
+    }();
+    return selected;
+}
 
-    uint8_t dataBlock[64] = {};
-    uint32_t hash[8] = {};
-    hashInit(hash);
-    uint32_t h[8] = {};
-    hashInit(h);
+void sha::compress256(uint32_t h[8u], const uint8_t *blocks, size_t count)
+{
+    compress256(backend(), h, blocks, count);
+}
 
-    while (paddedData.read(dataBlock)) {
-        uint32_t w[64] = {};
-        prepareMessageSchedule(dataBlock, w);
+void sha::compress256(Backend backend, uint32_t h[8u], const uint8_t *blocks, size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    switch (backend) {
+    case Backend::ShaNi:
+        sha_hw::compress256ShaNi(h, blocks, count);
+        break;
+    case Backend::Armv8:
+        sha_hw::compress256Armv8(h, blocks, count);
+        break;
+    case Backend::Portable:
+        compress256Portable(h, blocks, count);
+        break;
+    }
+}
 
+void sha::compress256Portable(uint32_t h[8u], const uint8_t *blocks, size_t count)
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
+    uint32_t w[64] = {};
+    for (size_t b = 0; b < count; ++b) {
+        prepareMessageSchedule(shift_ptr(blocks, b * 64u), w);
+
+        uint32_t v[8] = {};
+        mem_copy(&v[0], 0, &h[0], 0, sizeof(v));
         for (uint8_t i = 0; i < 64u; ++i) {
-            uint32_t S1 = rightRotate(h[4], 6) ^ rightRotate(h[4], 11) ^ rightRotate(h[4], 25);
-            uint32_t ch = (h[4] & h[5]) ^ (~h[4] & h[6]);
-            uint32_t tmp1 = h[7] + S1 + ch + K[i] + w[i];
-            uint32_t S0 = rightRotate(h[0], 2) ^ rightRotate(h[0], 13) ^ rightRotate(h[0], 22);
-            uint32_t maj = (h[0] & h[1]) ^ (h[0] & h[2]) ^ (h[1] & h[2]);
+            uint32_t S1 = rightRotate(v[4], 6) ^ rightRotate(v[4], 11) ^ rightRotate(v[4], 25);
+            uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+            uint32_t tmp1 = v[7] + S1 + ch + K[i] + w[i];
+            uint32_t S0 = rightRotate(v[0], 2) ^ rightRotate(v[0], 13) ^ rightRotate(v[0], 22);
+            uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
             uint32_t tmp2 = S0 + maj;
 
-            h[7] = h[6];
-            h[6] = h[5];
-            h[5] = h[4];
-            h[4] = h[3] + tmp1;
-            h[3] = h[2];
-            h[2] = h[1];
-            h[1] = h[0];
-            h[0] = tmp1 + tmp2;
+            v[7] = v[6];
+            v[6] = v[5];
+            v[5] = v[4];
+            v[4] = v[3] + tmp1;
+            v[3] = v[2];
+            v[2] = v[1];
+            v[1] = v[0];
+            v[0] = tmp1 + tmp2;
         }
 
         for (uint8_t i = 0; i < 8; ++i) {
-            hash[i] += h[i];
-            h[i] = hash[i];
+            h[i] += v[i];
         }
     }
+#pragma clang diagnostic pop
+}
 
-    ByteBuffer out(32u);
-    for (uint8_t i = 0; i < 8; ++i) {
-        out.writeSwapped(hash[i]);
+size_t sha::padTail(const uint8_t *tail, size_t tailLen, uint64_t totalLen, uint8_t block[128u])
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
+    // tail is shorter than one block, padding takes one or two blocks
+    mem_set(block, 0, uint8_t(0), 128u);
+    if (tailLen) {
+        mem_copy(block, 0, tail, 0, tailLen);
+    }
+    block[tailLen] = 0x80;
+    const size_t blocks = tailLen < 56u ? 1u : 2u;
+    const uint64_t bits = totalLen << 3;
+    for (uint8_t i = 0; i < 8u; ++i) {
+        block[blocks * 64u - 1u - i] = uint8_t(bits >> (i * 8u));
     }
+    return blocks;
+#pragma clang diagnostic pop
+}
 
+void sha::storeDigest(const uint32_t h[8u], uint8_t *out)
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
+    for (uint8_t i = 0; i < 8u; ++i) {
+        out[i * 4u] = uint8_t(h[i] >> 24);
+        out[i * 4u + 1u] = uint8_t(h[i] >> 16);
+        out[i * 4u + 2u] = uint8_t(h[i] >> 8);
+        out[i * 4u + 3u] = uint8_t(h[i]);
+    }
 #pragma clang diagnostic pop
+}
+
+void sha::finish256(uint32_t h[8u], const uint8_t *tail, size_t tailLen, uint64_t totalLen, uint8_t *out)
+{
+    uint8_t block[128];
+    compress256(h, block, padTail(tail, tailLen, totalLen, block));
+    mem_wipe(block, sizeof(block));
+    storeDigest(h, out);
+}
+
+void sha::encode256(const uint8_t *data, size_t len, uint8_t *out)
+{
+    uint32_t h[8] = {};
+    hashInit(h);
+
+    const size_t blocks = len / 64u;
+    compress256(h, data, blocks);
+    finish256(h, shift_ptr(data, blocks * 64u), len % 64u, len, out);
+}
+
+ByteBuffer sha::encode256(const ByteBuffer &data)
+{
+    ByteBuffer out(32u);
+    encode256(data.data(), data.size(), out.data());
+    out.skipWrite(32u);
     return out;
 }
 
-ByteBuffer sha::hmac256(const ByteBuffer &key, const ByteBuffer &data)
+sha::BatchBackend sha::batchBackend()
 {
-    key.resetRead();
-    data.resetRead();
+    static const BatchBackend selected = [] {
+        if (sha_mb::isAvx512Supported()) {
+            return BatchBackend::Avx512;
+        }
+        // SHA-NI/ARMv8 hash one message faster than 8 AVX2 lanes hash 8 messages
+        if (backend() != Backend::Portable) {
+            return BatchBackend::Single;
+        }
+        return sha_mb::isAvx2Supported() ? BatchBackend::Avx2 : BatchBackend::Single;
+    }();
+    return selected;
+}
+
+bool sha::encode256Batch(std::span<const std::span<const uint8_t>> messages, std::span<Digest256> digests)
+{
+    return encode256Batch(batchBackend(), messages, digests);
+}
 
-    ByteBuffer paddedKey(64u);
-    if (key.size() > 64u) {
-        encode256(key).readToByteBuffer(paddedKey, 32u);
-    } else {
-        key.readToByteBuffer(paddedKey, key.size());
+bool sha::encode256Batch(BatchBackend backend,
+                         std::span<const std::span<const uint8_t>> messages,
+                         std::span<Digest256> digests)
+{
+    if (digests.size() < messages.size()) {
+        return false;
     }
 
-    ByteBuffer iKeyPad(INN_PAD, 64u);
-    ByteBuffer oKeyPad(OUT_PAD, 64u);
-    for (uint8_t i = 0; i < 64u; ++i) {
-        iKeyPad[i] ^= paddedKey.at(i);
-        oKeyPad[i] ^= paddedKey.at(i);
+    switch (backend) {
+    case BatchBackend::Avx512:
+        encode256Lanes<16u>(&sha_mb::compress16Avx512, messages, digests);
+        break;
+    case BatchBackend::Avx2:
+        encode256Lanes<8u>(&sha_mb::compress8Avx2, messages, digests);
+        break;
+    case BatchBackend::Single:
+        for (size_t i = 0; i < messages.size(); ++i) {
+            encode256(messages[i].data(), messages[i].size(), digests[i].data());
+        }
+        break;
     }
+    return true;
+}
+
+template <size_t LANES>
+void sha::encode256Lanes(void (*kernel)(uint32_t *, const uint32_t *),
+                         std::span<const std::span<const uint8_t>> messages,
+                         std::span<Digest256> digests)
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
+    struct Lane {
+        const uint8_t *data = nullptr;
+        // whole blocks of message, followed by padded tail
+        size_t blocks = 0u;
+        size_t total = 0u;
+        size_t next = 0u;
+        size_t index = 0u;
+        bool active = false;
+        uint8_t tail[128] = {};
+    };
 
-    return encode256(oKeyPad + encode256(iKeyPad + data));
+    // transposed state and message words, word i of lane j is located at [i * LANES + j]
+    alignas(64) uint32_t state[8u * LANES] = {};
+    alignas(64) uint32_t words[16u * LANES] = {};
+    std::array<Lane, LANES> lanes = {};
+    size_t pending = 0u;
+    size_t active = 0u;
+
+    auto assign = [&](Lane &lane, size_t l) {
+        lane.active = pending < messages.size();
+        if (!lane.active) {
+            return;
+        }
+        const auto msg = messages[pending];
+        lane.data = msg.data();
+        lane.blocks = msg.size() / 64u;
+        const uint8_t *tail = shift_ptr(msg.data(), lane.blocks * 64u);
+        lane.total = lane.blocks + padTail(tail, msg.size() % 64u, msg.size(), lane.tail);
+        lane.next = 0u;
+        lane.index = pending++;
+        for (size_t i = 0; i < 8u; ++i) {
+            state[i * LANES + l] = H[i];
+        }
+        ++active;
+    };
+
+    auto blockOf = [](const Lane &lane, size_t n) {
+        return n < lane.blocks ? shift_ptr(lane.data, n * 64u) : &lane.tail[(n - lane.blocks) * 64u];
+    };
+
+    for (size_t l = 0; l < LANES; ++l) {
+        assign(lanes[l], l);
+    }
+
+    // when only few lanes are busy, remaining blocks are hashed faster by single message backend
+    while (active && (pending < messages.size() || active * 4u > LANES)) {
+        for (size_t l = 0; l < LANES; ++l) {
+            if (!lanes[l].active) {
+                continue;
+            }
+            const uint8_t *block = blockOf(lanes[l], lanes[l].next);
+            for (size_t t = 0; t < 16u; ++t) {
+                const uint8_t *p = &block[t * 4u];
+                words[t * LANES + l] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+            }
+        }
+
+        kernel(state, words);
+
+        for (size_t l = 0; l < LANES; ++l) {
+            Lane &lane = lanes[l];
+            if (!lane.active || ++lane.next < lane.total) {
+                continue;
+            }
+            uint32_t h[8];
+            for (size_t i = 0; i < 8u; ++i) {
+                h[i] = state[i * LANES + l];
+            }
+            storeDigest(h, digests[lane.index].data());
+            --active;
+            assign(lane, l);
+        }
+    }
+
+    for (size_t l = 0; l < LANES; ++l) {
+        Lane &lane = lanes[l];
+        if (!lane.active) {
+            continue;
+        }
+        uint32_t h[8];
+        for (size_t i = 0; i < 8u; ++i) {
+            h[i] = state[i * LANES + l];
+        }
+        if (lane.next < lane.blocks) {
+            compress256(h, blockOf(lane, lane.next), lane.blocks - lane.next);
+            lane.next = lane.blocks;
+        }
+        compress256(h, blockOf(lane, lane.next), lane.total - lane.next);
+        storeDigest(h, digests[lane.index].data());
+    }
+
+    mem_wipe(reinterpret_cast<uint8_t *>(words), sizeof(words));
+    for (Lane &lane : lanes) {
+        mem_wipe(lane.tail, sizeof(lane.tail));
+    }
+#pragma clang diagnostic pop
 }
 
-ByteBuffer sha::hkdf256Extract(const ByteBuffer &kMat, const ByteBuffer &seed)
+void sha::prepareMessageSchedule512(const uint8_t *block, uint64_t *w)
 {
-    return sha::hmac256(seed, kMat);
-};
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
+    for (uint8_t i = 0; i < 16u; ++i) {
+        uint64_t v = 0;
+        for (uint8_t j = 0; j < 8u; ++j) {
+            v = (v << 8) | *block++;
+        }
+        w[i] = v;
+    }
 
-ByteBuffer sha::hkdf256Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
+    for (uint8_t i = 16; i < 80; ++i) {
+        uint64_t s0 = rightRotate64(w[i - 15], 1) ^ rightRotate64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        uint64_t s1 = rightRotate64(w[i - 2], 19) ^ rightRotate64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+#pragma clang diagnostic pop
+}
+
+uint64_t sha::rightRotate64(uint64_t v, uint8_t n)
 {
-    const auto blocks = len / 32u + 1;
-    ByteBuffer okm(blocks * 32u);
-    ByteBuffer temp(32u + info.size() + 1u);
+    n &= 63u;
+    return (v >> n) | (v << ((64u - n) & 63u));
+}
+
+void sha::hashInit512(uint64_t h[8u])
+{
+    mem_copy(&h[0], 0, &H512[0], 0, sizeof(H512));
+}
 
-    uint8_t i = 1;
-    while (okm.length() < len) {
-        prk.resetRead();
-        info.resetRead();
-        info.readToByteBuffer(temp, info.size());
-        temp.write(i);
+void sha::hashInit384(uint64_t h[8u])
+{
+    mem_copy(&h[0], 0, &H384[0], 0, sizeof(H384));
+}
 
-        temp.resetRead();
-        auto t = hmac256(prk, temp.readToByteBuffer(temp.length()));
-        t.readToByteBuffer(okm, t.size());
+sha::Backend512 sha::backend512()
+{
+    static const Backend512 selected = sha512_avx2::isSupported() ? Backend512::Avx2 : Backend512::Portable;
+    return selected;
+}
+
+void sha::compress512(uint64_t h[8u], const uint8_t *blocks, size_t count)
+{
+    compress512(backend512(), h, blocks, count);
+}
 
-        temp.clear();
-        t.resetRead();
-        t.readToByteBuffer(temp, t.size());
-        ++i;
+void sha::compress512(Backend512 backend, uint64_t h[8u], const uint8_t *blocks, size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    switch (backend) {
+    case Backend512::Avx2:
+        sha512_avx2::compress512(h, blocks, count);
+        break;
+    case Backend512::Portable:
+        compress512Portable(h, blocks, count);
+        break;
+    }
+}
+
+void sha::compress512Portable(uint64_t h[8u], const uint8_t *blocks, size_t count)
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
+    uint64_t w[80] = {};
+    for (size_t n = 0; n < count; ++n) {
+        prepareMessageSchedule512(shift_ptr(blocks, n * 128u), w);
+        uint64_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        uint64_t bc = b ^ c;
+        // roles of working variables rotate every round, after 8 rounds they return to their places
+        for (uint8_t i = 0; i < 80u; i += 8u) {
+            round512(a, b, d, e, f, g, hh, w[i] + K512[i], bc);
+            round512(hh, a, c, d, e, f, g, w[i + 1u] + K512[i + 1u], bc);
+            round512(g, hh, b, c, d, e, f, w[i + 2u] + K512[i + 2u], bc);
+            round512(f, g, a, b, c, d, e, w[i + 3u] + K512[i + 3u], bc);
+            round512(e, f, hh, a, b, c, d, w[i + 4u] + K512[i + 4u], bc);
+            round512(d, e, g, hh, a, b, c, w[i + 5u] + K512[i + 5u], bc);
+            round512(c, d, f, g, hh, a, b, w[i + 6u] + K512[i + 6u], bc);
+            round512(b, c, e, f, g, hh, a, w[i + 7u] + K512[i + 7u], bc);
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        h[5] += f;
+        h[6] += g;
+        h[7] += hh;
+    }
+    mem_wipe(reinterpret_cast<uint8_t *>(w), sizeof(w));
+#pragma clang diagnostic pop
+}
+
+void sha::finish512(uint64_t h[8u],
+                    const uint8_t *tail,
+                    size_t tailLen,
+                    uint64_t totalLen,
+                    uint8_t *out,
+                    size_t outLen)
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
+    // tail is shorter than one block, padding with 128 bits length takes one or two blocks
+    uint8_t block[256];
+    mem_set(block, 0, uint8_t(0), sizeof(block));
+    if (tailLen) {
+        mem_copy(block, 0, tail, 0, tailLen);
     }
+    block[tailLen] = 0x80;
+    const size_t blocks = tailLen < 112u ? 1u : 2u;
+    const uint64_t bitsLow = totalLen << 3;
+    const uint64_t bitsHigh = totalLen >> 61;
+    for (uint8_t i = 0; i < 8u; ++i) {
+        block[blocks * 128u - 1u - i] = uint8_t(bitsLow >> (i * 8u));
+        block[blocks * 128u - 9u - i] = uint8_t(bitsHigh >> (i * 8u));
+    }
+    compress512(h, block, blocks);
+    mem_wipe(block, sizeof(block));
+
+    // SHA-384 output is truncated state
+    for (size_t i = 0; i < outLen; ++i) {
+        out[i] = uint8_t(h[i / 8u] >> (56u - (i % 8u) * 8u));
+    }
+#pragma clang diagnostic pop
+}
 
-    return okm.readToByteBuffer(len);
+void sha::encode512(const uint8_t *data, size_t len, uint8_t *out)
+{
+    uint64_t h[8] = {};
+    hashInit512(h);
+
+    const size_t blocks = len / 128u;
+    compress512(h, data, blocks);
+    finish512(h, shift_ptr(data, blocks * 128u), len % 128u, len, out, 64u);
+}
+
+void sha::encode384(const uint8_t *data, size_t len, uint8_t *out)
+{
+    uint64_t h[8] = {};
+    hashInit384(h);
+
+    const size_t blocks = len / 128u;
+    compress512(h, data, blocks);
+    finish512(h, shift_ptr(data, blocks * 128u), len % 128u, len, out, 48u);
+}
+
+ByteBuffer sha::encode512(const ByteBuffer &data)
+{
+    ByteBuffer out(64u);
+    encode512(data.data(), data.size(), out.data());
+    out.skipWrite(64u);
+    return out;
+}
+
+ByteBuffer sha::encode384(const ByteBuffer &data)
+{
+    ByteBuffer out(48u);
+    encode384(data.data(), data.size(), out.data());
+    out.skipWrite(48u);
+    return out;
+}
+
+ByteBuffer sha::hmac256(const ByteBuffer &key, const ByteBuffer &data)
+{
+    return HmacSha256Key(key).mac(data);
+}
+
+ByteBuffer sha::hmac512(const ByteBuffer &key, const ByteBuffer &data)
+{
+    return HmacSha512Key(key).mac(data);
+}
+
+ByteBuffer sha::hmac384(const ByteBuffer &key, const ByteBuffer &data)
+{
+    return HmacSha384Key(key).mac(data);
+}
+
+ByteBuffer sha::hkdf256Extract(const ByteBuffer &kMat, const ByteBuffer &seed)
+{
+    return sha::hmac256(seed, kMat);
+};
+
+ByteBuffer sha::hkdf256Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
+{
+    return hkdfExpandBuffer<Sha256>(prk, info, len);
 };
 
 ByteBuffer sha::hkdf256(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len)
@@ -182,4 +590,24 @@ ByteBuffer sha::hkdf256(const ByteBuffer &key, const ByteBuffer &seed, const Byt
     return hkdf256Expand(prk, info, len);
 };
 
+ByteBuffer sha::hkdf512Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
+{
+    return hkdfExpandBuffer<Sha512>(prk, info, len);
+}
+
+ByteBuffer sha::hkdf512(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len)
+{
+    return hkdf512Expand(hmac512(seed, key), info, len);
+}
+
+ByteBuffer sha::hkdf384Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len)
+{
+    return hkdfExpandBuffer<Sha384>(prk, info, len);
+}
+
+ByteBuffer sha::hkdf384(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len)
+{
+    return hkdf384Expand(hmac384(seed, key), info, len);
+}
+
 } // namespace psi::tools::crypt
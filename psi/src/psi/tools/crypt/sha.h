@@ -2,28 +2,115 @@
 
 #include "psi/tools/ByteBuffer.h"
 
+#include <array>
+#include <span>
+
 namespace psi::tools::crypt {
 
 class sha
 {
 public:
+    enum class Backend : uint8_t
+    {
+        Portable,
+        ShaNi,
+        Armv8
+    };
+
+    // multi-buffer backends hash several independent messages at once
+    enum class BatchBackend : uint8_t
+    {
+        Single,
+        Avx2,
+        Avx512
+    };
+
+    // SHA-512/SHA-384 backends, AVX2 computes message schedule of 4 words per step next to scalar rounds
+    enum class Backend512 : uint8_t
+    {
+        Portable,
+        Avx2
+    };
+
+    using Digest256 = std::array<uint8_t, 32u>;
+
     static ByteBuffer padMessage(const ByteBuffer &data);
     static void prepareMessageSchedule(const uint8_t *block, uint32_t *w);
     static uint32_t rightRotate(uint32_t v, uint8_t n);
     static void hashInit(uint32_t h[8u]);
+    static Backend backend();
+    static void compress256(uint32_t h[8u], const uint8_t *blocks, size_t count);
+    static void compress256(Backend backend, uint32_t h[8u], const uint8_t *blocks, size_t count);
+    static void finish256(uint32_t h[8u], const uint8_t *tail, size_t tailLen, uint64_t totalLen, uint8_t *out);
+    static void encode256(const uint8_t *data, size_t len, uint8_t *out);
     static ByteBuffer encode256(const ByteBuffer &data);
+    static BatchBackend batchBackend();
+    static bool encode256Batch(std::span<const std::span<const uint8_t>> messages, std::span<Digest256> digests);
+    static bool encode256Batch(BatchBackend backend,
+                               std::span<const std::span<const uint8_t>> messages,
+                               std::span<Digest256> digests);
+
+    static void prepareMessageSchedule512(const uint8_t *block, uint64_t *w);
+    static uint64_t rightRotate64(uint64_t v, uint8_t n);
+    static void hashInit512(uint64_t h[8u]);
+    static void hashInit384(uint64_t h[8u]);
+    static Backend512 backend512();
+    static void compress512(uint64_t h[8u], const uint8_t *blocks, size_t count);
+    static void compress512(Backend512 backend, uint64_t h[8u], const uint8_t *blocks, size_t count);
+    static void finish512(uint64_t h[8u],
+                          const uint8_t *tail,
+                          size_t tailLen,
+                          uint64_t totalLen,
+                          uint8_t *out,
+                          size_t outLen);
+    static void encode512(const uint8_t *data, size_t len, uint8_t *out);
+    static void encode384(const uint8_t *data, size_t len, uint8_t *out);
+    static ByteBuffer encode512(const ByteBuffer &data);
+    static ByteBuffer encode384(const ByteBuffer &data);
 
     static ByteBuffer hmac256(const ByteBuffer &key, const ByteBuffer &data);
+    static ByteBuffer hmac512(const ByteBuffer &key, const ByteBuffer &data);
+    static ByteBuffer hmac384(const ByteBuffer &key, const ByteBuffer &data);
 
     static ByteBuffer hkdf256Extract(const ByteBuffer &kMat, const ByteBuffer &seed);
     static ByteBuffer hkdf256Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len);
     static ByteBuffer hkdf256(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len);
 
+    static ByteBuffer hkdf512Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len);
+    static ByteBuffer hkdf512(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len);
+    static ByteBuffer hkdf384Expand(const ByteBuffer &prk, const ByteBuffer &info, size_t len);
+    static ByteBuffer hkdf384(const ByteBuffer &key, const ByteBuffer &seed, const ByteBuffer &info, size_t len);
+
 private:
-    static const uint32_t K[64];
+    friend class sha_hw;
+    friend class sha_mb;
+    friend class sha512_avx2;
+
+    static void compress256Portable(uint32_t h[8u], const uint8_t *blocks, size_t count);
+    static size_t padTail(const uint8_t *tail, size_t tailLen, uint64_t totalLen, uint8_t block[128u]);
+    static void storeDigest(const uint32_t h[8u], uint8_t *out);
+    template <size_t LANES>
+    static void encode256Lanes(void (*kernel)(uint32_t *, const uint32_t *),
+                               std::span<const std::span<const uint8_t>> messages,
+                               std::span<Digest256> digests);
+
+    static void compress512Portable(uint64_t h[8u], const uint8_t *blocks, size_t count);
+    // one round over message schedule word already summed with round constant, is defined in sha.hpp
+    static void round512(uint64_t a,
+                         uint64_t b,
+                         uint64_t &d,
+                         uint64_t e,
+                         uint64_t f,
+                         uint64_t g,
+                         uint64_t &h,
+                         uint64_t wk,
+                         uint64_t &bc);
+
+    alignas(16) static const uint32_t K[64];
     static const uint32_t H[8];
-    static const uint8_t INN_PAD[64];
-    static const uint8_t OUT_PAD[64];
+    alignas(32) static const uint64_t K512[80];
+    static const uint64_t H512[8];
+    static const uint64_t H384[8];
 };
 
 } // namespace psi::tools::crypt
@@ -0,0 +1,34 @@
+/**
+ * @brief Inline parts of SHA-512 shared by portable and SIMD backends.
+ * 
+ */
+
+#include "sha.h"
+
+#include <bit>
+
+namespace psi::tools::crypt {
+
+// Ch and Maj are written in forms with fewer operations, b ^ c of the round is a ^ b of the previous one
+inline void sha::round512(uint64_t a,
+                          uint64_t b,
+                          uint64_t &d,
+                          uint64_t e,
+                          uint64_t f,
+                          uint64_t g,
+                          uint64_t &h,
+                          uint64_t wk,
+                          uint64_t &bc)
+{
+    const uint64_t S1 = std::rotr(e, 14) ^ std::rotr(e, 18) ^ std::rotr(e, 41);
+    const uint64_t ch = ((f ^ g) & e) ^ g;
+    const uint64_t tmp1 = h + wk + S1 + ch;
+    const uint64_t S0 = std::rotr(a, 28) ^ std::rotr(a, 34) ^ std::rotr(a, 39);
+    const uint64_t ab = a ^ b;
+    const uint64_t maj = (ab & bc) ^ b;
+    bc = ab;
+    d += tmp1;
+    h = tmp1 + S0 + maj;
+}
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,150 @@
+/**
+ * https://csrc.nist.gov/files/pubs/fips/180-4/upd1/final/docs/fips180-4-draft-aug2014.pdf
+ * https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/fast-sha512-implementations-ia-processors-paper.pdf
+ * 
+ */
+#include "sha512_avx2.h"
+#include "cpu.h"
+#include "sha.hpp"
+
+#include "psi/tools/Tools.h"
+
+#include <utility>
+
+#ifdef PSI_CRYPT_X86
+#include <immintrin.h>
+#endif
+
+namespace psi::tools::crypt {
+
+bool sha512_avx2::isSupported()
+{
+    return cpu::hasAvx2() && cpu::hasBmi2();
+}
+
+#ifdef PSI_CRYPT_X86
+
+namespace {
+
+template <int N>
+PSI_CRYPT_TARGET("avx2")
+inline __m256i rotr64(__m256i v)
+{
+    return _mm256_or_si256(_mm256_srli_epi64(v, N), _mm256_slli_epi64(v, 64 - N));
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i add256(__m256i a, __m256i b)
+{
+    return _mm256_add_epi64(a, b);
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i xor256(__m256i a, __m256i b, __m256i c)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i load256(const void *p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline void store256(void *p, __m256i v)
+{
+    _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i sigma0(__m256i w)
+{
+    return xor256(rotr64<1>(w), rotr64<8>(w), _mm256_srli_epi64(w, 7));
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i sigma1(__m256i w)
+{
+    return xor256(rotr64<19>(w), rotr64<61>(w), _mm256_srli_epi64(w, 6));
+}
+
+// W[t..t+3] from x0 = W[t-16..t-13], x1 = W[t-12..t-9], x2 = W[t-8..t-5], x3 = W[t-4..t-1]
+PSI_CRYPT_TARGET("avx2")
+inline __m256i schedule4(__m256i x0, __m256i x1, __m256i x2, __m256i x3)
+{
+    // W[t-15..t-12] and W[t-7..t-4] straddle two registers, alignr works inside of 128 bits lanes only
+    const __m256i w15 = _mm256_alignr_epi8(_mm256_permute2x128_si256(x0, x1, 0x21), x0, 8);
+    const __m256i w7 = _mm256_alignr_epi8(_mm256_permute2x128_si256(x2, x3, 0x21), x2, 8);
+    __m256i w = add256(add256(x0, sigma0(w15)), w7);
+
+    // sigma1 of W[t-2], W[t-1] completes W[t], W[t+1], which are in turn inputs of sigma1 for W[t+2], W[t+3]
+    const __m256i zero = _mm256_setzero_si256();
+    w = add256(w, _mm256_blend_epi32(zero, sigma1(_mm256_permute4x64_epi64(x3, 0xee)), 0x0f));
+    w = add256(w, _mm256_blend_epi32(zero, sigma1(_mm256_permute4x64_epi64(w, 0x44)), 0xf0));
+    return w;
+}
+
+} // namespace
+
+// BMI2 turns rotates of scalar rounds into non destructive RORX, schedule of next words runs in parallel with rounds
+PSI_CRYPT_TARGET("avx2,bmi2")
+void sha512_avx2::compress512(uint64_t *h, const uint8_t *blocks, size_t count)
+{
+    // reverses bytes of every 64 bits word
+    const __m256i bswap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                           7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    alignas(32) uint64_t wk[80];
+
+    for (size_t n = 0; n < count; ++n) {
+        const uint8_t *block = shift_ptr(blocks, n * 128u);
+
+        // message schedule is kept in rolling window of 4 registers, 4 words each
+        __m256i x[4];
+        for (size_t i = 0; i < 4u; ++i) {
+            x[i] = _mm256_shuffle_epi8(load256(shift_ptr(block, i * 32u)), bswap);
+            store256(&wk[i * 4u], add256(x[i], load256(&sha::K512[i * 4u])));
+        }
+
+        uint64_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        uint64_t bc = b ^ c;
+        for (size_t t = 0; t < 80u; t += 8u) {
+            // words of rounds t + 16 .. t + 23 are not needed by rounds t .. t + 7
+            if (t < 64u) {
+                x[0] = schedule4(x[0], x[1], x[2], x[3]);
+                store256(&wk[t + 16u], add256(x[0], load256(&sha::K512[t + 16u])));
+                x[1] = schedule4(x[1], x[2], x[3], x[0]);
+                store256(&wk[t + 20u], add256(x[1], load256(&sha::K512[t + 20u])));
+                std::swap(x[0], x[2]);
+                std::swap(x[1], x[3]);
+            }
+
+            sha::round512(a, b, d, e, f, g, hh, wk[t], bc);
+            sha::round512(hh, a, c, d, e, f, g, wk[t + 1u], bc);
+            sha::round512(g, hh, b, c, d, e, f, wk[t + 2u], bc);
+            sha::round512(f, g, a, b, c, d, e, wk[t + 3u], bc);
+            sha::round512(e, f, hh, a, b, c, d, wk[t + 4u], bc);
+            sha::round512(d, e, g, hh, a, b, c, wk[t + 5u], bc);
+            sha::round512(c, d, f, g, hh, a, b, wk[t + 6u], bc);
+            sha::round512(b, c, e, f, g, hh, a, wk[t + 7u], bc);
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        h[5] += f;
+        h[6] += g;
+        h[7] += hh;
+    }
+
+    mem_wipe(reinterpret_cast<uint8_t *>(wk), sizeof(wk));
+}
+
+#else
+
+void sha512_avx2::compress512(uint64_t *, const uint8_t *, size_t) {}
+
+#endif
+
+} // namespace psi::tools::crypt
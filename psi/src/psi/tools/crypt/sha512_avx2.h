@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief AVX2 backend of SHA-512 compression function.
+ * Message schedule of every block is computed 4 words per step in 256 bits registers and runs in parallel with
+ * scalar rounds, which are serial by design and use BMI2 rotates.
+ * State is kept in standard order h[0..7], every call compresses count 128 bytes blocks.
+ * Functions must not be called if isSupported() returns false.
+ *
+ */
+class sha512_avx2
+{
+public:
+    static bool isSupported();
+
+    static void compress512(uint64_t *h, const uint8_t *blocks, size_t count);
+};
+
+} // namespace psi::tools::crypt
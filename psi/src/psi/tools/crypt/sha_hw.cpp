@@ -0,0 +1,197 @@
+/**
+ * https://www.intel.com/content/www/us/en/developer/articles/technical/intel-sha-extensions.html
+ * https://developer.arm.com/architectures/instruction-sets/intrinsics/#f:@navigationhierarchiesinstructiongroup=[Cryptography,SHA256]
+ * 
+ */
+#include "sha_hw.h"
+#include "cpu.h"
+#include "sha.h"
+
+#include "psi/tools/Tools.h"
+
+#ifdef PSI_CRYPT_X86
+#include <immintrin.h>
+#endif
+
+#ifdef PSI_CRYPT_ARM64
+#include <arm_neon.h>
+// intrinsics of older clang are available only if extension is enabled for whole translation unit
+#if defined(_MSC_VER) || defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#define PSI_SHA_ARMV8 1
+#define PSI_SHA_ARMV8_TARGET
+#elif defined(__clang__) && __clang_major__ >= 16
+#define PSI_SHA_ARMV8 1
+#define PSI_SHA_ARMV8_TARGET PSI_CRYPT_TARGET("sha2")
+#elif defined(__GNUC__) && !defined(__clang__)
+#define PSI_SHA_ARMV8 1
+#define PSI_SHA_ARMV8_TARGET PSI_CRYPT_TARGET("+crypto")
+#endif
+#endif
+
+namespace psi::tools::crypt {
+
+bool sha_hw::isShaNiSupported()
+{
+    return cpu::hasShaNi() && cpu::hasSse41();
+}
+
+bool sha_hw::isArmv8Supported()
+{
+#ifdef PSI_SHA_ARMV8
+    return cpu::hasArmSha2();
+#else
+    return false;
+#endif
+}
+
+#ifdef PSI_CRYPT_X86
+
+namespace {
+
+inline __m128i load(const void *p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+PSI_CRYPT_TARGET("sha,sse4.1")
+inline void rounds4(__m128i &abef, __m128i &cdgh, __m128i w, const uint32_t *k)
+{
+    const __m128i wk = _mm_add_epi32(w, load(k));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+}
+
+// next 4 words of message schedule from previous 16
+PSI_CRYPT_TARGET("sha,sse4.1")
+inline __m128i schedule(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    const __m128i w = _mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4));
+    return _mm_sha256msg2_epu32(w, w3);
+}
+
+} // namespace
+
+PSI_CRYPT_TARGET("sha,sse4.1")
+void sha_hw::compress256ShaNi(uint32_t *h, const uint8_t *blocks, size_t count)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+
+    // SHA256RNDS2 keeps state as {A, B, E, F} and {C, D, G, H}
+    const __m128i dcba = _mm_shuffle_epi32(load(h), 0xb1);
+    const __m128i efgh = _mm_shuffle_epi32(load(shift_ptr(h, 4u)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(dcba, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+    for (size_t b = 0; b < count; ++b) {
+        const uint8_t *block = shift_ptr(blocks, b * 64u);
+        const __m128i abefSaved = abef;
+        const __m128i cdghSaved = cdgh;
+
+        __m128i w0 = _mm_shuffle_epi8(load(block), bswap);
+        __m128i w1 = _mm_shuffle_epi8(load(shift_ptr(block, 16u)), bswap);
+        __m128i w2 = _mm_shuffle_epi8(load(shift_ptr(block, 32u)), bswap);
+        __m128i w3 = _mm_shuffle_epi8(load(shift_ptr(block, 48u)), bswap);
+
+        for (size_t r = 0; r < 64u; r += 16u) {
+            const uint32_t *k = &sha::K[r];
+            rounds4(abef, cdgh, w0, k);
+            rounds4(abef, cdgh, w1, shift_ptr(k, 4u));
+            rounds4(abef, cdgh, w2, shift_ptr(k, 8u));
+            rounds4(abef, cdgh, w3, shift_ptr(k, 12u));
+            if (r < 48u) {
+                w0 = schedule(w0, w1, w2, w3);
+                w1 = schedule(w1, w2, w3, w0);
+                w2 = schedule(w2, w3, w0, w1);
+                w3 = schedule(w3, w0, w1, w2);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(h), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(shift_ptr(h, 4u)), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+#else
+
+void sha_hw::compress256ShaNi(uint32_t *, const uint8_t *, size_t) {}
+
+#endif
+
+#ifdef PSI_SHA_ARMV8
+
+namespace {
+
+PSI_SHA_ARMV8_TARGET
+inline uint32x4_t loadWords(const uint8_t *p)
+{
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+PSI_SHA_ARMV8_TARGET
+inline void rounds4(uint32x4_t &abcd, uint32x4_t &efgh, uint32x4_t w, const uint32_t *k)
+{
+    const uint32x4_t wk = vaddq_u32(w, vld1q_u32(k));
+    const uint32x4_t abcdPrev = abcd;
+    abcd = vsha256hq_u32(abcd, efgh, wk);
+    efgh = vsha256h2q_u32(efgh, abcdPrev, wk);
+}
+
+// next 4 words of message schedule from previous 16
+PSI_SHA_ARMV8_TARGET
+inline uint32x4_t schedule(uint32x4_t w0, uint32x4_t w1, uint32x4_t w2, uint32x4_t w3)
+{
+    return vsha256su1q_u32(vsha256su0q_u32(w0, w1), w2, w3);
+}
+
+} // namespace
+
+PSI_SHA_ARMV8_TARGET
+void sha_hw::compress256Armv8(uint32_t *h, const uint8_t *blocks, size_t count)
+{
+    uint32x4_t abcd = vld1q_u32(h);
+    uint32x4_t efgh = vld1q_u32(shift_ptr(h, 4u));
+
+    for (size_t b = 0; b < count; ++b) {
+        const uint8_t *block = shift_ptr(blocks, b * 64u);
+        const uint32x4_t abcdSaved = abcd;
+        const uint32x4_t efghSaved = efgh;
+
+        uint32x4_t w0 = loadWords(block);
+        uint32x4_t w1 = loadWords(shift_ptr(block, 16u));
+        uint32x4_t w2 = loadWords(shift_ptr(block, 32u));
+        uint32x4_t w3 = loadWords(shift_ptr(block, 48u));
+
+        for (size_t r = 0; r < 64u; r += 16u) {
+            const uint32_t *k = &sha::K[r];
+            rounds4(abcd, efgh, w0, k);
+            rounds4(abcd, efgh, w1, shift_ptr(k, 4u));
+            rounds4(abcd, efgh, w2, shift_ptr(k, 8u));
+            rounds4(abcd, efgh, w3, shift_ptr(k, 12u));
+            if (r < 48u) {
+                w0 = schedule(w0, w1, w2, w3);
+                w1 = schedule(w1, w2, w3, w0);
+                w2 = schedule(w2, w3, w0, w1);
+                w3 = schedule(w3, w0, w1, w2);
+            }
+        }
+
+        abcd = vaddq_u32(abcd, abcdSaved);
+        efgh = vaddq_u32(efgh, efghSaved);
+    }
+
+    vst1q_u32(h, abcd);
+    vst1q_u32(shift_ptr(h, 4u), efgh);
+}
+
+#else
+
+void sha_hw::compress256Armv8(uint32_t *, const uint8_t *, size_t) {}
+
+#endif
+
+} // namespace psi::tools::crypt
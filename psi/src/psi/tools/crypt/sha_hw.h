@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief SHA-NI (SHA256RNDS2/SHA256MSG1/SHA256MSG2) and ARMv8 (SHA256H/SHA256H2/SHA256SU0/SHA256SU1) backends of
+ * SHA-256 compression function.
+ * State is kept in standard order h[0..7], every call compresses count 64 bytes blocks.
+ * Functions must not be called if corresponding isSupported() returns false.
+ *
+ */
+class sha_hw
+{
+public:
+    static bool isShaNiSupported();
+    static bool isArmv8Supported();
+
+    static void compress256ShaNi(uint32_t *h, const uint8_t *blocks, size_t count);
+    static void compress256Armv8(uint32_t *h, const uint8_t *blocks, size_t count);
+};
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,198 @@
+#include "sha_mb.h"
+#include "cpu.h"
+#include "sha.h"
+
+#include "psi/tools/Tools.h"
+
+#ifdef PSI_CRYPT_X86
+#include <immintrin.h>
+#endif
+
+namespace psi::tools::crypt {
+
+bool sha_mb::isAvx2Supported()
+{
+    return cpu::hasAvx2();
+}
+
+bool sha_mb::isAvx512Supported()
+{
+    return cpu::hasAvx512f();
+}
+
+#ifdef PSI_CRYPT_X86
+
+// GCC 12 reports false positive on undefined vectors used inside of AVX-512 intrinsics
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace {
+
+template <int N>
+PSI_CRYPT_TARGET("avx2")
+inline __m256i rotr256(__m256i v)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(v, N), _mm256_slli_epi32(v, 32 - N));
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i add256(__m256i a, __m256i b)
+{
+    return _mm256_add_epi32(a, b);
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i xor256(__m256i a, __m256i b, __m256i c)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline __m256i load256(const uint32_t *p, size_t row)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(shift_ptr(p, row * 8u)));
+}
+
+PSI_CRYPT_TARGET("avx2")
+inline void store256(uint32_t *p, size_t row, __m256i v)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(shift_ptr(p, row * 8u)), v);
+}
+
+PSI_CRYPT_TARGET("avx512f")
+inline __m512i add512(__m512i a, __m512i b)
+{
+    return _mm512_add_epi32(a, b);
+}
+
+PSI_CRYPT_TARGET("avx512f")
+inline __m512i xor512(__m512i a, __m512i b, __m512i c)
+{
+    return _mm512_ternarylogic_epi32(a, b, c, 0x96);
+}
+
+PSI_CRYPT_TARGET("avx512f")
+inline __m512i load512(const uint32_t *p, size_t row)
+{
+    return _mm512_loadu_si512(shift_ptr(p, row * 16u));
+}
+
+PSI_CRYPT_TARGET("avx512f")
+inline void store512(uint32_t *p, size_t row, __m512i v)
+{
+    _mm512_storeu_si512(shift_ptr(p, row * 16u), v);
+}
+
+} // namespace
+
+PSI_CRYPT_TARGET("avx2")
+void sha_mb::compress8Avx2(uint32_t *state, const uint32_t *words)
+{
+    __m256i v[8];
+    for (size_t i = 0; i < 8u; ++i) {
+        v[i] = load256(state, i);
+    }
+
+    // message schedule is kept in rolling window of 16 words
+    __m256i w[16];
+    for (size_t t = 0; t < 64u; ++t) {
+        if (t < 16u) {
+            w[t] = load256(words, t);
+        } else {
+            const __m256i w15 = w[(t - 15u) & 15u];
+            const __m256i w2 = w[(t - 2u) & 15u];
+            const __m256i s0 = xor256(rotr256<7>(w15), rotr256<18>(w15), _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = xor256(rotr256<17>(w2), rotr256<19>(w2), _mm256_srli_epi32(w2, 10));
+            w[t & 15u] = add256(add256(w[t & 15u], s0), add256(w[(t - 7u) & 15u], s1));
+        }
+
+        const __m256i a = v[0];
+        const __m256i e = v[4];
+        const __m256i S1 = xor256(rotr256<6>(e), rotr256<11>(e), rotr256<25>(e));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, v[5]), _mm256_andnot_si256(e, v[6]));
+        const __m256i k = _mm256_set1_epi32(int(sha::K[t]));
+        const __m256i tmp1 = add256(add256(add256(v[7], S1), add256(ch, k)), w[t & 15u]);
+        const __m256i S0 = xor256(rotr256<2>(a), rotr256<13>(a), rotr256<22>(a));
+        const __m256i ab = _mm256_and_si256(a, v[1]);
+        const __m256i maj = _mm256_or_si256(ab, _mm256_and_si256(v[2], _mm256_or_si256(a, v[1])));
+        const __m256i tmp2 = add256(S0, maj);
+
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = e;
+        v[4] = add256(v[3], tmp1);
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = a;
+        v[0] = add256(tmp1, tmp2);
+    }
+
+    for (size_t i = 0; i < 8u; ++i) {
+        store256(state, i, add256(load256(state, i), v[i]));
+    }
+}
+
+PSI_CRYPT_TARGET("avx512f")
+void sha_mb::compress16Avx512(uint32_t *state, const uint32_t *words)
+{
+    __m512i v[8];
+    for (size_t i = 0; i < 8u; ++i) {
+        v[i] = load512(state, i);
+    }
+
+    // message schedule is kept in rolling window of 16 words
+    __m512i w[16];
+    for (size_t t = 0; t < 64u; ++t) {
+        if (t < 16u) {
+            w[t] = load512(words, t);
+        } else {
+            const __m512i w15 = w[(t - 15u) & 15u];
+            const __m512i w2 = w[(t - 2u) & 15u];
+            const __m512i s0 = xor512(_mm512_ror_epi32(w15, 7), _mm512_ror_epi32(w15, 18), _mm512_srli_epi32(w15, 3));
+            const __m512i s1 = xor512(_mm512_ror_epi32(w2, 17), _mm512_ror_epi32(w2, 19), _mm512_srli_epi32(w2, 10));
+            w[t & 15u] = add512(add512(w[t & 15u], s0), add512(w[(t - 7u) & 15u], s1));
+        }
+
+        const __m512i a = v[0];
+        const __m512i e = v[4];
+        const __m512i S1 = xor512(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25));
+        // e ? f : g
+        const __m512i ch = _mm512_ternarylogic_epi32(e, v[5], v[6], 0xca);
+        const __m512i k = _mm512_set1_epi32(int(sha::K[t]));
+        const __m512i tmp1 = add512(add512(add512(v[7], S1), add512(ch, k)), w[t & 15u]);
+        const __m512i S0 = xor512(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22));
+        // majority of a, b, c
+        const __m512i maj = _mm512_ternarylogic_epi32(a, v[1], v[2], 0xe8);
+        const __m512i tmp2 = add512(S0, maj);
+
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = e;
+        v[4] = add512(v[3], tmp1);
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = a;
+        v[0] = add512(tmp1, tmp2);
+    }
+
+    for (size_t i = 0; i < 8u; ++i) {
+        store512(state, i, add512(load512(state, i), v[i]));
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#else
+
+void sha_mb::compress8Avx2(uint32_t *, const uint32_t *) {}
+
+void sha_mb::compress16Avx512(uint32_t *, const uint32_t *) {}
+
+#endif
+
+} // namespace psi::tools::crypt
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psi::tools::crypt {
+
+/**
+ * @brief Multi-buffer AVX2 (8 lanes) and AVX-512 (16 lanes) kernels of SHA-256 compression function.
+ * Every lane hashes its own message, one 64 bytes block per lane is compressed by one call.
+ * State and message words are transposed, word i of lane j is located at [i * LANES + j], message words are
+ * already converted from big endian. Functions must not be called if corresponding isSupported() returns false.
+ *
+ */
+class sha_mb
+{
+public:
+    static bool isAvx2Supported();
+    static bool isAvx512Supported();
+
+    static void compress8Avx2(uint32_t *state, const uint32_t *words);
+    static void compress16Avx512(uint32_t *state, const uint32_t *words);
+};
+
+} // namespace psi::tools::crypt
@@ -1,4 +1,5 @@
 #include "x25519.h"
+#include "csprng.h"
 
 #include "psi/tools/Encryptor.h"
 
@@ -129,10 +130,15 @@ void x25519::scalarmult_base(uint8_t *out, const uint8_t *scalar)
     scalarmult(out, scalar, _9.data());
 }
 
-void x25519::generate_keypair(uint8_t *pk, uint8_t *sk)
+bool x25519::generate_keypair(uint8_t *pk, uint8_t *sk)
 {
-    mem_copy(sk, 0, Encryptor::generateSessionKey().data(), 0, 32u);
+    // zeroed scalar is never turned into public key
+    if (!csprng::fill(sk, 32u)) {
+        mem_wipe(pk, 32u);
+        return false;
+    }
     scalarmult_base(pk, sk);
+    return true;
 }
 
 void x25519::scalarmult(uint8_t *out, const uint8_t *scalar, const uint8_t *point)
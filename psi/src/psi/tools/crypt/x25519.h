@@ -8,7 +8,7 @@ namespace psi::tools::crypt {
 class x25519
 {
 public:
-    static void generate_keypair(uint8_t *pk, uint8_t *sk);
+    static bool generate_keypair(uint8_t *pk, uint8_t *sk);
     static void scalarmult_base(uint8_t *out, const uint8_t *sk);
     static void scalarmult(uint8_t *out, const uint8_t *sk, const uint8_t *pk);
 
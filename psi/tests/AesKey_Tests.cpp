@@ -0,0 +1,58 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+
+#include "psi/tools/AesKey.h"
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(AesKeyTests, invalidKey)
+{
+    EXPECT_FALSE(AesKey().isValid());
+    EXPECT_FALSE(AesKey(ByteBuffer(15u)).isValid());
+    EXPECT_FALSE(AesKey(ByteBuffer(24u)).isValid());
+    EXPECT_EQ(AesKey(ByteBuffer(33u)).keySize(), 0u);
+    EXPECT_EQ(AesKey(ByteBuffer(0u)).rounds(), 0u);
+}
+
+TEST(AesKeyTests, expandKey_AES128)
+{
+    const ByteBuffer
+        expectedEnhancedKey("2b7e151628aed2a6abf7158809cf4f3ca0fafe1788542cb123a339392a6c7605f2c295f27a96b9435935807a73"
+                            "59f67f3d80477d4716fe3e1e237e446d7a883bef44a541a8525b7fb671253bdb0bad00d4d1c6f87c839d87caf2"
+                            "b8bc11f915bc6d88a37a110b3efddbf98641ca0093fd4e54f70e5f5fc9f384a64fb24ea6dc4fead27321b58dba"
+                            "d2312bf5607f8d292fac7766f319fadc2128d12941575c006ed014f9a8c9ee2589e13f0cc8b6630ca6",
+                            true);
+
+    const AesKey key(ByteBuffer("2b7e151628aed2a6abf7158809cf4f3c", true));
+    ASSERT_EQ(key.isValid(), true);
+    EXPECT_EQ(key.keySize(), 16u);
+    EXPECT_EQ(key.rounds(), 10u);
+
+    ByteBuffer enhancedKey(16u * 11u);
+    for (size_t i = 0; i <= key.rounds(); ++i) {
+        enhancedKey.write(key.roundKey(i));
+    }
+    EXPECT_EQ(enhancedKey.asHexString(), expectedEnhancedKey.asHexString());
+}
+
+TEST(AesKeyTests, expandKey_AES256)
+{
+    const ByteBuffer keyData("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", true);
+    const AesKey key(keyData.data(), keyData.size());
+    ASSERT_EQ(key.isValid(), true);
+    EXPECT_EQ(key.keySize(), 32u);
+    EXPECT_EQ(key.rounds(), 14u);
+
+    ByteBuffer roundKey(16u);
+    roundKey.write(key.roundKey(0));
+    EXPECT_EQ(roundKey.asHexString(), "603deb1015ca71be2b73aef0857d7781");
+
+    roundKey.clear();
+    roundKey.write(key.roundKey(2));
+    EXPECT_EQ(roundKey.asHexString(), "9ba354118e6925afa51a8b5f2067fcde");
+
+    roundKey.clear();
+    roundKey.write(key.roundKey(14));
+    EXPECT_EQ(roundKey.asHexString(), "fe4890d1e6188d0b046df344706c631e");
+}
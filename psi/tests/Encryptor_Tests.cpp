@@ -1,9 +1,12 @@
 #include "psi/test/TestHelper.h"
 #include "psi/test/psi_mock.h"
+#include "TestData.h"
 
+#include <algorithm>
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <vector>
 
 #include "psi/tools/Encryptor.h"
 #include "psi/tools/Tools.h"
@@ -176,6 +179,291 @@ TEST(EncryptorTests, EncryptionDecryption_AES_256)
            "591ccb10d410ed26dc5ba74a31362870");
 }
 
+TEST(EncryptorTests, EncryptionDecryption_AesKey)
+{
+    const AesKey key128(ByteBuffer("000102030405060708090a0b0c0d0e0f", true));
+    const AesKey key256(ByteBuffer("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true));
+    const ByteBuffer message("00112233445566778899aabbccddeeff", true);
+
+    {
+        // SCOPED_TRACE("// case 1. AES-128");
+
+        const auto encryptedMessage = Encryptor::encryptAes128(message, key128);
+        EXPECT_EQ(encryptedMessage.asHexString(), "69c4e0d86a7b0430d8cdb78070b4c55a");
+        const auto decryptedMessage = Encryptor::decryptAes128(encryptedMessage, key128);
+        EXPECT_EQ(decryptedMessage.asHexString(), message.asHexString());
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. AES-256");
+
+        const auto encryptedMessage = Encryptor::encryptAes256(message, key256);
+        EXPECT_EQ(encryptedMessage.asHexString(), "8ea2b7ca516745bfeafc49904b496089");
+        const auto decryptedMessage = Encryptor::decryptAes256(encryptedMessage, key256);
+        EXPECT_EQ(decryptedMessage.asHexString(), message.asHexString());
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. AES-128-GCM");
+
+        const ByteBuffer iv("cafebabefacedbaddecaf888", true);
+        const ByteBuffer add("feedfacedeadbeef", true);
+        ByteBuffer tag(16u);
+        const auto encryptedMessage = Encryptor::encryptAes128Gcm(message, key128, iv, tag, add);
+
+        ByteBuffer expectedTag(16u);
+        const auto expectedMessage =
+            Encryptor::encryptAes128Gcm(message, ByteBuffer("000102030405060708090a0b0c0d0e0f", true), iv, expectedTag, add);
+        EXPECT_EQ(encryptedMessage.asHexString(), expectedMessage.asHexString());
+        EXPECT_EQ(tag.asHexString(), expectedTag.asHexString());
+
+        const auto decryptedMessage = Encryptor::decryptAes128Gcm(encryptedMessage, key128, iv, tag, add);
+        EXPECT_EQ(decryptedMessage.asHexString(), message.asHexString());
+    }
+
+    {
+        // SCOPED_TRACE("// case 4. key size mismatch");
+
+        EXPECT_EQ(Encryptor::encryptAes128(message, key256).size(), 0u);
+        EXPECT_EQ(Encryptor::encryptAes256(message, key128).size(), 0u);
+        EXPECT_EQ(Encryptor::decryptAes256(message, AesKey()).size(), 0u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 5. AES-256-GCM");
+
+        const ByteBuffer iv("cafebabefacedbaddecaf888", true);
+        const ByteBuffer add("feedfacedeadbeef", true);
+        ByteBuffer tag(16u);
+        const auto encryptedMessage = Encryptor::encryptAes256Gcm(message, key256, iv, tag, add);
+
+        ByteBuffer expectedTag(16u);
+        const auto expectedMessage = Encryptor::encryptAes256Gcm(
+            message, ByteBuffer("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true), iv, expectedTag, add);
+        EXPECT_EQ(encryptedMessage.asHexString(), expectedMessage.asHexString());
+        EXPECT_EQ(tag.asHexString(), expectedTag.asHexString());
+
+        const auto decryptedMessage = Encryptor::decryptAes256Gcm(encryptedMessage, key256, iv, tag, add);
+        EXPECT_EQ(decryptedMessage.asHexString(), message.asHexString());
+
+        ByteBuffer tag128(16u);
+        EXPECT_EQ(Encryptor::encryptAes128Gcm(message, key256, iv, tag128, add).size(), 0u);
+        EXPECT_EQ(Encryptor::decryptAes256Gcm(encryptedMessage, key128, iv, tag, add).size(), 0u);
+        EXPECT_EQ(Encryptor::decryptAes128Gcm(encryptedMessage, key256, iv, tag, add).size(), 0u);
+        EXPECT_EQ(Encryptor::decryptAes256Gcm(encryptedMessage, key256, iv, ByteBuffer(), add).size(), 0u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 6. CBC and CTR");
+
+        const ByteBuffer iv("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", true);
+        const ByteBuffer rawKey128("000102030405060708090a0b0c0d0e0f", true);
+        const ByteBuffer rawKey256("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true);
+
+        auto encryptedMessage = Encryptor::encryptAes128Cbc(message, key128, iv);
+        EXPECT_EQ(encryptedMessage.size(), 32u);
+        EXPECT_EQ(encryptedMessage.asHexString(), Encryptor::encryptAes128Cbc(message, rawKey128, iv).asHexString());
+        EXPECT_EQ(Encryptor::decryptAes128Cbc(encryptedMessage, key128, iv).asHexString(), message.asHexString());
+
+        encryptedMessage = Encryptor::encryptAes256Cbc(message, key256, iv);
+        EXPECT_EQ(encryptedMessage.asHexString(), Encryptor::encryptAes256Cbc(message, rawKey256, iv).asHexString());
+        EXPECT_EQ(Encryptor::decryptAes256Cbc(encryptedMessage, rawKey256, iv).asHexString(), message.asHexString());
+        EXPECT_EQ(Encryptor::decryptAes128Cbc(encryptedMessage, key256, iv).size(), 0u);
+
+        encryptedMessage = Encryptor::encryptAes128Ctr(message, key128, iv);
+        EXPECT_EQ(encryptedMessage.size(), message.size());
+        EXPECT_EQ(encryptedMessage.asHexString(), Encryptor::encryptAes128Ctr(message, rawKey128, iv).asHexString());
+        EXPECT_EQ(Encryptor::decryptAes128Ctr(encryptedMessage, rawKey128, iv).asHexString(), message.asHexString());
+
+        encryptedMessage = Encryptor::encryptAes256Ctr(message, rawKey256, iv);
+        EXPECT_EQ(Encryptor::decryptAes256Ctr(encryptedMessage, key256, iv).asHexString(), message.asHexString());
+        EXPECT_EQ(Encryptor::encryptAes256Ctr(message, key128, iv).size(), 0u);
+    }
+}
+
+TEST(EncryptorTests, CallerBuffers)
+{
+    const ByteBuffer message("Text to be encrypted into caller buffer");
+    const std::span<const uint8_t> plain(message.data(), message.size());
+    const ByteBuffer iv("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", true);
+    const std::span<const uint8_t> ivSpan(iv.data(), iv.size());
+    const AesKey key128(ByteBuffer("000102030405060708090a0b0c0d0e0f", true));
+    const AesKey key256(ByteBuffer("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true));
+
+    {
+        // SCOPED_TRACE("// case 1. Base64 with size queries and in-place decoding");
+
+        std::vector<uint8_t> out(Encryptor::base64EncodedSize(plain.size()));
+        EXPECT_EQ(out.size(), 52u);
+        EXPECT_EQ(Encryptor::encryptBase64(plain, out), true);
+        EXPECT_EQ(toHex(out), Encryptor::encryptBase64(message).asHexString());
+
+        const size_t sz = Encryptor::base64DecodedSize(out);
+        EXPECT_EQ(sz, plain.size());
+        EXPECT_EQ(Encryptor::decryptBase64(out, out), true);
+        EXPECT_EQ(toHex(std::span(out).first(sz)), message.asHexString());
+
+        EXPECT_EQ(Encryptor::encryptBase64(plain, std::span(out).first(51u)), false);
+
+        EXPECT_EQ(Encryptor::base64EncodedSize(0u), 0u);
+        EXPECT_EQ(Encryptor::encryptBase64(std::span<const uint8_t>(), std::span<uint8_t>()), true);
+        EXPECT_EQ(Encryptor::decryptBase64(std::span<const uint8_t>(), std::span<uint8_t>()), true);
+        EXPECT_EQ(Encryptor::decryptBase64(std::span(out).first(3u), out), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. CBC in place");
+
+        std::vector<uint8_t> data(Encryptor::aesCbcEncryptedSize(plain.size()));
+        EXPECT_EQ(data.size(), 48u);
+        std::copy(plain.begin(), plain.end(), data.begin());
+        EXPECT_EQ(Encryptor::encryptAes128Cbc(std::span(data).first(plain.size()), data, key128, ivSpan), true);
+        EXPECT_EQ(toHex(data), Encryptor::encryptAes128Cbc(message, key128, iv).asHexString());
+
+        size_t outLen = 0;
+        EXPECT_EQ(Encryptor::decryptAes128Cbc(data, data, key128, ivSpan, outLen), true);
+        EXPECT_EQ(outLen, plain.size());
+        EXPECT_EQ(toHex(std::span(data).first(outLen)), message.asHexString());
+
+        std::vector<uint8_t> out(48u);
+        EXPECT_EQ(Encryptor::encryptAes256Cbc(plain, out, key256, ivSpan), true);
+        EXPECT_EQ(toHex(out), Encryptor::encryptAes256Cbc(message, key256, iv).asHexString());
+        EXPECT_EQ(Encryptor::decryptAes128Cbc(out, out, key256, ivSpan, outLen), false);
+        EXPECT_EQ(Encryptor::encryptAes256Cbc(plain, std::span(out).first(47u), key256, ivSpan), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. CTR in place");
+
+        std::vector<uint8_t> data(plain.begin(), plain.end());
+        EXPECT_EQ(Encryptor::encryptAes256Ctr(data, data, key256, ivSpan), true);
+        EXPECT_EQ(toHex(data), Encryptor::encryptAes256Ctr(message, key256, iv).asHexString());
+        EXPECT_EQ(Encryptor::decryptAes256Ctr(data, data, key256, ivSpan), true);
+        EXPECT_EQ(toHex(data), message.asHexString());
+
+        EXPECT_EQ(Encryptor::encryptAes128Ctr(data, data, key256, ivSpan), false);
+        EXPECT_EQ(Encryptor::encryptAes128Ctr(data, data, key128, ivSpan.first(12u)), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 4. GCM in place");
+
+        const ByteBuffer gcmIv("cafebabefacedbaddecaf888", true);
+        const std::span<const uint8_t> gcmIvSpan(gcmIv.data(), gcmIv.size());
+        const ByteBuffer add("feedfacedeadbeeffeedfacedeadbeefabaddad2", true);
+        const std::span<const uint8_t> addSpan(add.data(), add.size());
+
+        ByteBuffer expectedTag(16u);
+        const auto expected = Encryptor::encryptAes128Gcm(message, key128, gcmIv, expectedTag, add);
+
+        std::vector<uint8_t> data(plain.begin(), plain.end());
+        std::array<uint8_t, 16u> tag = {};
+        EXPECT_EQ(Encryptor::encryptAes128Gcm(data, data, key128, gcmIvSpan, tag, addSpan), true);
+        EXPECT_EQ(toHex(data), expected.asHexString());
+        EXPECT_EQ(toHex(tag), expectedTag.asHexString());
+
+        auto copy = data;
+        EXPECT_EQ(Encryptor::decryptAes128Gcm(data, data, key128, gcmIvSpan, tag, addSpan), true);
+        EXPECT_EQ(toHex(data), message.asHexString());
+
+        // prefix of valid tag is rejected, mismatch wipes output
+        EXPECT_EQ(Encryptor::decryptAes128Gcm(copy, data, key128, gcmIvSpan, std::span(tag).first(4u), addSpan), false);
+        EXPECT_EQ(Encryptor::encryptAes128Gcm(data, data, key128, gcmIvSpan, std::span(tag).first(12u)), false);
+        tag[0] ^= 1u;
+        EXPECT_EQ(Encryptor::decryptAes128Gcm(copy, copy, key128, gcmIvSpan, tag, addSpan), false);
+        EXPECT_EQ(toHex(copy), std::string(copy.size() * 2u, '0'));
+        EXPECT_EQ(Encryptor::encryptAes256Gcm(data, data, key128, gcmIvSpan, tag), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 5. AES without mode in place with size queries");
+
+        std::vector<uint8_t> data(Encryptor::aesEncryptedSize(plain.size()));
+        EXPECT_EQ(data.size(), 49u);
+        std::copy(plain.begin(), plain.end(), data.begin());
+        EXPECT_EQ(Encryptor::encryptAes128(std::span(data).first(plain.size()), data, key128), true);
+        EXPECT_EQ(toHex(data), Encryptor::encryptAes128(message, key128).asHexString());
+
+        EXPECT_EQ(Encryptor::aesDecryptedSize(data), plain.size());
+        EXPECT_EQ(Encryptor::decryptAes128(data, data, key128), true);
+        EXPECT_EQ(toHex(std::span(data).first(plain.size())), message.asHexString());
+
+        std::vector<uint8_t> out(32u);
+        EXPECT_EQ(Encryptor::encryptAes256(plain.first(32u), out, key256), true);
+        EXPECT_EQ(toHex(out), Encryptor::encryptAes256(ByteBuffer(plain.data(), 32u), key256).asHexString());
+        EXPECT_EQ(Encryptor::decryptAes256(out, out, key256), true);
+        EXPECT_EQ(toHex(out), toHex(plain.first(32u)));
+
+        EXPECT_EQ(Encryptor::encryptAes256(plain, std::span(data).first(48u), key256), false);
+        EXPECT_EQ(Encryptor::decryptAes256(std::span(data).first(40u), data, key256), false);
+        EXPECT_EQ(Encryptor::aesDecryptedSize(std::span(data).first(40u)), 0u);
+        EXPECT_EQ(Encryptor::decryptAes128(out, out, key256), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 6. HMAC and HKDF");
+
+        const ByteBuffer key("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b", true);
+        const ByteBuffer salt("000102030405060708090a0b0c", true);
+        const ByteBuffer info("f0f1f2f3f4f5f6f7f8f9", true);
+        const std::span<const uint8_t> keySpan(key.data(), key.size());
+        const std::span<const uint8_t> saltSpan(salt.data(), salt.size());
+        const std::span<const uint8_t> infoSpan(info.data(), info.size());
+
+        std::array<uint8_t, 32u> mac = {};
+        EXPECT_EQ(Encryptor::hmac256(keySpan, plain, mac), true);
+        EXPECT_EQ(toHex(mac), Encryptor::hmac256(key, message).asHexString());
+        EXPECT_EQ(Encryptor::hmac256(keySpan, plain, std::span(mac).first(31u)), false);
+
+        std::array<uint8_t, 42u> okm = {};
+        EXPECT_EQ(Encryptor::hkdf256(keySpan, saltSpan, infoSpan, okm), true);
+        EXPECT_EQ(toHex(okm),
+                  "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865");
+        EXPECT_EQ(toHex(okm), Encryptor::hkdf256(key, salt, info, okm.size()).asHexString());
+
+        const auto prk = Encryptor::hmac256(salt, key);
+        const std::span<const uint8_t> prkSpan(prk.data(), prk.size());
+        EXPECT_EQ(Encryptor::hkdf256Expand(prkSpan, infoSpan, okm), true);
+        EXPECT_EQ(toHex(okm), Encryptor::hkdf256Expand(prk, info, okm.size()).asHexString());
+
+        EXPECT_EQ(Encryptor::hkdf256ExpandLabel(prkSpan, "tls13 key", infoSpan, std::span(okm).first(16u)), true);
+        EXPECT_EQ(toHex(std::span(okm).first(16u)),
+                  Encryptor::hkdf256ExpandLabel(prk, "tls13 key", info, 16u).asHexString());
+
+        std::vector<uint8_t> tooLong(255u * 32u + 1u);
+        EXPECT_EQ(Encryptor::hkdf256Expand(prkSpan, infoSpan, tooLong), false);
+    }
+}
+
+TEST(EncryptorTests, ChaCha20Poly1305)
+{
+    const ByteBuffer message("Text to be encrypted with ChaCha20-Poly1305");
+    const ByteBuffer key("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f", true);
+    const ByteBuffer iv("070000004041424344454647", true);
+    const ByteBuffer add("50515253c0c1c2c3c4c5c6c7", true);
+
+    ByteBuffer tag(16u);
+    const auto encrypted = Encryptor::encryptChaCha20Poly1305(message, key, iv, tag, add);
+    EXPECT_EQ(encrypted.size(), message.size());
+    EXPECT_EQ(Encryptor::decryptChaCha20Poly1305(encrypted, key, iv, tag, add).asString(), message.asString());
+    EXPECT_EQ(Encryptor::decryptChaCha20Poly1305(encrypted, key, iv, tag).size(), 0u);
+
+    // caller buffer API gives the same result in place
+    std::vector<uint8_t> data(message.data(), message.data() + message.size());
+    std::array<uint8_t, 16u> spanTag = {};
+    const std::span<const uint8_t> keySpan(key.data(), key.size());
+    const std::span<const uint8_t> ivSpan(iv.data(), iv.size());
+    const std::span<const uint8_t> addSpan(add.data(), add.size());
+    EXPECT_EQ(Encryptor::encryptChaCha20Poly1305(data, data, keySpan, ivSpan, spanTag, addSpan), true);
+    EXPECT_EQ(std::equal(data.begin(), data.end(), encrypted.data()), true);
+    EXPECT_EQ(std::equal(spanTag.begin(), spanTag.end(), tag.data()), true);
+    EXPECT_EQ(Encryptor::decryptChaCha20Poly1305(data, data, keySpan, ivSpan, spanTag, addSpan), true);
+    EXPECT_EQ(std::equal(data.begin(), data.end(), message.data()), true);
+
+    EXPECT_EQ(Encryptor::encryptChaCha20Poly1305(data, data, keySpan.first(16u), ivSpan, spanTag), false);
+    EXPECT_EQ(Encryptor::encryptChaCha20Poly1305(data, std::span(data).first(3u), keySpan, ivSpan, spanTag), false);
+}
+
 TEST(EncryptorTests, BigDataEncryptionDecryption_AES_256)
 {
     auto doTest = [](const std::string &hexMessage, const std::string &hexKey, const std::string &expectedHexCipher) {
@@ -293,6 +581,22 @@ TEST(EncryptorTests, DISABLED_generateSessionKey)
     }
 }
 
+TEST(EncryptorTests, generateRandom)
+{
+    const auto key1 = Encryptor::generateSessionKey();
+    const auto key2 = Encryptor::generateSessionKey();
+    EXPECT_EQ(key1.size(), 32u);
+    EXPECT_EQ(key1.asHexString() == key2.asHexString(), false);
+
+    const auto iv = Encryptor::generateIv();
+    EXPECT_EQ(iv.size(), 12u);
+    EXPECT_EQ(Encryptor::generateIv(16u).size(), 16u);
+
+    std::vector<uint8_t> data(100u);
+    EXPECT_EQ(Encryptor::generateRandom(data), true);
+    EXPECT_EQ(std::count(data.begin(), data.end(), uint8_t(0)) < 10, true);
+}
+
 TEST(EncryptorTests, Tls13Handshake)
 {
     ByteBuffer clientPrivateKey("49af42ba7f7994852d713ef2784bcbcaa7911de26adc5642cb634540e7ea5005", true);
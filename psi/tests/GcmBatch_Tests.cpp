@@ -0,0 +1,95 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+
+#include "psi/tools/GcmBatch.h"
+#include "psi/tools/GcmStream.h"
+
+#include <vector>
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(GcmBatchTests, sealOpen)
+{
+    auto doTest = [](const std::string &hexKey) {
+        const AesKey key(ByteBuffer(hexKey, true));
+
+        // sizes cover empty records, partial blocks, batch buffer overflow and record larger than batch buffer
+        const std::vector<size_t> sizes = {0u, 1u, 16u, 64u, 100u, 512u, 511u, 2000u, 17u, 300u, 0u, 256u, 1008u, 1009u};
+        const size_t count = sizes.size();
+
+        std::vector<std::vector<uint8_t>> plain(count), cipher(count), decrypted(count), ivs(count), aads(count);
+        std::vector<std::array<uint8_t, 16u>> tags(count);
+        std::vector<GcmRecord> records(count);
+        for (size_t i = 0; i < count; ++i) {
+            plain[i].resize(sizes[i]);
+            for (size_t j = 0; j < sizes[i]; ++j) {
+                plain[i][j] = uint8_t(i * 13u + j * 7u);
+            }
+            cipher[i].resize(sizes[i]);
+            decrypted[i].resize(sizes[i]);
+            ivs[i].assign(i % 3u ? 12u : 8u, uint8_t(i));
+            aads[i].assign(i % 4u, uint8_t(0xa0 + i));
+            records[i] = {ivs[i], aads[i], plain[i], cipher[i], tags[i]};
+        }
+
+        EXPECT_EQ(GcmBatch::seal(key, records), count);
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_TRUE(records[i].ok);
+
+            GcmEncryptor encryptor(key, ivs[i]);
+            encryptor.updateAad(aads[i]);
+            std::vector<uint8_t> expected(sizes[i]);
+            encryptor.update(plain[i], expected);
+            GcmStream::Tag expectedTag = {};
+            encryptor.final(expectedTag);
+            EXPECT_TRUE(cipher[i] == expected);
+            EXPECT_TRUE(tags[i] == expectedTag);
+
+            records[i] = {ivs[i], aads[i], cipher[i], decrypted[i], tags[i]};
+        }
+
+        tags[5][3] ^= 0x01;
+        EXPECT_EQ(GcmBatch::open(key, records), count - 1u);
+        for (size_t i = 0; i < count; ++i) {
+            if (i == 5u) {
+                EXPECT_FALSE(records[i].ok);
+                EXPECT_TRUE(decrypted[i] == std::vector<uint8_t>(sizes[i]));
+            } else {
+                EXPECT_TRUE(records[i].ok);
+                EXPECT_TRUE(decrypted[i] == plain[i]);
+            }
+        }
+    };
+
+    doTest("000102030405060708090a0b0c0d0e0f");
+    doTest("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+}
+
+TEST(GcmBatchTests, invalidRecords)
+{
+    const AesKey key(ByteBuffer("000102030405060708090a0b0c0d0e0f", true));
+    const std::array<uint8_t, 12u> iv = {};
+    std::array<uint8_t, 32u> data = {};
+    std::array<uint8_t, 16u> out = {};
+    std::array<uint8_t, 16u> tag = {};
+
+    std::vector<GcmRecord> records = {
+        {iv, {}, data, out, tag},                           // output too small
+        {iv, {}, out, out, std::span(tag).subspan(0, 8u)}, // tag too small
+        {iv, {}, out, out, tag},
+    };
+    EXPECT_EQ(GcmBatch::seal(key, records), 1u);
+    EXPECT_FALSE(records[0].ok);
+    EXPECT_FALSE(records[1].ok);
+    EXPECT_TRUE(records[2].ok);
+
+    std::vector<GcmRecord> opened = {
+        {iv, {}, out, out, std::span(tag).first(4u)}, // prefix of valid tag
+    };
+    EXPECT_EQ(GcmBatch::open(key, opened), 0u);
+    EXPECT_FALSE(opened[0].ok);
+
+    EXPECT_EQ(GcmBatch::seal(AesKey(), records), 0u);
+    EXPECT_FALSE(records[2].ok);
+}
@@ -0,0 +1,247 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include "psi/tools/GcmContainer.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace psi::tools;
+using namespace psi::test;
+
+namespace {
+
+AesKey makeKey(uint8_t first)
+{
+    ByteBuffer key(16u);
+    for (uint8_t i = 0; i < 16u; ++i) {
+        key.write(uint8_t(first + i));
+    }
+    return AesKey(key);
+}
+
+const GcmContainerFormat::Nonce NONCE = {0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7};
+
+std::string tempPath(const std::string &name)
+{
+    return (std::filesystem::temp_directory_path() / ("psi_" + name + ".gcmc")).string();
+}
+
+std::vector<uint8_t> readFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+}
+
+void writeFile(const std::string &path, const std::vector<uint8_t> &data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), std::streamsize(data.size()));
+}
+
+} // namespace
+
+TEST(GcmContainerTests, format)
+{
+    const auto path = tempPath("format");
+    const auto key = makeKey(0u);
+    const auto plain = makeData(20u);
+
+    {
+        GcmContainerWriter writer(path, key, NONCE, 16u);
+        ASSERT_EQ(writer.isValid(), true);
+        EXPECT_EQ(writer.write(std::span(plain.data(), 7u)), true);
+        EXPECT_EQ(writer.write(std::span(plain).subspan(7u)), true);
+        EXPECT_EQ(writer.finish(), true);
+        EXPECT_EQ(writer.isValid(), false);
+    }
+
+    const auto file = readFile(path);
+    ASSERT_EQ(file.size(), 116u);
+    EXPECT_EQ(toHex(file.data(), 48u),
+              "50534947434d43311000000000000000a0a1a2a3a4a5a6a7"
+              "140000000000000002000000000000006400000000000000");
+    // chunk 0 is sealed as not last, chunk 1 as last
+    EXPECT_EQ(toHex(shift_ptr(file.data(), 48u), 52u),
+              "bb253c65900b2bfa28b51d8e18211ef9c7d8b6d5c5cdfc038a5038f62b654e6f"
+              "3678f1af1fcf05162086080f42aed4c545b542e5");
+    EXPECT_EQ(toHex(shift_ptr(file.data(), 100u), 16u), "30000000000000005000000000000000");
+
+    GcmContainerReader reader(path, key);
+    ASSERT_EQ(reader.isValid(), true);
+    EXPECT_EQ(reader.size(), 20u);
+    EXPECT_EQ(reader.chunkSize(), 16u);
+    EXPECT_EQ(reader.chunkCount(), 2u);
+    EXPECT_EQ(reader.read(0u, 20u).asHexString(), toHex(plain.data(), 20u));
+
+    std::filesystem::remove(path);
+}
+
+TEST(GcmContainerTests, randomAccess)
+{
+    const auto path = tempPath("randomAccess");
+    const auto key = makeKey(1u);
+    const size_t len = 5u * 1024u * 1024u + 123u;
+    const auto plain = makeData(len);
+
+    {
+        GcmContainerWriter writer(path, key, NONCE, 4096u);
+        ASSERT_EQ(writer.isValid(), true);
+        for (size_t offset = 0; offset < len; offset += 10000u) {
+            EXPECT_EQ(writer.write(std::span(plain).subspan(offset, std::min<size_t>(10000u, len - offset))), true);
+        }
+    }
+
+    GcmContainerReader reader(path, key);
+    ASSERT_EQ(reader.isValid(), true);
+    EXPECT_EQ(reader.size(), len);
+    EXPECT_EQ(reader.chunkCount(), len / 4096u + 1u);
+
+    {
+        // SCOPED_TRACE("// case 1. ranges inside, across and on chunk bounds");
+
+        const std::vector<std::pair<uint64_t, size_t>> ranges = {
+            {0u, 1u}, {1u, 4095u}, {4095u, 2u}, {4096u, 4096u}, {100000u, 50000u}, {len - 5u, 5u}, {len, 0u}};
+        for (const auto &[offset, sz] : ranges) {
+            std::vector<uint8_t> out(sz);
+            EXPECT_EQ(reader.read(offset, out), true);
+            EXPECT_EQ(toHex(out.data(), sz), toHex(shift_ptr(plain.data(), size_t(offset)), sz));
+        }
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. whole payload, decrypted by several threads");
+
+        std::vector<uint8_t> out(len - 3u);
+        EXPECT_EQ(reader.read(3u, out), true);
+        EXPECT_EQ(std::equal(out.begin(), out.end(), plain.begin() + 3), true);
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. out of range");
+
+        std::vector<uint8_t> out(2u);
+        EXPECT_EQ(reader.read(len - 1u, out), false);
+        EXPECT_EQ(reader.read(len + 1u, 0u).size(), 0u);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(GcmContainerTests, emptyContainer)
+{
+    const auto path = tempPath("empty");
+    const auto key = makeKey(2u);
+
+    {
+        GcmContainerWriter writer(path, key, NONCE);
+        EXPECT_EQ(writer.finish(), true);
+        EXPECT_EQ(writer.write(ByteBuffer("abc")), false);
+    }
+
+    GcmContainerReader reader(path, key);
+    ASSERT_EQ(reader.isValid(), true);
+    EXPECT_EQ(reader.size(), 0u);
+    EXPECT_EQ(reader.chunkCount(), 1u);
+    std::vector<uint8_t> out;
+    EXPECT_EQ(reader.read(0u, out), true);
+
+    std::filesystem::remove(path);
+}
+
+TEST(GcmContainerTests, corruptedContainer)
+{
+    const auto path = tempPath("corrupted");
+    const auto key = makeKey(3u);
+    const auto plain = makeData(100u);
+
+    {
+        GcmContainerWriter writer(path, key, NONCE, 32u);
+        EXPECT_EQ(writer.write(plain), true);
+    }
+    const auto file = readFile(path);
+
+    {
+        // SCOPED_TRACE("// case 1. wrong key");
+
+        GcmContainerReader reader(path, makeKey(4u));
+        ASSERT_EQ(reader.isValid(), true);
+        std::vector<uint8_t> out(10u, 0xff);
+        EXPECT_EQ(reader.read(0u, out), false);
+        EXPECT_EQ(toHex(out.data(), out.size()), std::string(20u, '0'));
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. modified ciphertext fails only its chunk");
+
+        auto modified = file;
+        modified[48u + 48u + 5u] ^= 1u;
+        writeFile(path, modified);
+
+        GcmContainerReader reader(path, key);
+        ASSERT_EQ(reader.isValid(), true);
+        EXPECT_EQ(reader.read(0u, 32u).asHexString(), toHex(plain.data(), 32u));
+        EXPECT_EQ(reader.read(32u, 32u).size(), 0u);
+        EXPECT_EQ(reader.read(64u, 36u).asHexString(), toHex(shift_ptr(plain.data(), 64u), 36u));
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. truncated file");
+
+        auto truncated = file;
+        truncated.resize(file.size() - 8u);
+        writeFile(path, truncated);
+        EXPECT_EQ(GcmContainerReader(path, key).isValid(), false);
+
+        truncated.resize(20u);
+        writeFile(path, truncated);
+        EXPECT_EQ(GcmContainerReader(path, key).isValid(), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 4. dropped last chunk is detected by last chunk flag");
+
+        // header claims 96 bytes in 3 chunks, index points to first three chunks of original file
+        auto dropped = file;
+        dropped[24u] = 96u;
+        dropped[32u] = 3u;
+        const size_t indexOffset = 48u + 3u * 48u;
+        dropped.erase(dropped.begin() + ptrdiff_t(indexOffset), dropped.end() - 32);
+        dropped.resize(dropped.size() - 8u);
+        dropped[40u] = uint8_t(indexOffset);
+        writeFile(path, dropped);
+
+        GcmContainerReader reader(path, key);
+        ASSERT_EQ(reader.isValid(), true);
+        EXPECT_EQ(reader.read(0u, 64u).asHexString(), toHex(plain.data(), 64u));
+        EXPECT_EQ(reader.read(64u, 32u).size(), 0u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 5. corrupted header");
+
+        // plain size close to 2^64 must not wrap chunk count to 1, index is resized to one entry
+        auto header = file;
+        std::fill(header.begin() + 24, header.begin() + 32, uint8_t(0xff));
+        header[32u] = 1u;
+        header.resize(header.size() - 3u * 8u);
+        header[40u] = uint8_t(header.size() - 8u);
+        writeFile(path, header);
+        EXPECT_EQ(GcmContainerReader(path, key).isValid(), false);
+
+        // plain size larger than chunk count allows
+        header = file;
+        header[24u] = 129u;
+        writeFile(path, header);
+        EXPECT_EQ(GcmContainerReader(path, key).isValid(), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 6. missing file");
+
+        std::filesystem::remove(path);
+        EXPECT_EQ(GcmContainerReader(path, key).isValid(), false);
+    }
+}
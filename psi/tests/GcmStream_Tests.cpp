@@ -0,0 +1,150 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include "psi/tools/GcmStream.h"
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(GcmStreamTests, encryptChunked)
+{
+    const AesKey key(ByteBuffer("feffe9928665731c6d6a8f9467308308", true));
+    const ByteBuffer data("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e24"
+                          "49a6b525b16aedf5aa0de657ba637b39",
+                          true);
+    const ByteBuffer acc("feedfacedeadbeeffeedfacedeadbeefabaddad2", true);
+    const ByteBuffer iv("cafebabefacedbaddecaf888", true);
+
+    auto doTest = [&](const auto &testCase, size_t aadChunk, size_t dataChunk) {
+        // SCOPED_TRACE(testCase);
+
+        GcmEncryptor encryptor(key, std::span(iv.data(), iv.size()));
+        for (size_t i = 0; i < acc.size(); i += aadChunk) {
+            EXPECT_TRUE(encryptor.updateAad(std::span(acc.data(), acc.size()).subspan(i, std::min(aadChunk, acc.size() - i))));
+        }
+
+        std::vector<uint8_t> out(data.size());
+        for (size_t i = 0; i < data.size(); i += dataChunk) {
+            const size_t sz = std::min(dataChunk, data.size() - i);
+            EXPECT_TRUE(encryptor.update(std::span(data.data(), data.size()).subspan(i, sz), std::span(out).subspan(i, sz)));
+        }
+
+        GcmStream::Tag tag = {};
+        EXPECT_TRUE(encryptor.final(tag));
+        EXPECT_EQ(encryptor.isValid(), false);
+        EXPECT_EQ(encryptor.aadLength(), acc.size());
+        EXPECT_EQ(encryptor.dataLength(), data.size());
+        EXPECT_EQ(toHex(out),
+                  "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b"
+                  "396a0aac973d58e091");
+        EXPECT_EQ(toHex(tag), "5bc94fbc3221a5db94fae95ae7121a47");
+    };
+
+    doTest("// case 1. one chunk", 20u, 60u);
+    doTest("// case 2. byte by byte", 1u, 1u);
+    doTest("// case 3. unaligned chunks", 7u, 17u);
+    doTest("// case 4. block chunks", 16u, 16u);
+    doTest("// case 5. mixed chunks", 3u, 33u);
+}
+
+TEST(GcmStreamTests, decryptChunked)
+{
+    const AesKey key(ByteBuffer("feffe9928665731c6d6a8f9467308308", true));
+    const ByteBuffer encrypted("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f"
+                               "6a5aac84aa051ba30b396a0aac973d58e091",
+                               true);
+    const ByteBuffer acc("feedfacedeadbeeffeedfacedeadbeefabaddad2", true);
+    const ByteBuffer iv("cafebabefacedbaddecaf888", true);
+    const ByteBuffer tag("5bc94fbc3221a5db94fae95ae7121a47", true);
+    const ByteBuffer badTag("5bc94fbc3221a5db94fae95ae7121a48", true);
+
+    auto doTest = [&](const auto &testCase, size_t dataChunk, const ByteBuffer &expectedTag, bool expectedResult) {
+        // SCOPED_TRACE(testCase);
+
+        GcmDecryptor decryptor(key, std::span(iv.data(), iv.size()));
+        EXPECT_TRUE(decryptor.updateAad(std::span(acc.data(), acc.size())));
+
+        // in-place decryption
+        std::vector<uint8_t> data(encrypted.data(), encrypted.data() + encrypted.size());
+        for (size_t i = 0; i < data.size(); i += dataChunk) {
+            const size_t sz = std::min(dataChunk, data.size() - i);
+            EXPECT_TRUE(decryptor.update(std::span(data).subspan(i, sz), std::span(data).subspan(i, sz)));
+        }
+
+        EXPECT_EQ(decryptor.final(std::span(expectedTag.data(), expectedTag.size())), expectedResult);
+        EXPECT_EQ(toHex(data),
+                  "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aed"
+                  "f5aa0de657ba637b39");
+    };
+
+    doTest("// case 1. one chunk", 60u, tag, true);
+    doTest("// case 2. unaligned chunks", 13u, tag, true);
+    doTest("// case 3. wrong tag", 16u, badTag, false);
+}
+
+TEST(GcmStreamTests, byteBufferChunks)
+{
+    const AesKey key(ByteBuffer("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true));
+    const ByteBuffer iv("cafebabefacedbad", true);
+
+    ByteBuffer data(1000u);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data.write(uint8_t(i * 7u + 5u));
+    }
+
+    GcmEncryptor whole(key, std::span(iv.data(), iv.size()));
+    const ByteBuffer expected = whole.update(data);
+    GcmStream::Tag expectedTag = {};
+    EXPECT_TRUE(whole.final(expectedTag));
+
+    GcmEncryptor encryptor(key, std::span(iv.data(), iv.size()));
+    GcmDecryptor decryptor(key, std::span(iv.data(), iv.size()));
+    ByteBuffer encrypted(data.size());
+    ByteBuffer decrypted(data.size());
+    for (size_t i = 0, chunk = 1; i < data.size(); i += chunk, chunk = chunk * 2u + 1u) {
+        const ByteBuffer part = data.readToByteBuffer(std::min(chunk, data.size() - i));
+        const ByteBuffer encryptedPart = encryptor.update(part);
+        encrypted.writeArray(encryptedPart.data(), encryptedPart.length());
+        const ByteBuffer decryptedPart = decryptor.update(encryptedPart);
+        decrypted.writeArray(decryptedPart.data(), decryptedPart.length());
+    }
+
+    GcmStream::Tag tag = {};
+    EXPECT_TRUE(encryptor.final(tag));
+    EXPECT_EQ(encrypted.asHexString(), expected.asHexString());
+    EXPECT_EQ(toHex(tag), toHex(expectedTag));
+    EXPECT_TRUE(decryptor.final(tag));
+    EXPECT_EQ(decrypted.asHexString(), data.asHexString());
+}
+
+TEST(GcmStreamTests, invalidUsage)
+{
+    const AesKey key(ByteBuffer("feffe9928665731c6d6a8f9467308308", true));
+    const std::array<uint8_t, 12u> iv = {};
+    std::array<uint8_t, 32u> data = {};
+    std::array<uint8_t, 16u> out = {};
+    GcmStream::Tag tag = {};
+
+    GcmEncryptor invalid(AesKey(), iv);
+    EXPECT_EQ(invalid.isValid(), false);
+    EXPECT_FALSE(invalid.updateAad(data));
+    EXPECT_FALSE(invalid.update(data, data));
+    EXPECT_FALSE(invalid.final(tag));
+
+    GcmEncryptor encryptor(key, iv);
+    EXPECT_FALSE(encryptor.update(data, out));
+    EXPECT_TRUE(encryptor.update(out, out));
+    EXPECT_FALSE(encryptor.updateAad(data));
+    EXPECT_TRUE(encryptor.final(tag));
+    EXPECT_FALSE(encryptor.final(tag));
+    EXPECT_FALSE(encryptor.update(out, out));
+
+    GcmDecryptor decryptor(key, iv);
+    EXPECT_FALSE(decryptor.final(std::span(tag).subspan(0, 0)));
+
+    GcmEncryptor empty(key, iv);
+    EXPECT_TRUE(empty.final(tag));
+    GcmDecryptor prefix(key, iv);
+    EXPECT_FALSE(prefix.final(std::span(tag).first(4u)));
+}
@@ -0,0 +1,150 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include <vector>
+
+#include "psi/tools/Encryptor.h"
+#include "psi/tools/Hkdf.h"
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(HkdfTests, extractExpand)
+{
+    auto doTest = [](const auto &testCase,
+                     const auto &ikm,
+                     const auto &salt,
+                     const auto &info,
+                     size_t len,
+                     const auto &expectedPrk,
+                     const auto &expectedOkm) {
+        // SCOPED_TRACE(testCase);
+
+        const ByteBuffer ikmBuffer(ikm, true);
+        const ByteBuffer saltBuffer(salt, true);
+        const ByteBuffer infoBuffer(info, true);
+
+        std::array<uint8_t, HkdfSha256::HASH_SIZE> prk = {};
+        EXPECT_EQ(HkdfSha256::extract(asSpan(saltBuffer), asSpan(ikmBuffer), prk), true);
+        EXPECT_EQ(toHex(prk), expectedPrk);
+
+        std::vector<uint8_t> okm(len);
+        EXPECT_EQ(HkdfSha256(prk).expand(asSpan(infoBuffer), okm), true);
+        EXPECT_EQ(toHex(okm), expectedOkm);
+    };
+
+    // RFC 5869
+    doTest("// case 1",
+           "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+           "000102030405060708090a0b0c",
+           "f0f1f2f3f4f5f6f7f8f9",
+           42,
+           "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5",
+           "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865");
+    doTest("// case 2",
+           "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f30313233343"
+           "5363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f",
+           "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f90919293949"
+           "5969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+           "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e"
+           "5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+           82,
+           "06a6b88c5853361a06104c9ceb35b45cef760014904671014a193f40c15fc244",
+           "b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c59045a99cac7827271cb41c65e590e09da3275600c2"
+           "f09b8367793a9aca3db71cc30c58179ec3e87c14c01d5c1f3434f1d87");
+    doTest("// case 3",
+           "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+           "",
+           "",
+           42,
+           "19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04",
+           "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8");
+}
+
+TEST(HkdfTests, expandLabel)
+{
+    const ByteBuffer prk("a11af9f05531f856ad47116b45a950328204b4f44bfb6b3a4b4f1f3fcb631643", true);
+    const ByteBuffer hash("9608102a0f1ccc6db6250b7b7e417b1a000eaada3daae4777a7686c9ff83df13", true);
+    const HkdfSha256 hkdf(asSpan(prk));
+
+    {
+        // SCOPED_TRACE("// case 1. same result as Encryptor");
+
+        std::array<uint8_t, 16u> key = {};
+        EXPECT_EQ(hkdf.expandLabel("tls13 key", {}, key), true);
+        EXPECT_EQ(toHex(key), "9f02283b6c9c07efc26bb9f2ac92e356");
+
+        std::array<uint8_t, 40u> secret = {};
+        EXPECT_EQ(hkdf.expandLabel("tls13 label", asSpan(hash), secret), true);
+        EXPECT_EQ(toHex(secret), Encryptor::hkdf256ExpandLabel(prk, "tls13 label", hash, 40u).asHexString());
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. invalid lengths");
+
+        std::vector<uint8_t> out(HkdfSha256::MAX_OUTPUT_SIZE + 1u);
+        EXPECT_EQ(hkdf.expand({}, out), false);
+        EXPECT_EQ(hkdf.expand({}, std::span(out).first(HkdfSha256::MAX_OUTPUT_SIZE)), true);
+        EXPECT_EQ(hkdf.expandLabel(std::string(256u, 'a'), {}, std::span(out).first(32u)), false);
+        EXPECT_EQ(hkdf.expandLabel("tls13 key", std::span(out).first(256u), std::span(out).first(32u)), false);
+        EXPECT_EQ(Encryptor::hkdf256Expand(prk, hash, HkdfSha256::MAX_OUTPUT_SIZE + 1u).size(), 0u);
+    }
+}
+
+TEST(HkdfTests, sha512)
+{
+    const ByteBuffer ikm("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b", true);
+    const ByteBuffer salt("000102030405060708090a0b0c", true);
+    const ByteBuffer info("f0f1f2f3f4f5f6f7f8f9", true);
+
+    {
+        // SCOPED_TRACE("// case 1. HKDF-SHA512");
+
+        std::array<uint8_t, HkdfSha512::HASH_SIZE> prk = {};
+        EXPECT_EQ(HkdfSha512::extract(asSpan(salt), asSpan(ikm), prk), true);
+        std::array<uint8_t, 42u> okm = {};
+        EXPECT_EQ(HkdfSha512(prk).expand(asSpan(info), okm), true);
+        EXPECT_EQ(toHex(okm),
+                  "832390086cda71fb47625bb5ceb168e4c8e26a1a16ed34d9fc7fe92c1481579338da362cb8d9f925d7cb");
+        EXPECT_EQ(toHex(okm), Encryptor::hkdf512(ikm, salt, info, okm.size()).asHexString());
+
+        std::vector<uint8_t> out(HkdfSha512::MAX_OUTPUT_SIZE + 1u);
+        EXPECT_EQ(HkdfSha512(prk).expand(asSpan(info), out), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. HKDF-SHA384");
+
+        std::array<uint8_t, HkdfSha384::HASH_SIZE> prk = {};
+        EXPECT_EQ(HkdfSha384::extract(asSpan(salt), asSpan(ikm), prk), true);
+        std::array<uint8_t, 42u> okm = {};
+        EXPECT_EQ(HkdfSha384(prk).expand(asSpan(info), okm), true);
+        EXPECT_EQ(toHex(okm),
+                  "9b5097a86038b805309076a44b3a9f38063e25b516dcbf369f394cfab43685f748b6457763e4f0204fc5");
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. HKDF-Expand-Label with SHA-384");
+
+        const ByteBuffer prk(
+            "18954cf5bfeaeed4812f64302b9efb3c3251ee3fd5a73066495601873bfeaf64044bdc1b66ac3415135d18b3c4ff30d4", true);
+        const ByteBuffer hash(
+            "59e1748777448c69de6b800d7a33bbfb9ff1b463e44354c3553bcdb9c666fa90125a3c79f90397bdf5f6a13de828684f", true);
+        const HkdfSha384 hkdf(asSpan(prk));
+
+        std::array<uint8_t, 32u> key = {};
+        EXPECT_EQ(hkdf.expandLabel("tls13 key", {}, key), true);
+        EXPECT_EQ(toHex(key), "4140dfbf71e500ae8105adae978eb7438faa653699141e2ea8b7778d4d8f6997");
+        std::array<uint8_t, 12u> iv = {};
+        EXPECT_EQ(hkdf.expandLabel("tls13 iv", {}, iv), true);
+        EXPECT_EQ(toHex(iv), "d60d7989af6b3b883eea2169");
+        std::array<uint8_t, 48u> secret = {};
+        EXPECT_EQ(hkdf.expandLabel("tls13 c hs traffic", asSpan(hash), secret), true);
+        EXPECT_EQ(toHex(secret),
+                  "24c135816d8ea5f6b8b1a7c9f44257965d71f79facf48e6165125da4938753f87ba89314f601b729d1383e6557ac908e");
+        EXPECT_EQ(toHex(secret),
+                  Encryptor::hkdf384ExpandLabel(prk, "tls13 c hs traffic", hash, secret.size()).asHexString());
+        EXPECT_EQ(hkdf.expandLabel(std::string(256u, 'a'), asSpan(hash), secret), false);
+    }
+}
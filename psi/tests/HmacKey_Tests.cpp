@@ -0,0 +1,179 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include <vector>
+
+#include "psi/tools/Encryptor.h"
+#include "psi/tools/HmacKey.h"
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(HmacKeyTests, mac)
+{
+    auto doTest = [](const auto &testCase, const auto &key, const auto &msg, const auto &expected) {
+        // SCOPED_TRACE(testCase);
+
+        const HmacSha256Key hmacKey(ByteBuffer(key, true));
+        EXPECT_EQ(hmacKey.mac(ByteBuffer(msg, true)).asHexString(), expected);
+    };
+
+    // RFC 4231
+    doTest("// case 1",
+           "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+           "4869205468657265",
+           "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+    doTest("// case 2",
+           "4a656665",
+           "7768617420646f2079612077616e7420666f72206e6f7468696e673f",
+           "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    doTest(
+        "// case 3",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "54657374205573696e67204c6172676572205468616e20426c6f636b2d53697a65204b6579202d2048617368204b6579204669727374",
+        "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+
+    // empty key
+    EXPECT_EQ(HmacSha256Key().mac(ByteBuffer(0u)).asHexString(),
+              "b613679a0814d9ec772f95d778c35fc5ff1697c493715653c6c712144292c5ad");
+}
+
+TEST(HmacKeyTests, chunks)
+{
+    // key longer than block is hashed first
+    std::string keyString;
+    for (size_t i = 0; i < 30u; ++i) {
+        keyString += "key";
+    }
+    const HmacSha256Key key {ByteBuffer(keyString)};
+
+    const std::vector<uint8_t> msg = makeData(1000u);
+    const std::string expected = "ec8d44e321f3d99a377d2a830e1c44dcdc25f872a6501ae4a43866e776777a28";
+
+    {
+        // SCOPED_TRACE("// case 1. whole message");
+
+        EXPECT_EQ(toHex(key.mac(msg)), expected);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. chunks of growing length");
+
+        auto inner = key.begin();
+        size_t offset = 0;
+        for (size_t sz = 0; offset < msg.size(); ++sz) {
+            const size_t len = std::min(sz, msg.size() - offset);
+            inner.update(std::span(msg).subspan(offset, len));
+            offset += len;
+        }
+        HmacSha256Key::Digest result = {};
+        EXPECT_EQ(key.finish(inner, std::span(result).first(31u)), false);
+        EXPECT_EQ(key.finish(inner, result), true);
+        EXPECT_EQ(toHex(result), expected);
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. copy of key");
+
+        const HmacSha256Key copy = key;
+        EXPECT_EQ(toHex(copy.mac(msg)), expected);
+        EXPECT_EQ(Encryptor::hmac256(ByteBuffer(keyString), ByteBuffer(static_cast<const uint8_t *>(msg.data()), msg.size())).asHexString(),
+                  expected);
+    }
+}
+
+TEST(HmacKeyTests, verify)
+{
+    const HmacSha256Key key(ByteBuffer("secret"));
+    const ByteBuffer msg("message to be signed");
+    const std::span<const uint8_t> data(msg.data(), msg.size());
+    auto tag = key.mac(data);
+
+    EXPECT_EQ(key.verify(data, tag), true);
+    EXPECT_EQ(key.verify(data, std::span(tag).first(16u)), false);
+    EXPECT_EQ(key.verify(data, std::span(tag).first(4u)), false);
+    EXPECT_EQ(key.verify(data, {}), false);
+    EXPECT_EQ(key.verify(data.first(5u), tag), false);
+
+    const std::vector<uint8_t> longTag(33u);
+    EXPECT_EQ(key.verify(data, longTag), false);
+
+    tag[31] ^= 1u;
+    EXPECT_EQ(key.verify(data, tag), false);
+    EXPECT_EQ(key.verify(data, std::span(tag).first(31u)), false);
+}
+
+TEST(HmacKeyTests, sha512)
+{
+    const ByteBuffer secret("4a656665", true);
+    const ByteBuffer msg("7768617420646f2079612077616e7420666f72206e6f7468696e673f", true);
+    const std::span<const uint8_t> data(msg.data(), msg.size());
+
+    // RFC 4231
+    const std::string expected512 =
+        "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6"
+        "b4b636e070a38bce737";
+    const std::string expected384 =
+        "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649";
+
+    {
+        // SCOPED_TRACE("// case 1. HMAC-SHA512 in one call and by chunks");
+
+        const HmacSha512Key key(secret);
+        EXPECT_EQ(key.mac(msg).asHexString(), expected512);
+
+        auto inner = key.begin();
+        inner.update(data.first(10u));
+        inner.update(data.subspan(10u));
+        HmacSha512Key::Digest result = {};
+        EXPECT_EQ(key.finish(inner, result), true);
+        EXPECT_EQ(toHex(result), expected512);
+
+        EXPECT_EQ(key.verify(data, result), true);
+        EXPECT_EQ(key.verify(data, std::span(result).first(32u)), false);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. HMAC-SHA384");
+
+        const HmacSha384Key key(secret.data(), secret.size());
+        EXPECT_EQ(toHex(key.mac(data)), expected384);
+        EXPECT_EQ(Encryptor::hmac384(secret, msg).asHexString(), expected384);
+
+        std::array<uint8_t, HmacSha384Key::DIGEST_SIZE> result = {};
+        EXPECT_EQ(key.mac(data, std::span(result).first(47u)), false);
+        EXPECT_EQ(key.mac(data, result), true);
+        EXPECT_EQ(key.verify(data, result), true);
+        result[0] ^= 1u;
+        EXPECT_EQ(key.verify(data, result), false);
+    }
+}
+
+TEST(HmacKeyTests, performance)
+{
+    const ByteBuffer secret(32u);
+    const ByteBuffer data(64u);
+    const HmacSha256Key key(secret);
+
+    TestHelper::timeFn("Encryptor::hmac256 64 bytes", [&]() { Encryptor::hmac256(secret, data); }, 100000);
+
+    TestHelper::timeFn(
+        "HmacSha256Key::mac 64 bytes",
+        [&]() {
+            HmacSha256Key::Digest tag = {};
+            key.mac(std::span<const uint8_t>(data.data(), data.size()), tag);
+        },
+        100000);
+
+    const HmacSha512Key key512(secret);
+    TestHelper::timeFn(
+        "HmacSha512Key::mac 64 bytes",
+        [&]() {
+            HmacSha512Key::Digest tag = {};
+            key512.mac(std::span<const uint8_t>(data.data(), data.size()), tag);
+        },
+        100000);
+}
@@ -0,0 +1,121 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include <vector>
+
+#include "psi/tools/Encryptor.h"
+#include "psi/tools/Sha256.h"
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(Sha256Tests, hash)
+{
+    auto doTest = [](const auto &testCase, size_t len, const auto &expected) {
+        // SCOPED_TRACE(testCase);
+
+        std::vector<uint8_t> msg(len);
+        for (size_t i = 0; i < len; ++i) {
+            msg[i] = uint8_t(i);
+        }
+        EXPECT_EQ(toHex(Sha256::hash(msg)), expected);
+        EXPECT_EQ(Encryptor::sha256(ByteBuffer(static_cast<const uint8_t *>(msg.data()), len)).asHexString(), expected);
+    };
+
+    // padding fits into the last block or requires one more block
+    doTest("// case 1", 0u, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    doTest("// case 2", 55u, "463eb28e72f82e0a96c0a4cc53690c571281131f672aa229e0d45ae59b598b59");
+    doTest("// case 3", 56u, "da2ae4d6b36748f2a318f23e7ab1dfdf45acdc9d049bd80e59de82a60895f562");
+    doTest("// case 4", 63u, "29af2686fd53374a36b0846694cc342177e428d1647515f078784d69cdb9e488");
+    doTest("// case 5", 64u, "fdeab9acf3710362bd2658cdc9a29e8f9c757fcf9811603a8c447cd1d9151108");
+    doTest("// case 6", 119u, "da18797ed7c3a777f0847f429724a2d8cd5138e6ed2895c3fa1a6d39d18f7ec6");
+    doTest("// case 7", 120u, "f52b23db1fbb6ded89ef42a23ce0c8922c45f25c50b568a93bf1c075420bbb7c");
+}
+
+TEST(Sha256Tests, update)
+{
+    const auto msg = makeData(100000u);
+    const std::string expected = "d96bab6a55ee326ba206dd4a85a6e95e14360d7fabbf448f03e689c24382b7d0";
+
+    {
+        // SCOPED_TRACE("// case 1. chunks of growing length");
+
+        Sha256 sha;
+        size_t offset = 0;
+        for (size_t sz = 0; offset < msg.size(); ++sz) {
+            const size_t len = std::min(sz, msg.size() - offset);
+            sha.update(std::span(msg).subspan(offset, len));
+            offset += len;
+        }
+        EXPECT_EQ(sha.length(), uint64_t(msg.size()));
+        EXPECT_EQ(toHex(sha.final()), expected);
+        EXPECT_EQ(sha.length(), uint64_t(0));
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. object is reusable after final");
+
+        Sha256 sha;
+        sha.update(ByteBuffer("abc"));
+        EXPECT_EQ(toHex(sha.final()), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+        sha.update(ByteBuffer("garbage"));
+        sha.reset();
+        sha.update(std::span(msg).first(50000u));
+        sha.update(std::span(msg).subspan(50000u));
+
+        std::array<uint8_t, 32u> out = {};
+        EXPECT_EQ(sha.final(std::span(out).first(31u)), false);
+        EXPECT_EQ(sha.final(out), true);
+        EXPECT_EQ(toHex(out), expected);
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. million of 'a'");
+
+        const std::vector<uint8_t> chunk(1000u, uint8_t('a'));
+        Sha256 sha;
+        for (size_t i = 0; i < 1000u; ++i) {
+            sha.update(chunk);
+        }
+        EXPECT_EQ(toHex(sha.final()), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    }
+
+    {
+        // SCOPED_TRACE("// case 4. caller buffer API of Encryptor");
+
+        std::array<uint8_t, 32u> out = {};
+        EXPECT_EQ(Encryptor::sha256(msg, out), true);
+        EXPECT_EQ(toHex(out), expected);
+        EXPECT_EQ(Encryptor::sha256(msg, std::span(out).first(16u)), false);
+    }
+}
+
+TEST(Sha256Tests, hashBatch)
+{
+    const ByteBuffer abc("abc");
+    const auto msg = makeData(100000u);
+    const std::vector<std::span<const uint8_t>> messages = {std::span(abc.data(), abc.size()), msg, {}};
+
+    std::vector<Sha256::Digest> digests(messages.size());
+    EXPECT_EQ(Sha256::hashBatch(messages, digests), true);
+    EXPECT_EQ(toHex(digests[0]), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(toHex(digests[1]), "d96bab6a55ee326ba206dd4a85a6e95e14360d7fabbf448f03e689c24382b7d0");
+    EXPECT_EQ(toHex(digests[2]), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    EXPECT_EQ(Sha256::hashBatch(messages, std::span(digests).first(2u)), false);
+}
+
+TEST(Sha256Tests, performance)
+{
+    const auto msg = makeData(1024u * 1024u);
+
+    TestHelper::timeFn(
+        "Sha256 update 1 MB",
+        [&msg]() {
+            Sha256 sha;
+            sha.update(msg);
+            sha.final();
+        },
+        100);
+}
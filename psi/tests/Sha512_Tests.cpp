@@ -0,0 +1,171 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include <vector>
+
+#include "psi/tools/Encryptor.h"
+#include "psi/tools/Sha512.h"
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(Sha512Tests, hash)
+{
+    auto doTest = [](const auto &testCase, size_t len, const auto &expected512, const auto &expected384) {
+        // SCOPED_TRACE(testCase);
+
+        std::vector<uint8_t> msg(len);
+        for (size_t i = 0; i < len; ++i) {
+            msg[i] = uint8_t(i);
+        }
+        const ByteBuffer buffer(static_cast<const uint8_t *>(msg.data()), len);
+        EXPECT_EQ(toHex(Sha512::hash(msg)), expected512);
+        EXPECT_EQ(Encryptor::sha512(buffer).asHexString(), expected512);
+        EXPECT_EQ(toHex(Sha384::hash(msg)), expected384);
+        EXPECT_EQ(Encryptor::sha384(buffer).asHexString(), expected384);
+    };
+
+    // padding fits into the last block or requires one more block
+    doTest("// case 1",
+           0u,
+           "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd474"
+           "17a81a538327af927da3e",
+           "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b");
+    doTest("// case 2",
+           127u,
+           "eab89674feaa34e27aebeeff3c0a4d70070bb872d5e9f186cf1dbbdee517b6e35724d629ff025a5b07185e911ada7e3c8acf830aa0e"
+           "4f71777bd2d44f504f7f0",
+           "d5fcfe2fcf6b3ef375ede37c8123d9b78065fecc1d55197e2f7721e6e9a93d0ba4d7fd15f9b96dea2744df24141ba2ef");
+    doTest("// case 3",
+           239u,
+           "cb4c7fd522756d5781ad3a4f590a1d862906b960e7720136cb3fb36b563caa1ea5689134291fa79c80ccc2b4092b41df32ebdcb36db"
+           "e79db483440228c1622a8",
+           "2556cf077a788c49bb6d600f4a3cee635c4443832d169f761537afee2980742b9f34afbc87f598dd0aedc4a826ed6a73");
+}
+
+TEST(Sha512Tests, update)
+{
+    const auto msg = makeData(100000u);
+    const std::string expected512 = "f1fb14527782d69f6cd1aa6129c5f1486e23c4fbf328139e4dc30d41f9d2ca2b1d874ee7a969f0f071"
+                                    "b8ae46932f7c3e13458ce172800e15cae9b1a5b52c4cea";
+    const std::string expected384 =
+        "155b0ba362098f2706edcca94912bb12cefee8ce211fc5f5f9f80cccdb397bc6962332c87e7ec03aa382790eaaf1294c";
+
+    {
+        // SCOPED_TRACE("// case 1. chunks of growing length");
+
+        Sha512 sha512;
+        Sha384 sha384;
+        size_t offset = 0;
+        for (size_t sz = 0; offset < msg.size(); ++sz) {
+            const size_t len = std::min(sz, msg.size() - offset);
+            sha512.update(std::span(msg).subspan(offset, len));
+            sha384.update(std::span(msg).subspan(offset, len));
+            offset += len;
+        }
+        EXPECT_EQ(sha512.length(), uint64_t(msg.size()));
+        EXPECT_EQ(sha384.length(), uint64_t(msg.size()));
+        EXPECT_EQ(toHex(sha512.final()), expected512);
+        EXPECT_EQ(toHex(sha384.final()), expected384);
+        EXPECT_EQ(sha512.length(), uint64_t(0));
+        EXPECT_EQ(sha384.length(), uint64_t(0));
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. object is reusable after final");
+
+        Sha384 sha;
+        sha.update(ByteBuffer("abc"));
+        EXPECT_EQ(toHex(sha.final()),
+                  "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7");
+
+        sha.update(ByteBuffer("garbage"));
+        sha.reset();
+        sha.update(std::span(msg).first(50000u));
+        sha.update(std::span(msg).subspan(50000u));
+
+        std::array<uint8_t, 48u> out = {};
+        EXPECT_EQ(sha.final(std::span(out).first(47u)), false);
+        EXPECT_EQ(sha.final(out), true);
+        EXPECT_EQ(toHex(out), expected384);
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. million of 'a'");
+
+        const std::vector<uint8_t> chunk(1000u, uint8_t('a'));
+        Sha512 sha;
+        for (size_t i = 0; i < 1000u; ++i) {
+            sha.update(chunk);
+        }
+        EXPECT_EQ(toHex(sha.final()),
+                  "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb00"
+                  "9c5c2c49aa2e4eadb217ad8cc09b");
+    }
+
+    {
+        // SCOPED_TRACE("// case 4. caller buffer API of Encryptor");
+
+        std::array<uint8_t, 64u> out = {};
+        EXPECT_EQ(Encryptor::sha512(msg, out), true);
+        EXPECT_EQ(toHex(out), expected512);
+        EXPECT_EQ(Encryptor::sha512(msg, std::span(out).first(48u)), false);
+        EXPECT_EQ(Encryptor::sha384(msg, std::span(out).first(48u)), true);
+        EXPECT_EQ(toHex(std::span(out).first(48u)), expected384);
+        EXPECT_EQ(Encryptor::sha384(msg, std::span(out).first(32u)), false);
+    }
+}
+
+TEST(Sha512Tests, hmacHkdf)
+{
+    const ByteBuffer key("4a656665", true);
+    const ByteBuffer data("7768617420646f2079612077616e7420666f72206e6f7468696e673f", true);
+
+    // RFC 4231
+    EXPECT_EQ(Encryptor::hmac512(key, data).asHexString(),
+              "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a3"
+              "4d4a6b4b636e070a38bce737");
+    EXPECT_EQ(Encryptor::hmac384(key, data).asHexString(),
+              "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649");
+
+    const ByteBuffer ikm("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b", true);
+    const ByteBuffer salt("000102030405060708090a0b0c", true);
+    const ByteBuffer info("f0f1f2f3f4f5f6f7f8f9", true);
+    EXPECT_EQ(Encryptor::hkdf512(ikm, salt, info, 42).asHexString(),
+              "832390086cda71fb47625bb5ceb168e4c8e26a1a16ed34d9fc7fe92c1481579338da362cb8d9f925d7cb");
+    EXPECT_EQ(Encryptor::hkdf512Expand(Encryptor::hmac512(salt, ikm), info, 42).asHexString(),
+              "832390086cda71fb47625bb5ceb168e4c8e26a1a16ed34d9fc7fe92c1481579338da362cb8d9f925d7cb");
+    EXPECT_EQ(Encryptor::hkdf384(ikm, salt, info, 42).asHexString(),
+              "9b5097a86038b805309076a44b3a9f38063e25b516dcbf369f394cfab43685f748b6457763e4f0204fc5");
+    EXPECT_EQ(Encryptor::hkdf384Expand(Encryptor::hmac384(salt, ikm), info, 42).asHexString(),
+              "9b5097a86038b805309076a44b3a9f38063e25b516dcbf369f394cfab43685f748b6457763e4f0204fc5");
+
+    const ByteBuffer prk(
+        "18954cf5bfeaeed4812f64302b9efb3c3251ee3fd5a73066495601873bfeaf64044bdc1b66ac3415135d18b3c4ff30d4", true);
+    EXPECT_EQ(Encryptor::hkdf384ExpandLabel(prk, "tls13 key", {}, 32u).asHexString(),
+              "4140dfbf71e500ae8105adae978eb7438faa653699141e2ea8b7778d4d8f6997");
+}
+
+TEST(Sha512Tests, performance)
+{
+    const auto msg = makeData(1024u * 1024u);
+
+    TestHelper::timeFn(
+        "Sha512 update 1 MB",
+        [&msg]() {
+            Sha512 sha;
+            sha.update(msg);
+            sha.final();
+        },
+        100);
+
+    TestHelper::timeFn(
+        "Sha384 update 1 MB",
+        [&msg]() {
+            Sha384 sha;
+            sha.update(msg);
+            sha.final();
+        },
+        100);
+}
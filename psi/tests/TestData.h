@@ -0,0 +1,60 @@
+#pragma once
+
+#include "psi/tools/ByteBuffer.h"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace psi::test {
+
+/**
+ * @brief Return hex string of provided bytes.
+ *
+ * @param data (in) bytes
+ * @return std::string hex string
+ */
+inline std::string toHex(std::span<const uint8_t> data)
+{
+    return psi::tools::ByteBuffer(data.data(), data.size()).asHexString();
+}
+
+/**
+ * @brief Return hex string of provided bytes.
+ *
+ * @param data (in) pointer to bytes
+ * @param len (in) number of bytes
+ * @return std::string hex string
+ */
+inline std::string toHex(const uint8_t *data, size_t len)
+{
+    return toHex(std::span<const uint8_t>(data, len));
+}
+
+/**
+ * @brief Return view of used part of buffer.
+ *
+ * @param buffer (in) buffer
+ * @return std::span<const uint8_t> view of buffer
+ */
+inline std::span<const uint8_t> asSpan(const psi::tools::ByteBuffer &buffer)
+{
+    return std::span<const uint8_t>(buffer.data(), buffer.size());
+}
+
+/**
+ * @brief Generate deterministic data of provided length, byte values repeat every 256 bytes.
+ *
+ * @param len (in) length of data
+ * @return std::vector<uint8_t> data
+ */
+inline std::vector<uint8_t> makeData(size_t len)
+{
+    std::vector<uint8_t> data(len);
+    for (size_t i = 0; i < len; ++i) {
+        data[i] = uint8_t(i * 7u + 3u);
+    }
+    return data;
+}
+
+} // namespace psi::test
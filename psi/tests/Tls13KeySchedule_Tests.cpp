@@ -0,0 +1,170 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include "psi/tools/Sha256.h"
+#include "psi/tools/Tls13KeySchedule.h"
+
+using namespace psi::tools;
+using namespace psi::test;
+
+TEST(Tls13KeyScheduleTests, handshake)
+{
+    const ByteBuffer sharedKey("8bd4054fb55b9d63fdfbacf9f04b9f0d35e6d63f537563efd46272900f89492d", true);
+    const ByteBuffer helloHash("860c06edc07858ee8e78f0e7428c58edd6b43f2ca3e6e95f02ed063cf0e1cad8", true);
+    const ByteBuffer handshakeHash("9608102a0f1ccc6db6250b7b7e417b1a000eaada3daae4777a7686c9ff83df13", true);
+
+    Tls13KeySchedule schedule;
+    EXPECT_EQ(schedule.stage(), Tls13KeySchedule::Stage::Early);
+    EXPECT_EQ(toHex(schedule.secret()), "33ad0a1c607ec03b09e6cd9893680ce210adf300aa1f2660e1b22e10f170f92a");
+
+    Tls13KeySchedule::Secret clientSecret = {};
+    Tls13KeySchedule::Secret serverSecret = {};
+    std::array<uint8_t, 16u> key = {};
+    std::array<uint8_t, Tls13KeySchedule::IV_SIZE> iv = {};
+
+    {
+        // SCOPED_TRACE("// case 1. handshake secrets");
+
+        EXPECT_EQ(schedule.deriveHandshake(asSpan(sharedKey)), true);
+        EXPECT_EQ(schedule.stage(), Tls13KeySchedule::Stage::Handshake);
+        EXPECT_EQ(toHex(schedule.secret()),
+                  "1dc826e93606aa6fdc0aadc12f741b01046aa6b99f691ed221a9f0ca043fbeac");
+
+        EXPECT_EQ(schedule.clientHandshakeTrafficSecret(asSpan(helloHash), clientSecret), true);
+        EXPECT_EQ(toHex(clientSecret), "b3eddb126e067f35a780b3abf45e2d8f3b1a950738f52e9600746a0e27a55a21");
+        EXPECT_EQ(schedule.serverHandshakeTrafficSecret(asSpan(helloHash), serverSecret), true);
+        EXPECT_EQ(toHex(serverSecret), "b67b7d690cc16c4e75e54213cb2d37b4e9c912bcded9105d42befd59d391ad38");
+
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(serverSecret, key, iv), true);
+        EXPECT_EQ(toHex(key), "3fce516009c21727d0f2e4e86ee403bc");
+        EXPECT_EQ(toHex(iv), "5d313eb2671276ee13000b30");
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(clientSecret, key, iv), true);
+        EXPECT_EQ(toHex(key), "dbfaa693d1762c5b666af5d950258d01");
+        EXPECT_EQ(toHex(iv), "5bd3c71b836e0b76bb73265f");
+
+        Tls13KeySchedule::Secret finished = {};
+        EXPECT_EQ(Tls13KeySchedule::finishedKey(serverSecret, finished), true);
+        EXPECT_EQ(toHex(finished), "008d3b66f816ea559f96b537e885c31fc068bf492c652f01f288a1d8cdc19fc8");
+        EXPECT_EQ(Tls13KeySchedule::finishedKey(clientSecret, finished), true);
+        EXPECT_EQ(toHex(finished), "b80ad01015fb2f0bd65ff7d4da5d6bf83f84821d1f87fdc7d3c75b5a7b42d9c4");
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. application secrets");
+
+        EXPECT_EQ(schedule.deriveMaster(), true);
+        EXPECT_EQ(schedule.stage(), Tls13KeySchedule::Stage::Master);
+        EXPECT_EQ(toHex(schedule.secret()),
+                  "18df06843d13a08bf2a449844c5f8a478001bc4d4c627984d5a41da8d0402919");
+
+        EXPECT_EQ(schedule.clientApplicationTrafficSecret(asSpan(handshakeHash), clientSecret), true);
+        EXPECT_EQ(toHex(clientSecret), "9e40646ce79a7f9dc05af8889bce6552875afa0b06df0087f792ebb7c17504a5");
+        EXPECT_EQ(schedule.serverApplicationTrafficSecret(asSpan(handshakeHash), serverSecret), true);
+        EXPECT_EQ(toHex(serverSecret), "a11af9f05531f856ad47116b45a950328204b4f44bfb6b3a4b4f1f3fcb631643");
+
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(serverSecret, key, iv), true);
+        EXPECT_EQ(toHex(key), "9f02283b6c9c07efc26bb9f2ac92e356");
+        EXPECT_EQ(toHex(iv), "cf782b88dd83549aadf1e984");
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(clientSecret, key, iv), true);
+        EXPECT_EQ(toHex(key), "17422dda596ed5d9acd890e3c63f5051");
+        EXPECT_EQ(toHex(iv), "5b78923dee08579033e523d9");
+
+        std::array<uint8_t, 32u> key256 = {};
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(serverSecret, key256, iv), true);
+        EXPECT_EQ(toHex(key256), "848e80ab93efeb09c572c66873c184f99207c95b0fc817f91e8e7e8e14ac5ca9");
+
+        Tls13KeySchedule::Secret exporter = {};
+        EXPECT_EQ(schedule.exporterMasterSecret(asSpan(handshakeHash), exporter), true);
+        EXPECT_EQ(toHex(exporter), "fe22f881176eda18eb8f44529e6792c50c9a3f89452f68d8ae311b4309d3cf50");
+
+        // key update in place
+        EXPECT_EQ(Tls13KeySchedule::nextTrafficSecret(serverSecret, serverSecret), true);
+        EXPECT_EQ(toHex(serverSecret), "51921b8aa3001976eb401d0a4319a8516416a6c56001a357e5d162031e84f916");
+    }
+}
+
+TEST(Tls13KeyScheduleTests, psk)
+{
+    std::array<uint8_t, 32u> psk = {};
+    for (size_t i = 0; i < psk.size(); ++i) {
+        psk[i] = uint8_t(i);
+    }
+    const Sha256::Digest helloHash = Sha256::hash(asSpan(ByteBuffer("hello")));
+
+    Tls13KeySchedule schedule(psk);
+    EXPECT_EQ(toHex(schedule.secret()), "46bd320605c5a6b6163ab70bc6345b92a5f908e79fe58979c23ebb47d1a5e307");
+
+    Tls13KeySchedule::Secret secret = {};
+    EXPECT_EQ(schedule.binderKey(true, secret), true);
+    EXPECT_EQ(toHex(secret), "568ad66229e801b2609b6f1b233c9a251c4835668e4443c9f32b9c4aa2d64a9e");
+    EXPECT_EQ(schedule.clientEarlyTrafficSecret(helloHash, secret), true);
+    EXPECT_EQ(toHex(secret), "73af67425de0ea467442a2606217732b778d1886facf19123bdddb7ab4b26e65");
+
+    // psk_ke mode, no (EC)DHE input
+    EXPECT_EQ(schedule.deriveHandshake({}), true);
+    EXPECT_EQ(toHex(schedule.secret()), "9859803b3c3ddc750d3be02a2b1f673e7173cbeaa722d48391b7998cb96cb771");
+}
+
+TEST(Tls13KeyScheduleTests, misuse)
+{
+    Tls13KeySchedule schedule;
+    const Tls13KeySchedule::Secret hash = {};
+    Tls13KeySchedule::Secret secret = {};
+    std::array<uint8_t, 16u> key = {};
+    std::array<uint8_t, Tls13KeySchedule::IV_SIZE> iv = {};
+
+    {
+        // SCOPED_TRACE("// case 1. wrong stage");
+
+        EXPECT_EQ(schedule.deriveMaster(), false);
+        EXPECT_EQ(schedule.clientHandshakeTrafficSecret(hash, secret), false);
+        EXPECT_EQ(schedule.clientApplicationTrafficSecret(hash, secret), false);
+        EXPECT_EQ(schedule.deriveHandshake({}), true);
+        EXPECT_EQ(schedule.deriveHandshake({}), false);
+        EXPECT_EQ(schedule.binderKey(false, secret), false);
+        EXPECT_EQ(schedule.resumptionMasterSecret(hash, secret), false);
+        EXPECT_EQ(schedule.deriveMaster(), true);
+        EXPECT_EQ(schedule.deriveMaster(), false);
+        EXPECT_EQ(schedule.serverHandshakeTrafficSecret(hash, secret), false);
+        EXPECT_EQ(schedule.resumptionMasterSecret(hash, secret), true);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. wrong sizes");
+
+        EXPECT_EQ(schedule.exporterMasterSecret(std::span(hash).first(31u), secret), false);
+        EXPECT_EQ(schedule.exporterMasterSecret(hash, std::span(secret).first(31u)), false);
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(std::span(hash).first(16u), key, iv), false);
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(hash, std::span(key).first(15u), iv), false);
+        EXPECT_EQ(Tls13KeySchedule::trafficKeys(hash, key, std::span(iv).first(8u)), false);
+        EXPECT_EQ(Tls13KeySchedule::finishedKey(hash, std::span(secret).first(16u)), false);
+        EXPECT_EQ(Tls13KeySchedule::nextTrafficSecret({}, secret), false);
+    }
+}
+
+TEST(Tls13KeyScheduleTests, performance)
+{
+    const Tls13KeySchedule::Secret sharedKey = {1, 2, 3};
+    const Tls13KeySchedule::Secret hash = {4, 5, 6};
+
+    TestHelper::timeFn(
+        "Tls13KeySchedule full handshake",
+        [&]() {
+            Tls13KeySchedule schedule;
+            Tls13KeySchedule::Secret secret = {};
+            std::array<uint8_t, 16u> key = {};
+            std::array<uint8_t, Tls13KeySchedule::IV_SIZE> iv = {};
+            schedule.deriveHandshake(sharedKey);
+            schedule.clientHandshakeTrafficSecret(hash, secret);
+            Tls13KeySchedule::trafficKeys(secret, key, iv);
+            schedule.serverHandshakeTrafficSecret(hash, secret);
+            Tls13KeySchedule::trafficKeys(secret, key, iv);
+            schedule.deriveMaster();
+            schedule.clientApplicationTrafficSecret(hash, secret);
+            Tls13KeySchedule::trafficKeys(secret, key, iv);
+            schedule.serverApplicationTrafficSecret(hash, secret);
+            Tls13KeySchedule::trafficKeys(secret, key, iv);
+        },
+        10000);
+}
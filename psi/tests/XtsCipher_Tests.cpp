@@ -0,0 +1,121 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "TestData.h"
+
+#include "psi/tools/XtsCipher.h"
+
+#include <vector>
+
+using namespace psi::tools;
+using namespace psi::test;
+
+namespace {
+
+ByteBuffer makeKey(size_t len)
+{
+    ByteBuffer key(len);
+    for (size_t i = 0; i < len; ++i) {
+        key.write(uint8_t(i));
+    }
+    return key;
+}
+
+} // namespace
+
+TEST(XtsCipherTests, encryptDecrypt)
+{
+    const XtsCipher cipher128(makeKey(32u));
+    const XtsCipher cipher256(makeKey(64u));
+    ASSERT_EQ(cipher128.isValid(), true);
+    ASSERT_EQ(cipher256.isValid(), true);
+
+    {
+        // SCOPED_TRACE("// case 1. XTS-AES-128, two sectors");
+
+        const auto plain = makeData(64u);
+        auto data = plain;
+        EXPECT_EQ(cipher128.encrypt(data, 32u, 5u), true);
+        EXPECT_EQ(toHex(data.data(), 64u),
+                  "0c96e3065803deb837e629b83afe1c9c0fd502f6b756de988f78391842c0df6a"
+                  "7fd84f1378863c04db3269940661b202f42dbe3fad1dc45626f6f8c24226c7ad");
+
+        // second sector is decrypted alone
+        EXPECT_EQ(cipher128.decrypt(std::span(data).subspan(32u), 32u, 6u), true);
+        EXPECT_EQ(toHex(shift_ptr(data.data(), 32u), 32u), toHex(shift_ptr(plain.data(), 32u), 32u));
+        EXPECT_EQ(cipher128.decrypt(std::span(data).first(32u), 32u, 5u), true);
+        EXPECT_EQ(data == plain, true);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. XTS-AES-256, 64-bit sector number");
+
+        const auto plain = makeData(48u);
+        auto data = plain;
+        EXPECT_EQ(cipher256.encrypt(data, 48u, 0x123456789aull), true);
+        EXPECT_EQ(toHex(data.data(), 48u),
+                  "876249c4e5b752185cc7bf73cf982acfaf378ac265d96dda65e2d7d8b188c4b7"
+                  "a3c84bcfba2eba12a08a98bb4d6659b3");
+        EXPECT_EQ(cipher256.decrypt(data, 48u, 0x123456789aull), true);
+        EXPECT_EQ(data == plain, true);
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. ciphertext stealing");
+
+        auto plain = makeData(17u);
+        auto data = plain;
+        EXPECT_EQ(cipher128.encrypt(data, 17u, 1u), true);
+        EXPECT_EQ(toHex(data.data(), 17u), "dad82433e19e0d7b1994a4abbd81fb1900");
+        EXPECT_EQ(cipher128.decrypt(data, 17u, 1u), true);
+        EXPECT_EQ(data == plain, true);
+
+        plain = makeData(62u);
+        data = plain;
+        EXPECT_EQ(cipher256.encrypt(data, 31u, 2u), true);
+        EXPECT_EQ(toHex(data.data(), 62u),
+                  "cba349103a424514228301b414c69ded75c5249126fc14f03d4f20b8cd6feb"
+                  "146996514f44572ab00778dcaa55268dc23d8f2718ca3aef445593fabfa4e9");
+        EXPECT_EQ(cipher256.decrypt(data, 31u, 2u), true);
+        EXPECT_EQ(data == plain, true);
+    }
+}
+
+TEST(XtsCipherTests, manySectors)
+{
+    // 5 MiB of 4 KiB pages are split between threads, result must not depend on it
+    const XtsCipher cipher(makeKey(64u));
+    const size_t sectorSize = 4096u;
+    const size_t sectors = 5u * 256u + 3u;
+    const auto plain = makeData(sectors * sectorSize);
+
+    auto data = plain;
+    EXPECT_EQ(cipher.encrypt(data, sectorSize, 1000u), true);
+
+    bool isSame = true;
+    for (size_t i = 0; i < sectors; i += 97u) {
+        std::vector<uint8_t> page(plain.begin() + i * sectorSize, plain.begin() + (i + 1u) * sectorSize);
+        cipher.encrypt(page, sectorSize, 1000u + i);
+        isSame &= std::equal(page.begin(), page.end(), data.begin() + i * sectorSize);
+    }
+    EXPECT_EQ(isSame, true);
+
+    EXPECT_EQ(cipher.decrypt(data, sectorSize, 1000u), true);
+    EXPECT_EQ(data == plain, true);
+}
+
+TEST(XtsCipherTests, invalidUsage)
+{
+    EXPECT_EQ(XtsCipher().isValid(), false);
+    EXPECT_EQ(XtsCipher(makeKey(16u)).isValid(), false);
+    EXPECT_EQ(XtsCipher(makeKey(48u)).isValid(), false);
+    EXPECT_EQ(XtsCipher(ByteBuffer(32u)).isValid(), false);
+
+    const XtsCipher cipher(makeKey(32u));
+    const auto plain = makeData(64u);
+    auto data = plain;
+    EXPECT_EQ(cipher.encrypt(data, 15u, 0u), false);
+    EXPECT_EQ(cipher.encrypt(data, 48u, 0u), false);
+    EXPECT_EQ(cipher.decrypt(data, 0u, 0u), false);
+    EXPECT_EQ(XtsCipher().encrypt(data, 16u, 0u), false);
+    EXPECT_EQ(data == plain, true);
+}
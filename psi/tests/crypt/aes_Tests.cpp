@@ -1,5 +1,6 @@
 #include "psi/test/TestHelper.h"
 #include "psi/test/psi_mock.h"
+#include "../TestData.h"
 
 #include <iostream>
 #include <set>
@@ -7,6 +8,8 @@
 
 #include "psi/tools/Tools.h"
 #include "psi/tools/crypt/aes.h"
+#include "psi/tools/crypt/aes_ni.h"
+#include "psi/tools/crypt/aes_ttable.h"
 
 using namespace psi::tools;
 using namespace psi::tools::crypt;
@@ -93,6 +96,16 @@ TEST(aes_Tests, mixColumns)
     EXPECT_EQ("bd86f0ea748fc4f4630f11c1e9331233", blockToString(block));
 }
 
+TEST(aes_Tests, invMixColumns)
+{
+    aes::DataBlock16 block;
+    stringToBlock("bd86f0ea748fc4f4630f11c1e9331233", block);
+
+    aes::invMixColumns(block);
+
+    EXPECT_EQ("d6f3d9dda6279bd1430d52a0e513f3fe", blockToString(block));
+}
+
 TEST(aes_Tests, applySubKey)
 {
     aes::SubKey roundKey = {0xd0, 0x14, 0xf9, 0xa8, 0xc9, 0xee, 0x25, 0x89, 0xe1, 0x3f, 0x0c, 0xc8, 0xb6, 0x63, 0x0c, 0xa6};
@@ -397,6 +410,236 @@ TEST(aes_Tests, decryptAes_impl_AES256)
     }
 }
 
+TEST(aes_Tests, backends)
+{
+    auto doTest = [](const std::string &hexKey) {
+        const AesKey key(ByteBuffer(hexKey, true));
+        ASSERT_EQ(key.isValid(), true);
+
+        // 8-block lanes + tail
+        ByteBuffer data(16u * 19u);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data.write(uint8_t(i * 31u + 7u));
+        }
+
+        std::vector<aes::Backend> backends = {aes::Backend::Portable, aes::Backend::TTable, aes::Backend::Bitsliced};
+        if (aes_ni::isSupported()) {
+            backends.emplace_back(aes::Backend::AesNi);
+        }
+
+        ByteBuffer expected(data.size());
+        aes::encryptBlocks(aes::Backend::Portable, key, data.data(), expected.data(), 19u);
+
+        for (auto backend : backends) {
+            ByteBuffer encrypted(data.size());
+            aes::encryptBlocks(backend, key, data.data(), encrypted.data(), 19u);
+            EXPECT_EQ(encrypted.asHexString(), expected.asHexString());
+
+            ByteBuffer decrypted(data.size());
+            aes::decryptBlocks(backend, key, encrypted.data(), decrypted.data(), 19u);
+            EXPECT_EQ(decrypted.asHexString(), data.asHexString());
+        }
+    };
+
+    doTest("000102030405060708090a0b0c0d0e0f");
+    doTest("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+}
+
+TEST(aes_Tests, invertKeys)
+{
+    // FIPS-197 C.1 with equivalent inverse cipher
+    const AesKey key(ByteBuffer("000102030405060708090a0b0c0d0e0f", true));
+    const ByteBuffer data("00112233445566778899aabbccddeeff", true);
+
+    std::array<AesKey::RoundKey, AesKey::MAX_ROUNDS + 1u> decRoundKeys = {};
+    aes_ttable::invertKeys(key.roundKey(0).data(), key.rounds(), decRoundKeys[0].data());
+    EXPECT_EQ(toHex(decRoundKeys[0]), toHex(key.roundKey(10)));
+    EXPECT_EQ(toHex(decRoundKeys[1]), "13aa29be9c8faff6f770f58000f7bf03");
+    EXPECT_EQ(toHex(decRoundKeys[9]), "8c56dff0825dd3f9805ad3fc8659d7fd");
+    EXPECT_EQ(toHex(decRoundKeys[10]), toHex(key.roundKey(0)));
+
+    ByteBuffer encrypted(16u);
+    aes_ttable::encryptBlocks(key.roundKey(0).data(), key.rounds(), data.data(), encrypted.data(), 1u);
+    EXPECT_EQ(encrypted.asHexString(), "69c4e0d86a7b0430d8cdb78070b4c55a");
+
+    ByteBuffer decrypted(16u);
+    aes_ttable::decryptBlocks(decRoundKeys[0].data(), key.rounds(), encrypted.data(), decrypted.data(), 1u);
+    EXPECT_EQ(decrypted.asHexString(), data.asHexString());
+}
+
+TEST(aes_Tests, ctr32Xor)
+{
+    std::vector<aes::Backend> backends = {aes::Backend::Portable, aes::Backend::TTable, aes::Backend::Bitsliced};
+    if (aes_ni::isSupported()) {
+        backends.emplace_back(aes::Backend::AesNi);
+    }
+
+    // SP 800-38A F.5.1 CTR-AES128.Encrypt
+    {
+        const AesKey key(ByteBuffer("2b7e151628aed2a6abf7158809cf4f3c", true));
+        const ByteBuffer data("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                              "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710",
+                              true);
+        for (auto backend : backends) {
+            ByteBuffer counter("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", true);
+            ByteBuffer encrypted(data.size());
+            aes::ctr32Xor(backend, key, counter.data(), data.data(), encrypted.data(), data.size());
+            EXPECT_EQ(encrypted.asHexString(),
+                      "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+                      "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+            EXPECT_EQ(counter.asHexString(), "f0f1f2f3f4f5f6f7f8f9fafbfcfdff03");
+        }
+    }
+
+    // counter wraps in its last 32 bits only, partial final block, in-place
+    {
+        const AesKey key(ByteBuffer("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true));
+        ByteBuffer data(16u * 19u + 5u);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data.write(uint8_t(i * 13u + 1u));
+        }
+
+        ByteBuffer expected;
+        for (auto backend : backends) {
+            ByteBuffer counter("cafebabefacedbaddecaf888fffffffa", true);
+            ByteBuffer encrypted(data);
+            aes::ctr32Xor(backend, key, counter.data(), encrypted.data(), encrypted.data(), encrypted.size());
+            EXPECT_EQ(counter.asHexString(), "cafebabefacedbaddecaf8880000000e");
+            if (expected.size() == 0) {
+                expected = encrypted;
+            }
+            EXPECT_EQ(encrypted.asHexString(), expected.asHexString());
+
+            counter = ByteBuffer("cafebabefacedbaddecaf888fffffffa", true);
+            aes::ctr32Xor(backend, key, counter.data(), encrypted.data(), encrypted.data(), encrypted.size());
+            EXPECT_EQ(encrypted.asHexString(), data.asHexString());
+        }
+    }
+}
+
+TEST(aes_Tests, cbc)
+{
+    // SP 800-38A F.2.1 and F.2.5 with PKCS#7 padding block
+    const ByteBuffer iv("000102030405060708090a0b0c0d0e0f", true);
+    const ByteBuffer data("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                          "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710",
+                          true);
+    {
+        const ByteBuffer key("2b7e151628aed2a6abf7158809cf4f3c", true);
+        const auto encrypted = aes::encryptCbc_impl<4, 10>(data, key, iv);
+        EXPECT_EQ(encrypted.asHexString(),
+                  "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+                  "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7"
+                  "8cb82807230e1321d3fae00d18cc2012");
+        const auto decrypted = aes::decryptCbc_impl<4, 10>(encrypted, key, iv);
+        EXPECT_EQ(decrypted.asHexString(), data.asHexString());
+    }
+    {
+        const ByteBuffer key("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", true);
+        const auto encrypted = aes::encryptCbc_impl<8, 14>(data, key, iv);
+        EXPECT_EQ(encrypted.asHexString(),
+                  "f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d"
+                  "39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b"
+                  "3f461796d6b0d6b2e0c2a72b4d80e644");
+        const auto decrypted = aes::decryptCbc_impl<8, 14>(encrypted, key, iv);
+        EXPECT_EQ(decrypted.asHexString(), data.asHexString());
+    }
+
+    // partial last block, invalid padding, invalid lengths
+    {
+        const ByteBuffer key("2b7e151628aed2a6abf7158809cf4f3c", true);
+        ByteBuffer partial(21u);
+        partial.writeArray(data.data(), 21u);
+        auto encrypted = aes::encryptCbc_impl<4, 10>(partial, key, iv);
+        EXPECT_EQ(encrypted.asHexString(), "7649abac8119b246cee98e9b12e9197d40053932ebc80b58118369062552a01d");
+        const auto decrypted = aes::decryptCbc_impl<4, 10>(encrypted, key, iv);
+        EXPECT_EQ(decrypted.asHexString(), partial.asHexString());
+
+        *shift_ptr(encrypted.data(), 31u) ^= 1u;
+        const auto badPadding = aes::decryptCbc_impl<4, 10>(encrypted, key, iv);
+        EXPECT_EQ(badPadding.size(), 0u);
+        const auto badLength = aes::decryptCbc_impl<4, 10>(partial, key, iv);
+        EXPECT_EQ(badLength.size(), 0u);
+        const auto badIv = aes::encryptCbc_impl<4, 10>(data, key, ByteBuffer(12u));
+        EXPECT_EQ(badIv.size(), 0u);
+        const auto badKey = aes::encryptCbc_impl<8, 14>(data, key, iv);
+        EXPECT_EQ(badKey.size(), 0u);
+    }
+}
+
+TEST(aes_Tests, ctr)
+{
+    // SP 800-38A F.5.1 and F.5.5, partial last block
+    const ByteBuffer iv("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", true);
+    ByteBuffer data(61u);
+    data.writeHexString("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be6");
+    {
+        const ByteBuffer key("2b7e151628aed2a6abf7158809cf4f3c", true);
+        const auto encrypted = aes::cryptCtr_impl<4, 10>(data, key, iv);
+        EXPECT_EQ(encrypted.asHexString(),
+                  "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+                  "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3");
+        const auto decrypted = aes::cryptCtr_impl<4, 10>(encrypted, key, iv);
+        EXPECT_EQ(decrypted.asHexString(), data.asHexString());
+    }
+    {
+        const ByteBuffer key("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", true);
+        const auto encrypted = aes::cryptCtr_impl<8, 14>(data, key, iv);
+        EXPECT_EQ(encrypted.asHexString(),
+                  "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+                  "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd0845");
+    }
+
+    // carry is propagated over whole counter
+    {
+        const ByteBuffer key("2b7e151628aed2a6abf7158809cf4f3c", true);
+        ByteBuffer counter("00000000000000fffffffffffffffffe", true);
+        ByteBuffer encrypted(64u);
+        aes::ctr128Xor(AesKey(key), counter.data(), data.data(), encrypted.data(), 61u);
+        EXPECT_EQ(counter.asHexString(), "00000000000001000000000000000002");
+        EXPECT_EQ(toHex(encrypted.data(), 61u),
+                  "fe3e4a35ddcc49eb08418e6f0e9400f574e11b1fe0b8537fdc62eff972459b0e"
+                  "c68c4a2b4373b68b40865b797ea658597723822dffedee5d57653a68ba");
+    }
+}
+
+TEST(aes_Tests, segmentedModes)
+{
+    // 5 MiB + 3 blocks are split into segments, in-place processing must give the same result
+    const AesKey key(ByteBuffer("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true));
+    const ByteBuffer iv("fffffffffffffffffffffffffffffff0", true);
+    const size_t blocks = 5u * 1024u * 1024u / 16u + 3u;
+    std::vector<uint8_t> data(blocks * 16u);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i * 7u + (i >> 12));
+    }
+
+    std::vector<uint8_t> encrypted(data.size());
+    aes::cbcEncrypt(key, iv.data(), data.data(), encrypted.data(), blocks);
+    std::vector<uint8_t> decrypted(encrypted);
+    aes::cbcDecrypt(key, iv.data(), decrypted.data(), decrypted.data(), blocks);
+    EXPECT_EQ(decrypted == data, true);
+
+    // sequential reference: counter is advanced block by block
+    uint8_t counter[16u];
+    mem_copy(counter, 0, iv.data(), 0, 16u);
+    std::vector<uint8_t> expected(data.size());
+    for (size_t n = 0; n < blocks; ++n) {
+        aes::encryptBlock(key, counter, shift_ptr(expected.data(), n * 16u));
+        for (size_t i = 0; i < 16u; ++i) {
+            expected[n * 16u + i] ^= data[n * 16u + i];
+        }
+        aes::addCounter(counter, 1u);
+    }
+
+    ByteBuffer ctr(iv);
+    std::vector<uint8_t> actual(data);
+    aes::ctr128Xor(key, ctr.data(), actual.data(), actual.data(), actual.size());
+    EXPECT_EQ(actual == expected, true);
+    EXPECT_EQ(toHex(ctr.data(), 16u), toHex(counter, 16u));
+}
+
 TEST(aes_Tests, performance)
 {
     ByteBuffer key(32u);
@@ -1,6 +1,7 @@
 #include "psi/test/TestHelper.h"
 #include "psi/test/psi_mock.h"
 
+#include "psi/tools/GcmStream.h"
 #include "psi/tools/crypt/aes_gcm.h"
 
 using namespace psi::tools;
@@ -42,6 +43,42 @@ TEST(aes_gcm_Tests, gfMultBlock)
            "4db870d37cb75fcb46097c36230d1612");
 }
 
+TEST(aes_gcm_Tests, gfMultTable)
+{
+    auto doTest = [](const auto &testCase, const auto &x, const auto &h, const auto &expected) {
+        // SCOPED_TRACE(testCase);
+
+        aes_gcm::DataBlock16 xBuffer = ByteBuffer(x, true).asArray<uint8_t, 16>();
+        aes_gcm::DataBlock16 hBuffer = ByteBuffer(h, true).asArray<uint8_t, 16>();
+        aes_gcm::GHashTable table;
+        aes_gcm::makeTable(hBuffer, table);
+        aes_gcm::gfMultTable(table, xBuffer);
+        ByteBuffer zBuffer(16);
+        zBuffer.write(xBuffer);
+        EXPECT_EQ(zBuffer.asHexString(), expected);
+    };
+
+    doTest("// case 1",
+           "0388dace60b6a392f328c2b971b2fe78",
+           "66e94bd4ef8a2c3b884cfa59ca342b2e",
+           "5e2ec746917062882c85b0685353deb7");
+
+    doTest("// case 2",
+           "5e2ec746917062882c85b0685353de37",
+           "66e94bd4ef8a2c3b884cfa59ca342b2e",
+           "f38cbb1ad69223dcc3457ae5b6b0f885");
+
+    doTest("// case 3",
+           "ba471e049da20e40495e28e58ca8c555",
+           "b83b533708bf535d0aa6e52980d53b78",
+           "b714c9048389afd9f9bc5c1d4378e052");
+
+    doTest("// case 4",
+           "acbef20579b4b8ebce889bac8732dad7",
+           "ed95f8e164bf3213febc740f0bd9c4af",
+           "4db870d37cb75fcb46097c36230d1612");
+}
+
 TEST(aes_gcm_Tests, encrypt)
 {
     {
@@ -285,3 +322,223 @@ TEST(aes_gcm_Tests, encrypt_decrypt)
            "cafebabefacedbad");
     doTest("// case 6.", "010203040506070809aaabbccddeeff", "00112233445566778899aabbccddeeff", "1234567890abcdef");
 }
+
+TEST(aes_gcm_Tests, ghashBackends)
+{
+    const AesKey key(ByteBuffer("feffe9928665731c6d6a8f9467308308", true));
+
+    ByteBuffer data(16u * 21u + 7u);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data.write(uint8_t(i * 17u + 3u));
+    }
+
+    // lengths cover 8-block aggregation, single block tail and partial block
+    for (size_t len : {0u, 5u, 16u, 48u, 128u, 135u, 16u * 17u, 16u * 21u + 7u}) {
+        aes_gcm::DataBlock16 expected = {};
+        aes_gcm::ghashBlock(aes_gcm::GHashBackend::Table, key, data.data(), len, expected);
+
+        aes_gcm::DataBlock16 actual = {};
+        aes_gcm::ghashBlock(aes_gcm::ghashBackend(), key, data.data(), len, actual);
+        ByteBuffer actualBuffer(16u);
+        actualBuffer.write(actual);
+        ByteBuffer expectedBuffer(16u);
+        expectedBuffer.write(expected);
+        EXPECT_EQ(actualBuffer.asHexString(), expectedBuffer.asHexString());
+    }
+}
+
+TEST(aes_gcm_Tests, decryptInto)
+{
+    const AesKey key(ByteBuffer("feffe9928665731c6d6a8f9467308308", true));
+    const ByteBuffer data("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e24"
+                          "49a6b525b16aedf5aa0de657ba637b39",
+                          true);
+    const ByteBuffer encrypted("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f"
+                               "6a5aac84aa051ba30b396a0aac973d58e091",
+                               true);
+    const ByteBuffer acc("feedfacedeadbeeffeedfacedeadbeefabaddad2", true);
+    const ByteBuffer iv("cafebabefacedbaddecaf888", true);
+    ByteBuffer tag("5bc94fbc3221a5db94fae95ae7121a47", true);
+
+    {
+        // SCOPED_TRACE("// case 1. valid tag");
+
+        ByteBuffer out(encrypted.size());
+        EXPECT_TRUE(aes_gcm::decrypt(encrypted.data(),
+                                     encrypted.size(),
+                                     key,
+                                     iv.data(),
+                                     iv.size(),
+                                     acc.data(),
+                                     acc.size(),
+                                     tag.data(),
+                                     tag.size(),
+                                     out.data()));
+        EXPECT_EQ(out.asHexString(), data.asHexString());
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. in-place");
+
+        ByteBuffer inPlace(encrypted);
+        EXPECT_TRUE(aes_gcm::decrypt(inPlace.data(),
+                                     inPlace.size(),
+                                     key,
+                                     iv.data(),
+                                     iv.size(),
+                                     acc.data(),
+                                     acc.size(),
+                                     tag.data(),
+                                     tag.size(),
+                                     inPlace.data()));
+        EXPECT_EQ(inPlace.asHexString(), data.asHexString());
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. wrong tag, output is wiped");
+
+        *shift_ptr(tag.data(), 15u) ^= 0x01;
+        ByteBuffer out(encrypted.size());
+        mem_set(out.data(), 0, uint8_t(0xaa), out.size());
+        EXPECT_FALSE(aes_gcm::decrypt(encrypted.data(),
+                                      encrypted.size(),
+                                      key,
+                                      iv.data(),
+                                      iv.size(),
+                                      acc.data(),
+                                      acc.size(),
+                                      tag.data(),
+                                      tag.size(),
+                                      out.data()));
+        EXPECT_EQ(out.asHexString(), ByteBuffer(encrypted.size()).asHexString());
+        EXPECT_EQ(aes_gcm::decrypt(encrypted, key, iv, tag, acc).size(), 0u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 4. empty tag is rejected");
+
+        ByteBuffer out(encrypted.size());
+        EXPECT_FALSE(aes_gcm::decrypt(
+            encrypted.data(), encrypted.size(), key, iv.data(), iv.size(), acc.data(), acc.size(), tag.data(), 0u, out.data()));
+        EXPECT_EQ(aes_gcm::decrypt(encrypted, key, iv, ByteBuffer(), acc).size(), 0u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 5. prefix of valid tag is rejected");
+
+        ByteBuffer out(encrypted.size());
+        EXPECT_FALSE(aes_gcm::decrypt(
+            encrypted.data(), encrypted.size(), key, iv.data(), iv.size(), acc.data(), acc.size(), tag.data(), 4u, out.data()));
+        EXPECT_EQ(aes_gcm::decrypt(encrypted, key, iv, ByteBuffer(static_cast<const uint8_t *>(tag.data()), 4u), acc).size(), 0u);
+    }
+}
+
+TEST(aes_gcm_Tests, encrypt_decrypt_AES256)
+{
+    auto doTest = [](const auto &testCase,
+                     const std::string &k,
+                     const std::string &d,
+                     const std::string &a,
+                     const std::string &i,
+                     const std::string &expected,
+                     const std::string &expectedTag) {
+        // SCOPED_TRACE(testCase);
+
+        const ByteBuffer key(k, true);
+        const ByteBuffer data(d, true);
+        const ByteBuffer acc(a, true);
+        const ByteBuffer iv(i, true);
+
+        aes_gcm::Tag tag = {};
+        const ByteBuffer encodedData = aes_gcm::encrypt_impl<8, 14>(data, key, iv, tag, acc);
+        ByteBuffer tagBuffer(16);
+        tagBuffer.write(tag);
+        EXPECT_EQ(encodedData.asHexString(), expected);
+        EXPECT_EQ(tagBuffer.asHexString(), expectedTag);
+
+        const ByteBuffer decodedData = aes_gcm::decrypt_impl<8, 14>(encodedData, AesKey(key), iv, tagBuffer, acc);
+        EXPECT_EQ(decodedData.asHexString(), data.asHexString());
+
+        EXPECT_EQ((aes_gcm::encrypt_impl<4, 10>(data, key, iv, tag, acc).size()), 0u);
+        EXPECT_EQ((aes_gcm::decrypt_impl<4, 10>(encodedData, AesKey(key), iv, tagBuffer, acc).size()), 0u);
+    };
+
+    // gcm-spec test cases 13-16
+    doTest("// case 13.",
+           "0000000000000000000000000000000000000000000000000000000000000000",
+           "",
+           "",
+           "000000000000000000000000",
+           "",
+           "530f8afbc74536b9a963b4f1c4cb738b");
+    doTest("// case 14.",
+           "0000000000000000000000000000000000000000000000000000000000000000",
+           "00000000000000000000000000000000",
+           "",
+           "000000000000000000000000",
+           "cea7403d4d606b6e074ec5d3baf39d18",
+           "d0d1c8a799996bf0265b98b5d48ab919");
+    doTest("// case 15.",
+           "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308",
+           "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de6"
+           "57ba637b391aafd255",
+           "",
+           "cafebabefacedbaddecaf888",
+           "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a"
+           "0abcc9f662898015ad",
+           "b094dac5d93471bdec1a502270e3cc6c");
+    doTest("// case 16.",
+           "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308",
+           "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de6"
+           "57ba637b39",
+           "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+           "cafebabefacedbaddecaf888",
+           "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a"
+           "0abcc9f662",
+           "76fc6ece0f4e1768cddf8853bb2d551b");
+}
+
+TEST(aes_gcm_Tests, segmentedLargeBuffer)
+{
+    const AesKey key(ByteBuffer("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", true));
+    const ByteBuffer iv("cafebabefacedbaddecaf888", true);
+    const ByteBuffer acc("feedfacedeadbeeffeedfacedeadbeefabaddad2", true);
+
+    // above threshold of segmented processing, last segment is not full and ends with partial block
+    ByteBuffer data(5u * 1024u * 1024u + 7u);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data.write(uint8_t(i * 31u + (i >> 12)));
+    }
+
+    aes_gcm::Tag tag = {};
+    const ByteBuffer encrypted = aes_gcm::encrypt(data, key, iv, tag, acc);
+
+    // streaming encryptor hashes everything sequentially
+    GcmEncryptor encryptor(key, std::span(iv.data(), iv.size()));
+    encryptor.updateAad(std::span(acc.data(), acc.size()));
+    const ByteBuffer expected = encryptor.update(data);
+    GcmStream::Tag expectedTag = {};
+    encryptor.final(expectedTag);
+
+    EXPECT_TRUE(encrypted.asHexString() == expected.asHexString());
+    EXPECT_TRUE(tag == expectedTag);
+
+    ByteBuffer tagBuffer(16u);
+    tagBuffer.write(tag);
+    const ByteBuffer decrypted = aes_gcm::decrypt(encrypted, key, iv, tagBuffer, acc);
+    EXPECT_TRUE(decrypted.asHexString() == data.asHexString());
+}
+
+TEST(aes_gcm_Tests, dataLengthLimit)
+{
+    const AesKey key(ByteBuffer("feffe9928665731c6d6a8f9467308308", true));
+    const std::array<uint8_t, 12u> iv = {};
+    std::array<uint8_t, 16u> data = {};
+    aes_gcm::Tag tag = {};
+
+    // data is not touched, length is rejected before processing
+    const size_t tooLong = aes_gcm::MAX_DATA_LENGTH + 1u;
+    EXPECT_FALSE(aes_gcm::encrypt(data.data(), tooLong, key, iv.data(), iv.size(), nullptr, 0u, data.data(), tag));
+    EXPECT_FALSE(aes_gcm::decrypt(
+        data.data(), tooLong, key, iv.data(), iv.size(), nullptr, 0u, tag.data(), tag.size(), data.data()));
+}
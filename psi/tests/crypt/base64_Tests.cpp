@@ -4,6 +4,7 @@
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <vector>
 
 #include "psi/tools/Tools.h"
 #include "psi/tools/crypt/base64.h"
@@ -47,3 +48,26 @@ TEST(base64_Tests, EncryptionDecryption_Base64_Fail)
     ByteBuffer decryptedMessage = base64::decryptBase64(encryptedMessage);
     EXPECT_EQ(decryptedMessage.size(), size_t {0});
 }
+
+TEST(base64_Tests, DecodeInPlace)
+{
+    {
+        // SCOPED_TRACE("// case 1. decoded bytes overwrite encoded characters");
+
+        const std::string encoded = "QmVzdCBiYXNlNjQgc3RyaW5nIQ==";
+        std::vector<uint8_t> data(encoded.begin(), encoded.end());
+        const size_t sz = base64::decodedSize(data.data(), data.size());
+        EXPECT_EQ(sz, 19u);
+        EXPECT_EQ(base64::decode(data.data(), data.size(), data.data()), true);
+        EXPECT_EQ(std::string(data.begin(), data.begin() + sz), "Best base64 string!");
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. padding is allowed only at the end");
+
+        for (const std::string encoded : {"QUJD=UJD", "QU=D", "Q===", "===="}) {
+            std::vector<uint8_t> data(encoded.begin(), encoded.end());
+            EXPECT_EQ(base64::decode(data.data(), data.size(), data.data()), false);
+        }
+    }
+}
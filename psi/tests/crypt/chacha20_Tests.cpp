@@ -0,0 +1,73 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "../TestData.h"
+
+#include <vector>
+
+#include "psi/tools/ByteBuffer.h"
+#include "psi/tools/Tools.h"
+#include "psi/tools/crypt/chacha20.h"
+
+using namespace psi::tools;
+using namespace psi::tools::crypt;
+using namespace psi::test;
+
+TEST(chacha20_Tests, keystream)
+{
+    chacha20::Key key = {};
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = uint8_t(i);
+    }
+
+    {
+        // SCOPED_TRACE("// case 1. RFC 8439 2.3.2, single block");
+
+        const ByteBuffer nonce("000000090000004a00000000", true);
+        uint8_t out[64u];
+        chacha20::keystream(key.data(), nonce.data(), 1u, out, sizeof(out));
+        EXPECT_EQ(toHex(out, sizeof(out)),
+                  "10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+                  "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e");
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. several batches of blocks and partial tail");
+
+        chacha20::Key key2 = {};
+        chacha20::Nonce nonce = {};
+        for (size_t i = 0; i < key2.size(); ++i) {
+            key2[i] = uint8_t(i * 7u + 3u);
+        }
+        for (size_t i = 0; i < nonce.size(); ++i) {
+            nonce[i] = uint8_t(i);
+        }
+
+        std::vector<uint8_t> out(1000u);
+        chacha20::keystream(key2.data(), nonce.data(), 7u, out.data(), out.size());
+        EXPECT_EQ(toHex(out.data(), 16u), "cb2212e0ae917045abb0b388ec13a1ce");
+        EXPECT_EQ(toHex(shift_ptr(out.data(), 256u), 16u), "5306089ba39efa4f9718313bc1fb60a4");
+        EXPECT_EQ(toHex(shift_ptr(out.data(), 984u), 16u), "a2f152460ec836b09605292c0adfdf21");
+    }
+}
+
+TEST(chacha20_Tests, xorStream)
+{
+    // RFC 8439 2.4.2
+    chacha20::Key key = {};
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = uint8_t(i);
+    }
+    const ByteBuffer nonce("000000000000004a00000000", true);
+    const std::string text = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the "
+                             "future, sunscreen would be it.";
+    const std::string expected = "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0bf91b65c5524733ab8f593d"
+                                 "abcd62b3571639d624e65152ab8f530c359f0861d807ca0dbf500d6a6156a38e088a22b65e52bc514d16cc"
+                                 "f806818ce91ab77937365af90bbf74a35be6b40b8eedf2785e42874d";
+
+    std::vector<uint8_t> data(text.begin(), text.end());
+    chacha20::xorStream(key.data(), nonce.data(), 1u, data.data(), data.data(), data.size());
+    EXPECT_EQ(toHex(data.data(), data.size()), expected);
+
+    chacha20::xorStream(key.data(), nonce.data(), 1u, data.data(), data.data(), data.size());
+    EXPECT_EQ(std::string(data.begin(), data.end()), text);
+}
@@ -0,0 +1,139 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "../TestData.h"
+
+#include <vector>
+
+#include "psi/tools/ByteBuffer.h"
+#include "psi/tools/Tools.h"
+#include "psi/tools/crypt/chacha20.h"
+#include "psi/tools/crypt/chacha20_poly1305.h"
+
+using namespace psi::tools;
+using namespace psi::tools::crypt;
+using namespace psi::test;
+
+TEST(chacha20_poly1305_Tests, encryptDecrypt)
+{
+    const ByteBuffer key("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f", true);
+    const ByteBuffer nonce("070000004041424344454647", true);
+    const ByteBuffer aad("50515253c0c1c2c3c4c5c6c7", true);
+
+    {
+        // SCOPED_TRACE("// case 1. RFC 8439 2.8.2");
+
+        const ByteBuffer plain("Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the "
+                               "future, sunscreen would be it.");
+        chacha20_poly1305::Tag tag = {};
+        const auto encrypted = chacha20_poly1305::encrypt(plain, key, nonce, tag, aad);
+        EXPECT_EQ(encrypted.asHexString(),
+                  "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a"
+                  "71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4"
+                  "def08e4b7a9de576d26586cec64b6116");
+        EXPECT_EQ(toHex(tag.data(), tag.size()), "1ae10b594f09e26a7e902ecbd0600691");
+
+        ByteBuffer tagBuffer(16u);
+        tagBuffer.write(tag);
+        EXPECT_EQ(chacha20_poly1305::decrypt(encrypted, key, nonce, tagBuffer, aad).asString(), plain.asString());
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. empty message");
+
+        chacha20_poly1305::Tag tag = {};
+        EXPECT_EQ(chacha20_poly1305::encrypt(ByteBuffer(0u), key, nonce, tag, aad).size(), 0u);
+        EXPECT_EQ(toHex(tag.data(), tag.size()), "e622e5647a38d967a7ecbcb46c7f675c");
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. long message in place, every backend");
+
+        std::vector<chacha20::Backend> backends = {chacha20::Backend::Portable};
+        if (chacha20::backend() != chacha20::Backend::Portable) {
+            backends.emplace_back(chacha20::Backend::Sse2);
+        }
+        if (chacha20::backend() == chacha20::Backend::Avx2) {
+            backends.emplace_back(chacha20::Backend::Avx2);
+        }
+
+        const std::vector<uint8_t> plain = makeData(5000u);
+
+        for (const auto backend : backends) {
+            std::vector<uint8_t> data = plain;
+            chacha20::xorStream(backend, key.data(), nonce.data(), 1u, data.data(), data.data(), data.size());
+            EXPECT_EQ(toHex(data.data(), 16u), "9c71f8451edb6d8e2ea0c6ab61df6fc2");
+            EXPECT_EQ(toHex(shift_ptr(data.data(), 4984u), 16u), "a7f97a50a46529b48fd1a69f3575c199");
+        }
+
+        std::vector<uint8_t> data = plain;
+        chacha20_poly1305::Tag tag = {};
+        chacha20_poly1305::encrypt(
+            key.data(), nonce.data(), nullptr, 0u, data.data(), data.size(), data.data(), tag.data());
+        EXPECT_EQ(toHex(tag.data(), tag.size()), "47b214ef5f3d90ca4cdf320d8c952b12");
+        EXPECT_EQ(chacha20_poly1305::decrypt(
+                      key.data(), nonce.data(), nullptr, 0u, data.data(), data.size(), tag.data(), data.data()),
+                  true);
+        EXPECT_EQ(data == plain, true);
+    }
+}
+
+TEST(chacha20_poly1305_Tests, tagMismatch)
+{
+    const ByteBuffer key("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f", true);
+    const ByteBuffer nonce("070000004041424344454647", true);
+    const ByteBuffer aad("50515253c0c1c2c3c4c5c6c7", true);
+    const ByteBuffer plain("message");
+
+    chacha20_poly1305::Tag tag = {};
+    auto encrypted = chacha20_poly1305::encrypt(plain, key, nonce, tag, aad);
+    ByteBuffer tagBuffer(16u);
+    tagBuffer.write(tag);
+
+    {
+        // SCOPED_TRACE("// case 1. modified aad, ciphertext or tag");
+
+        EXPECT_EQ(chacha20_poly1305::decrypt(encrypted, key, nonce, tagBuffer).size(), 0u);
+
+        auto modified = encrypted;
+        modified.data()[0] ^= 1u;
+        EXPECT_EQ(chacha20_poly1305::decrypt(modified, key, nonce, tagBuffer, aad).size(), 0u);
+
+        auto modifiedTag = tagBuffer;
+        modifiedTag.data()[15] ^= 0x80u;
+        EXPECT_EQ(chacha20_poly1305::decrypt(encrypted, key, nonce, modifiedTag, aad).size(), 0u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. output is untouched on mismatch");
+
+        std::vector<uint8_t> out(plain.size(), 0xaa);
+        tag[0] ^= 1u;
+        const bool result = chacha20_poly1305::decrypt(
+            key.data(), nonce.data(), aad.data(), aad.size(), encrypted.data(), plain.size(), tag.data(), out.data());
+        EXPECT_EQ(result, false);
+        EXPECT_EQ(toHex(out.data(), out.size()), "aaaaaaaaaaaaaa");
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. invalid sizes");
+
+        EXPECT_EQ(chacha20_poly1305::encrypt(plain, ByteBuffer(16u), nonce, tag).size(), 0u);
+        EXPECT_EQ(chacha20_poly1305::encrypt(plain, key, ByteBuffer(8u), tag).size(), 0u);
+        EXPECT_EQ(chacha20_poly1305::decrypt(encrypted, key, nonce, ByteBuffer(12u), aad).size(), 0u);
+    }
+}
+
+TEST(chacha20_poly1305_Tests, dataLengthLimit)
+{
+    const std::array<uint8_t, chacha20_poly1305::KEY_SIZE> key = {};
+    const std::array<uint8_t, chacha20_poly1305::NONCE_SIZE> nonce = {};
+    std::array<uint8_t, 64u> data = {};
+    chacha20_poly1305::Tag tag = {};
+
+    // data is not touched, length is rejected before processing
+    const size_t tooLong = chacha20_poly1305::MAX_DATA_LENGTH + 1u;
+    EXPECT_FALSE(chacha20_poly1305::encrypt(
+        key.data(), nonce.data(), nullptr, 0u, data.data(), tooLong, data.data(), tag.data()));
+    EXPECT_FALSE(chacha20_poly1305::decrypt(
+        key.data(), nonce.data(), nullptr, 0u, data.data(), tooLong, tag.data(), data.data()));
+}
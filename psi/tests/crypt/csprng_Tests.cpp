@@ -0,0 +1,93 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "../TestData.h"
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "psi/tools/ByteBuffer.h"
+#include "psi/tools/crypt/csprng.h"
+
+using namespace psi::tools;
+using namespace psi::tools::crypt;
+using namespace psi::test;
+
+namespace {
+
+// rough check that all byte values are present and none dominates
+bool looksRandom(const std::vector<uint8_t> &data)
+{
+    std::vector<size_t> counts(256u);
+    for (const auto b : data) {
+        ++counts[b];
+    }
+    const size_t expected = data.size() / 256u;
+    for (const auto c : counts) {
+        if (c < expected / 2u || c > expected * 2u) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(csprng_Tests, systemRandom)
+{
+    std::vector<uint8_t> a(64u);
+    std::vector<uint8_t> b(64u);
+    EXPECT_EQ(csprng::systemRandom(a.data(), a.size()), true);
+    EXPECT_EQ(csprng::systemRandom(b.data(), b.size()), true);
+    EXPECT_EQ(a == b, false);
+}
+
+TEST(csprng_Tests, fill)
+{
+    {
+        // SCOPED_TRACE("// case 1. small requests are unique");
+
+        std::set<std::string> nonces;
+        for (size_t i = 0; i < 10000u; ++i) {
+            uint8_t nonce[12u];
+            EXPECT_EQ(csprng::fill(nonce, sizeof(nonce)), true);
+            nonces.emplace(toHex(nonce, sizeof(nonce)));
+        }
+        EXPECT_EQ(nonces.size(), 10000u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. requests crossing buffer refill and reseed interval");
+
+        std::vector<uint8_t> data(csprng::RESEED_INTERVAL + 1000u);
+        for (size_t offset = 0; offset < data.size(); offset += 100u) {
+            EXPECT_EQ(csprng::fill(&data[offset], std::min<size_t>(100u, data.size() - offset)), true);
+        }
+        EXPECT_EQ(looksRandom(data), true);
+    }
+
+    {
+        // SCOPED_TRACE("// case 3. bulk request bypassing buffer");
+
+        std::vector<uint8_t> data(csprng::DIRECT_CHUNK + 12345u);
+        EXPECT_EQ(csprng::fill(data.data(), data.size()), true);
+        EXPECT_EQ(looksRandom(data), true);
+        EXPECT_EQ(looksRandom(std::vector<uint8_t>(data.end() - 12345, data.end())), true);
+    }
+
+    {
+        // SCOPED_TRACE("// case 4. threads have independent streams");
+
+        std::vector<std::vector<uint8_t>> outputs(4u, std::vector<uint8_t>(32u));
+        std::vector<std::thread> threads;
+        for (auto &out : outputs) {
+            threads.emplace_back([&out] { csprng::fill(out.data(), out.size()); });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        std::set<std::vector<uint8_t>> unique(outputs.begin(), outputs.end());
+        EXPECT_EQ(unique.size(), outputs.size());
+    }
+}
@@ -0,0 +1,77 @@
+#include "psi/test/TestHelper.h"
+#include "psi/test/psi_mock.h"
+#include "../TestData.h"
+
+#include <vector>
+
+#include "psi/tools/ByteBuffer.h"
+#include "psi/tools/Tools.h"
+#include "psi/tools/crypt/poly1305.h"
+
+using namespace psi::tools;
+using namespace psi::tools::crypt;
+using namespace psi::test;
+
+namespace {
+
+std::string mac(const ByteBuffer &key, const ByteBuffer &msg)
+{
+    poly1305::Tag tag = {};
+    poly1305::compute(key.data(), msg.data(), msg.size(), tag.data());
+    return toHex(tag.data(), tag.size());
+}
+
+} // namespace
+
+TEST(poly1305_Tests, compute)
+{
+    {
+        // SCOPED_TRACE("// case 1. RFC 8439 2.5.2");
+
+        const ByteBuffer key("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b", true);
+        EXPECT_EQ(mac(key, ByteBuffer("Cryptographic Forum Research Group")), "a8061dc1305136c6c22b8baf0c0127a9");
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. accumulator reaches modulus, RFC 8439 A.3");
+
+        const ByteBuffer r2("0200000000000000000000000000000000000000000000000000000000000000", true);
+        EXPECT_EQ(mac(r2, ByteBuffer("ffffffffffffffffffffffffffffffff", true)), "03000000000000000000000000000000");
+
+        const ByteBuffer r2s("02000000000000000000000000000000ffffffffffffffffffffffffffffffff", true);
+        EXPECT_EQ(mac(r2s, ByteBuffer("02000000000000000000000000000000", true)), "03000000000000000000000000000000");
+
+        const ByteBuffer r1("0100000000000000000000000000000000000000000000000000000000000000", true);
+        EXPECT_EQ(mac(r1,
+                      ByteBuffer("fffffffffffffffffffffffffffffffff0ffffffffffffffffffffffffffffff"
+                                 "11000000000000000000000000000000",
+                                 true)),
+                  "05000000000000000000000000000000");
+        EXPECT_EQ(mac(r1,
+                      ByteBuffer("fffffffffffffffffffffffffffffffffbfefefefefefefefefefefefefefefe"
+                                 "01010101010101010101010101010101",
+                                 true)),
+                  "00000000000000000000000000000000");
+    }
+}
+
+TEST(poly1305_Tests, update)
+{
+    ByteBuffer key(32u);
+    for (size_t i = 0; i < 32u; ++i) {
+        key.write(uint8_t(i * 13u + 1u));
+    }
+    const std::vector<uint8_t> msg = makeData(1000u);
+
+    // message is split at offsets not aligned to blocks
+    poly1305 state(key.data());
+    size_t offset = 0;
+    for (size_t sz = 1; offset < msg.size(); ++sz) {
+        const size_t len = std::min(sz, msg.size() - offset);
+        state.update(shift_ptr(msg.data(), offset), len);
+        offset += len;
+    }
+    poly1305::Tag tag = {};
+    state.finish(tag.data());
+    EXPECT_EQ(toHex(tag.data(), tag.size()), "f613286b1b98b5dc6a705cd6be003418");
+}
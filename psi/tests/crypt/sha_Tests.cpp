@@ -1,7 +1,14 @@
 #include "psi/test/TestHelper.h"
 #include "psi/test/psi_mock.h"
+#include "../TestData.h"
 
 #include "psi/tools/crypt/sha.h"
+#include "psi/tools/crypt/sha_hw.h"
+#include "psi/tools/crypt/sha512_avx2.h"
+#include "psi/tools/crypt/sha_mb.h"
+
+#include <algorithm>
+#include <vector>
 
 using namespace psi::tools;
 using namespace psi::tools::crypt;
@@ -97,6 +104,167 @@ TEST(sha_Tests, encode256)
            "8667e718294e9e0df1d30600ba3eeb201f764aad2dad72748643e4a285e1d1f7");
 }
 
+TEST(sha_Tests, compress256)
+{
+    std::vector<sha::Backend> backends = {sha::Backend::Portable};
+    if (sha_hw::isShaNiSupported()) {
+        backends.emplace_back(sha::Backend::ShaNi);
+    }
+    if (sha_hw::isArmv8Supported()) {
+        backends.emplace_back(sha::Backend::Armv8);
+    }
+
+    // "abc" padded to one block, and 1000 blocks of generated data
+    const ByteBuffer abc = sha::padMessage(ByteBuffer("abc"));
+    const std::vector<uint8_t> data = makeData(64000u);
+
+    for (const auto backend : backends) {
+        // SCOPED_TRACE(int(backend));
+
+        uint32_t h[8] = {};
+        sha::hashInit(h);
+        sha::compress256(backend, h, abc.data(), 1u);
+        EXPECT_EQ(h[0], uint32_t(0xba7816bf));
+        EXPECT_EQ(h[7], uint32_t(0xf20015ad));
+
+        sha::hashInit(h);
+        sha::compress256(backend, h, data.data(), 1000u);
+        uint8_t digest[32] = {};
+        sha::finish256(h, nullptr, 0u, data.size(), digest);
+        ByteBuffer result(32u);
+        result.writeArray(digest, 32u);
+        EXPECT_EQ(result.asHexString(), "b92d5059345a816cfbf8ac9b4ad7d54fed3332be4f677259fbaeeb25ceba59dc");
+    }
+}
+
+TEST(sha_Tests, encode256Batch)
+{
+    std::vector<sha::BatchBackend> backends = {sha::BatchBackend::Single};
+    if (sha_mb::isAvx2Supported()) {
+        backends.emplace_back(sha::BatchBackend::Avx2);
+    }
+    if (sha_mb::isAvx512Supported()) {
+        backends.emplace_back(sha::BatchBackend::Avx512);
+    }
+
+    // lengths around padding boundaries, empty messages and few long ones, so lanes finish at different times
+    const std::vector<uint8_t> data = makeData(100000u);
+    std::vector<std::span<const uint8_t>> messages;
+    for (size_t len = 0; len < 200u; ++len) {
+        messages.emplace_back(std::span(data).subspan(len, len));
+    }
+    messages.emplace_back(std::span(data).first(100000u));
+    messages.emplace_back(std::span(data).first(5000u));
+    messages.emplace_back(std::span(data).first(0u));
+
+    std::vector<sha::Digest256> expected(messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        sha::encode256(messages[i].data(), messages[i].size(), expected[i].data());
+    }
+
+    for (const auto backend : backends) {
+        // SCOPED_TRACE(int(backend));
+
+        std::vector<sha::Digest256> digests(messages.size());
+        EXPECT_EQ(sha::encode256Batch(backend, messages, digests), true);
+        EXPECT_EQ(digests == expected, true);
+
+        // fewer messages than lanes
+        std::vector<sha::Digest256> few(3u);
+        EXPECT_EQ(sha::encode256Batch(backend, std::span(messages).subspan(60u, 3u), few), true);
+        EXPECT_EQ(std::equal(few.begin(), few.end(), expected.begin() + 60), true);
+
+        EXPECT_EQ(sha::encode256Batch(backend, messages, std::span(digests).first(10u)), false);
+    }
+}
+
+TEST(sha_Tests, encode512)
+{
+    auto doTest = [](const auto &testCase, const auto &msg, const auto &expected512, const auto &expected384) {
+        // SCOPED_TRACE(testCase);
+
+        EXPECT_EQ(sha::encode512(ByteBuffer(msg, true)).asHexString(), expected512);
+        EXPECT_EQ(sha::encode384(ByteBuffer(msg, true)).asHexString(), expected384);
+    };
+
+    doTest("// case 1",
+           "",
+           "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd474"
+           "17a81a538327af927da3e",
+           "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b");
+    doTest("// case 2",
+           "616263",
+           "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643"
+           "ce80e2a9ac94fa54ca49f",
+           "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7");
+
+    // padding fits into the last block or requires one more block
+    auto doLengthTest = [](const auto &testCase, size_t len, const auto &expected512, const auto &expected384) {
+        // SCOPED_TRACE(testCase);
+
+        std::vector<uint8_t> msg(len);
+        for (size_t i = 0; i < len; ++i) {
+            msg[i] = uint8_t(i);
+        }
+        uint8_t digest[64] = {};
+        sha::encode512(msg.data(), len, digest);
+        EXPECT_EQ(ByteBuffer(static_cast<const uint8_t *>(digest), 64u).asHexString(), expected512);
+        sha::encode384(msg.data(), len, digest);
+        EXPECT_EQ(ByteBuffer(static_cast<const uint8_t *>(digest), 48u).asHexString(), expected384);
+    };
+
+    doLengthTest("// case 3",
+                 111u,
+                 "a1a111449b198d9b1f538bad7f3fc1022b3a5b1a5e90a0bc860de8512746cbc31599e6c834de3a3235327af0b51ff57bf7acf"
+                 "1974a73014d9c3953812edc7c8d",
+                 "f5f9fe110d809d34029de262a01b208356caec6e054c7f926b2591f6c9780579d4b59f5578c6f531a84f158a33660cef");
+    doLengthTest("// case 4",
+                 112u,
+                 "c5fbd731d19d2ae1180f001be72c2c1aaba1d7b094b3748880e24593b8e117a750e11c1bd867cc2f96dace8c8b74abd2d5c4f"
+                 "236be444e77d30d1916174070b9",
+                 "33ba080ec0ccb378e4e95fed3b26c23aa1a280476e007519ee47f60cd9c5c8a65d627259a9aa2fd33ca06d3c14ee5548");
+    doLengthTest("// case 5",
+                 128u,
+                 "1dffd5e3adb71d45d2245939665521ae001a317a03720a45732ba1900ca3b8351fc5c9b4ca513eba6f80bc7b1d1fdad4abd13"
+                 "491cb824d61b08d8c0e1561b3f7",
+                 "ca2385773319124534111a36d0581fc3f00815e907034b90cff9c3a861e126a741d5dfcff65a417b6d7296863ac0ec17");
+    doLengthTest("// case 6",
+                 240u,
+                 "6c48466c9f6c07e4ab762c696b7eeb35cfe236fca73683e5fab873ac3489b4d2eb3d7afcce7e8165dbbf37aded3b5b0c889c0"
+                 "b7e0f1790a8330d8677429d91a5",
+                 "d64769ad58f5a338669b935f3431e5bef31667d0a2437bff78f1e5275075f434fff675f9833ea04ac4e5c2e2c2c99b8c");
+}
+
+TEST(sha_Tests, compress512)
+{
+    std::vector<sha::Backend512> backends = {sha::Backend512::Portable};
+    if (sha512_avx2::isSupported()) {
+        backends.emplace_back(sha::Backend512::Avx2);
+    }
+
+    // 500 blocks of generated data
+    const std::vector<uint8_t> data = makeData(64000u);
+
+    for (const auto backend : backends) {
+        // SCOPED_TRACE(int(backend));
+
+        uint64_t h[8] = {};
+        sha::hashInit512(h);
+        sha::compress512(backend, h, data.data(), 500u);
+        uint8_t digest[64] = {};
+        sha::finish512(h, nullptr, 0u, data.size(), digest, 64u);
+        EXPECT_EQ(ByteBuffer(static_cast<const uint8_t *>(digest), 64u).asHexString(),
+                  "05302889ac38888d646331f4f38972d2e2cad8a2f5d86302f849f0d425c5291f7671744460f4efa94e918d8fad3fb684a834"
+                  "fcd948e13ae7ae1264ae688f4c95");
+
+        sha::hashInit384(h);
+        sha::compress512(backend, h, data.data(), 500u);
+        sha::finish512(h, nullptr, 0u, data.size(), digest, 48u);
+        EXPECT_EQ(ByteBuffer(static_cast<const uint8_t *>(digest), 48u).asHexString(),
+                  "9b4ed53608a7f1179ea1474980cf05f9f68be090b35fd23b7f6d61fd891983015927bc59bca40b30cbf31ded414165d1");
+    }
+}
+
 TEST(sha_Tests, hmac256)
 {
     auto doTest = [](const auto &testCase, const auto &key, const auto &msg, const auto &expected) {
@@ -140,6 +308,40 @@ TEST(sha_Tests, hmac256)
         "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2");
 }
 
+TEST(sha_Tests, hmac512)
+{
+    auto doTest =
+        [](const auto &testCase, const auto &key, const auto &msg, const auto &expected512, const auto &expected384) {
+            // SCOPED_TRACE(testCase);
+
+            EXPECT_EQ(sha::hmac512(ByteBuffer(key, true), ByteBuffer(msg, true)).asHexString(), expected512);
+            EXPECT_EQ(sha::hmac384(ByteBuffer(key, true), ByteBuffer(msg, true)).asHexString(), expected384);
+        };
+
+    // RFC 4231
+    doTest("// case 1",
+           "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+           "4869205468657265",
+           "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cdedaa833b7d6b8a702038b274eaea3f4e4be9d914eeb6"
+           "1f1702e696c203a126854",
+           "afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59cfaea9ea9076ede7f4af152e8b2fa9cb6");
+    doTest("// case 2",
+           "4a656665",
+           "7768617420646f2079612077616e7420666f72206e6f7468696e673f",
+           "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4"
+           "a6b4b636e070a38bce737",
+           "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649");
+    doTest(
+        "// case 3",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "54657374205573696e67204c6172676572205468616e20426c6f636b2d53697a65204b6579202d2048617368204b6579204669727374",
+        "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f3526b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0a"
+        "ec8b915a985d786598",
+        "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c60c2ef6ab4030fe8296248df163f44952");
+}
+
 TEST(sha_Tests, hkdf256Extract)
 {
     auto doTest = [](const auto &testCase, const auto &kMat, const auto &seed, const auto &expected) {
@@ -231,6 +433,38 @@ TEST(sha_Tests, hkdf256)
            "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8");
 }
 
+TEST(sha_Tests, hkdf512)
+{
+    const ByteBuffer key("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b", true);
+    const ByteBuffer seed("000102030405060708090a0b0c", true);
+    const ByteBuffer info("f0f1f2f3f4f5f6f7f8f9", true);
+
+    {
+        // SCOPED_TRACE("// case 1. HKDF-SHA512");
+
+        EXPECT_EQ(sha::hkdf512(key, seed, info, 42).asHexString(),
+                  "832390086cda71fb47625bb5ceb168e4c8e26a1a16ed34d9fc7fe92c1481579338da362cb8d9f925d7cb");
+        EXPECT_EQ(sha::hkdf512(key, seed, info, 130).asHexString(),
+                  "832390086cda71fb47625bb5ceb168e4c8e26a1a16ed34d9fc7fe92c1481579338da362cb8d9f925d7cbcce0dff7098769cf"
+                  "15959867d571c1715450cb530137be3fb62f3cf32b84feba8f1eb1b563e20d9749b8640b8264c4b69b14ad5199115e1d609c"
+                  "83c6940ce5b4214a0c79946983547a35cdcc17e0daf31b647dec0d0e6142");
+        EXPECT_EQ(sha::hkdf512Expand(sha::hmac512(seed, key), info, 255u * 64u).size(), size_t(255u * 64u));
+        EXPECT_EQ(sha::hkdf512Expand(sha::hmac512(seed, key), info, 255u * 64u + 1u).size(), 0u);
+    }
+
+    {
+        // SCOPED_TRACE("// case 2. HKDF-SHA384");
+
+        EXPECT_EQ(sha::hkdf384(key, seed, info, 42).asHexString(),
+                  "9b5097a86038b805309076a44b3a9f38063e25b516dcbf369f394cfab43685f748b6457763e4f0204fc5");
+        EXPECT_EQ(sha::hkdf384(key, seed, info, 100).asHexString(),
+                  "9b5097a86038b805309076a44b3a9f38063e25b516dcbf369f394cfab43685f748b6457763e4f0204fc5d95d1da3e62587b2"
+                  "2eb8943d0fab6bb631a2fe9df1a68c6ce5d56116a52005b3f122b88b39b7251fcd6c44d3ef25f20ed96802bf1b2c1d98bf"
+                  "74");
+        EXPECT_EQ(sha::hkdf384Expand(sha::hmac384(seed, key), info, 255u * 48u + 1u).size(), 0u);
+    }
+}
+
 TEST(sha_Tests, performance)
 {
     TestHelper::timeFn(
@@ -274,4 +508,40 @@ TEST(sha_Tests, performance)
             sha::encode256(data);
         },
         100000);
+
+    TestHelper::timeFn(
+        "encode256 large (1 MB)",
+        []() {
+            static const ByteBuffer data(1024u * 1024u);
+            sha::encode256(data);
+        },
+        100);
+
+    TestHelper::timeFn(
+        "encode512 large (1 MB)",
+        []() {
+            static const ByteBuffer data(1024u * 1024u);
+            uint8_t digest[64] = {};
+            sha::encode512(data.data(), data.size(), digest);
+        },
+        100);
+
+    std::vector<uint8_t> records(64u * 1024u);
+    std::vector<std::span<const uint8_t>> messages;
+    for (size_t i = 0; i < 1024u; ++i) {
+        messages.emplace_back(std::span(records).subspan(i * 64u, 64u));
+    }
+    std::vector<sha::Digest256> digests(messages.size());
+
+    TestHelper::timeFn(
+        "encode256 1024 x 64 bytes one by one",
+        [&]() {
+            for (size_t i = 0; i < messages.size(); ++i) {
+                sha::encode256(messages[i].data(), messages[i].size(), digests[i].data());
+            }
+        },
+        100);
+
+    TestHelper::timeFn(
+        "encode256Batch 1024 x 64 bytes", [&]() { sha::encode256Batch(messages, digests); }, 100);
 }